@@ -0,0 +1,178 @@
+// Acquisition throughput of the six-IMU sweep against the simulated bus, so it
+// can be measured (and regressions caught) on any Linux box without the suit.
+//
+// Every transaction blocks for its modelled wire time (default 100 kHz SCL plus
+// 60 us per transaction), and the sensors serve a recording when one is given:
+//   ./acquisition_bench [recording.json|-] [scl_hz] [seconds]
+//   ./acquisition_bench MAY_10_FULL_SUIT_WORKING/control/joint_data.json 100000 5
+//
+// Sweeps compared:
+//   legacy     bno055.c driver, per-byte register reads, 10 ms after each switch
+//   euler      Bno055Device burst Euler read (6 bytes), cached unit and page
+//   roll plan  Bno055Device read plan with roll only (2 bytes)
+// followed by the roll plan sweep running in ImuAcquisition at 100 Hz.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bno055_device.h"
+#include "frame_types.h"
+#include "imu_acquisition.h"
+#include "imu_replay.h"
+#include "rpi_tca9548a.h"
+#include "sim_i2c_bus.h"
+
+using namespace std::chrono;
+
+static const u8 MUX_ADDR = 0x70;
+static const u8 IMU_ADDR = BNO055_I2C_ADDR2;
+
+static SimulatedI2CBus* sim_bus = nullptr;
+
+// Same access pattern as the wiringPiI2CReadReg8 callbacks: one transaction per byte
+static s8 bytewise_read(u8 dev_addr, u8 reg_addr, u8* reg_data, u8 cnt) {
+    for (int i = 0; i < cnt; i++) {
+        if (sim_bus->read(dev_addr, static_cast<u8>(reg_addr + i), reg_data + i, 1) != BNO055_SUCCESS) {
+            return BNO055_ERROR;
+        }
+    }
+    return BNO055_SUCCESS;
+}
+
+static s8 burst_write(u8 dev_addr, u8 reg_addr, u8* reg_data, u8 cnt) {
+    return sim_bus->write(dev_addr, reg_addr, reg_data, cnt);
+}
+
+static void sleep_msec(u32 msec) {
+    std::this_thread::sleep_for(milliseconds(msec));
+}
+
+template <typename SweepFn>
+static void time_sweeps(const std::string& name, int sweeps, SweepFn sweep) {
+    std::vector<double> samples;
+    samples.reserve(sweeps);
+    sim_bus->reset_stats();
+
+    for (int i = 0; i < sweeps; i++) {
+        auto start = steady_clock::now();
+        sweep();
+        samples.push_back(duration<double, std::milli>(steady_clock::now() - start).count());
+    }
+
+    SimulatedI2CBus::Stats stats = sim_bus->stats();
+    std::sort(samples.begin(), samples.end());
+    double total = 0.0;
+    for (double s : samples) total += s;
+    double mean = total / samples.size();
+
+    std::cout << "  " << name << ": mean " << mean << " ms, p99 "
+              << samples[(samples.size() * 99) / 100] << " ms, max " << 1000.0 / mean
+              << " sweeps/s, " << static_cast<double>(stats.transactions) / sweeps
+              << " transactions and " << static_cast<double>(stats.bytes) / sweeps
+              << " bytes per sweep, " << stats.nacks << " errors" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::string recording = argc > 1 ? argv[1] : "-";
+    uint32_t scl_hz       = argc > 2 ? static_cast<uint32_t>(std::atoi(argv[2])) : 100000;
+    int seconds           = argc > 3 ? std::atoi(argv[3]) : 3;
+
+    ImuReplay replay;
+    if (recording == "-") {
+        replay = make_synthetic_replay(IMU_LOCATIONS.size(), 1000, 10000000);
+    } else {
+#ifdef EXO_HAVE_IMU_REPLAY_JSON
+        if (load_imu_replay(recording, IMU_LOCATIONS, replay) != 0) return -1;
+#else
+        std::cerr << "Built without nlohmann_json, only the synthetic replay (-) is available" << std::endl;
+        return -1;
+#endif
+    }
+
+    SimulatedI2CBus bus(SimBusTiming::at_clock(scl_hz), true);
+    sim_bus = &bus;
+    bus.set_replay(replay);
+    for (size_t i = 0; i < IMU_LOCATIONS.size(); i++) bus.add_bno055(static_cast<int>(i), IMU_ADDR, i);
+
+    rpi_tca9548a tca;
+    tca.init(MUX_ADDR, bus);
+
+    std::vector<Bno055Device> sensors;
+    for (size_t i = 0; i < IMU_LOCATIONS.size(); i++) {
+        sensors.emplace_back(bus, IMU_ADDR, &tca, static_cast<int>(i));
+        Bno055Device& imu = sensors.back();
+        // Straight to NDOF, the simulated fusion output needs no start-up time
+        u8 mode = BNO055_OPERATION_MODE_NDOF;
+        if (imu.init() != BNO055_SUCCESS ||
+            imu.write_register(BNO055_PAGE_ZERO, BNO055_OPR_MODE_ADDR, &mode, 1) != BNO055_SUCCESS) {
+            std::cerr << "Failed to initialize simulated " << IMU_LOCATIONS[i] << std::endl;
+            return -1;
+        }
+    }
+
+    std::cout << "6 sensor sweep, " << scl_hz / 1000 << " kHz simulated bus, "
+              << replay.frames() << " replay frames" << std::endl;
+
+    // Legacy driver: global p_bno055, re-initialised sensors share one context
+    bno055_t legacy;
+    legacy.bus_read   = bytewise_read;
+    legacy.bus_write  = burst_write;
+    legacy.delay_msec = sleep_msec;
+    legacy.dev_addr   = IMU_ADDR;
+    tca.set_channel(0);
+    bno055_init(&legacy);
+
+    time_sweeps("legacy   ", 20, [&]() {
+        for (size_t i = 0; i < sensors.size(); i++) {
+            bno055_euler_double_t euler;
+            tca.set_channel(static_cast<uint8_t>(i));
+            std::this_thread::sleep_for(milliseconds(10));
+            bno055_convert_double_euler_hpr_deg(&euler);
+        }
+    });
+
+    time_sweeps("euler    ", 200, [&]() {
+        for (Bno055Device& imu : sensors) {
+            bno055_euler_t euler;
+            imu.read_euler_raw(&euler);
+        }
+    });
+
+    const Bno055ReadPlan roll_plan = bno055_plan_read(BNO055_Q_EULER_ROLL);
+    auto roll_sweep = [&](ImuFrame& frame) {
+        frame.valid_mask = 0;
+        for (size_t i = 0; i < sensors.size(); i++) {
+            Bno055Sample sample;
+            if (sensors[i].read(roll_plan, &sample) != BNO055_SUCCESS) continue;
+            frame.roll[i] = sample.euler[1];
+            frame.valid_mask |= static_cast<uint8_t>(1u << i);
+        }
+    };
+    time_sweeps("roll plan", 200, [&]() {
+        ImuFrame frame;
+        roll_sweep(frame);
+    });
+
+    // Acquisition engine at 100 Hz with a consumer draining the ring
+    ImuAcquisition acquisition(roll_sweep, milliseconds(10));
+    acquisition.start();
+    uint64_t consumed = 0;
+    auto end = steady_clock::now() + std::chrono::seconds(seconds);
+    while (steady_clock::now() < end) {
+        ImuFrame frame;
+        while (acquisition.pop(frame)) consumed++;
+        std::this_thread::sleep_for(milliseconds(5));
+    }
+    acquisition.stop();
+
+    std::cout << "  ImuAcquisition @ 100 Hz for " << seconds << " s: "
+              << acquisition.frames_published() << " frames ("
+              << acquisition.frames_published() / static_cast<double>(seconds) << "/s), "
+              << consumed << " consumed, " << acquisition.overruns() << " overruns, "
+              << acquisition.dropped_frames() << " dropped" << std::endl;
+    return 0;
+}
@@ -0,0 +1,95 @@
+// Size and CPU cost of the compressed IMU log (exolog_codec.h) on a recorded
+// session, replayed as the controller would log it:
+//   ./exolog_codec_bench [recording] [passes]
+//   ./exolog_codec_bench MAY_10_FULL_SUIT_WORKING/control/joint_data.json 200
+//
+// Each frame of the recording becomes an ImuLogRecord: its timestamp, a
+// per-channel sample time 1.4 ms apart with up to 50 us of jitter, and the
+// roll quantized to BNO055 LSBs. Blocks of 10 records are what the logger
+// writes at 10 Hz with its one-second flush; larger blocks are what it writes
+// at higher rates.
+
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include "exolog_codec.h"
+#include "frame_types.h"
+#include "imu_log_record.h"
+#include "imu_replay.h"
+#include "sensor_dataset.h"
+
+using namespace std::chrono;
+
+
+int main(int argc, char* argv[]) {
+    std::string path = argc > 1 ? argv[1] : "MAY_10_FULL_SUIT_WORKING/control/joint_data.json";
+    int passes       = argc > 2 ? std::atoi(argv[2]) : 200;
+
+    SensorDataset dataset;
+    if (dataset.load(path, IMU_LOCATIONS) != 0 || dataset.channels() != IMU_CHANNELS) {
+        std::cerr << "Cannot load " << path << std::endl;
+        return 1;
+    }
+    const size_t frames = dataset.frames();
+    std::vector<ImuLogRecord> records(frames);
+    std::mt19937 rng(1);
+    for (size_t t = 0; t < frames; t++) {
+        ImuFrame frame{};
+        frame.sequence = t;
+        frame.timestamp_ns = dataset.timestamp_ns()[t] - dataset.timestamp_ns()[0];
+        for (size_t c = 0; c < IMU_CHANNELS; c++) {
+            frame.sample_ns[c] = frame.timestamp_ns + static_cast<int64_t>(c) * 1400000 + rng() % 50000;
+            frame.roll[c] = euler_deg_to_raw(dataset.column(0, c)[t]);
+        }
+        frame.valid_mask = dataset.valid_mask()[t];
+        frame.fresh_mask = frame.valid_mask;
+        records[t] = imu_log_record(frame);
+    }
+
+    struct stat st;
+    double json_bytes = stat(path.c_str(), &st) == 0 ? static_cast<double>(st.st_size) / frames : 0.0;
+    std::cout << path << ": " << frames << " frames, " << json_bytes << " bytes/frame as JSON, "
+              << sizeof(ImuLogRecord) << " as raw records" << std::endl;
+
+    ExologSchema schema = imu_log_schema(IMU_LOCATIONS, 10000000);
+    schema.compression = EXOLOG_DELTA_VARINT;
+    ExologBlockEncoder encoder(schema);
+    ExologBlockDecoder decoder(schema);
+
+    for (size_t block_records : {10, 100, 1000}) {
+        std::vector<uint8_t> encoded;
+        auto start = steady_clock::now();
+        for (int p = 0; p < passes; p++) {
+            encoded.clear();
+            for (size_t t = 0; t < frames; t += block_records) {
+                encoder.encode(&records[t], std::min(block_records, frames - t), encoded);
+            }
+        }
+        double encode_ns = duration<double, std::nano>(steady_clock::now() - start).count() / passes / frames;
+
+        std::vector<uint8_t> decoded;
+        start = steady_clock::now();
+        for (int p = 0; p < passes; p++) {
+            decoded.clear();
+            for (size_t offset = 0; offset < encoded.size();) {
+                offset += static_cast<size_t>(decoder.decode(&encoded[offset], encoded.size() - offset, decoded));
+            }
+        }
+        double decode_ns = duration<double, std::nano>(steady_clock::now() - start).count() / passes / frames;
+        bool exact = decoded.size() == frames * sizeof(ImuLogRecord) &&
+                     std::memcmp(decoded.data(), records.data(), decoded.size()) == 0;
+
+        double bytes = static_cast<double>(encoded.size()) / frames;
+        std::cout << "  blocks of " << block_records << ": " << bytes << " bytes/frame, "
+                  << sizeof(ImuLogRecord) / bytes << "x vs raw, " << json_bytes / bytes << "x vs JSON; encode "
+                  << encode_ns << " ns/frame, decode " << decode_ns << " ns/frame"
+                  << (exact ? "" : "  ROUND TRIP MISMATCH") << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,97 @@
+// Per-sample cost of the biquad filter bank (filter_bank.h) on a recorded
+// session, against a scalar loop per channel:
+//   ./filter_bank_bench [recording] [passes]
+//   ./filter_bank_bench MAY_10_FULL_SUIT_WORKING/control/joint_data.json 200
+//
+// The recording's roll is unwrapped and normalized first, as the filter sees
+// it in the controller. "per tick" feeds one frame per call, the way the
+// control loop does; "per block" feeds the whole recording in one call.
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "filter_bank.h"
+#include "frame_types.h"
+#include "sensor_dataset.h"
+#include "sensor_preprocessing.h"
+#include "simd_lanes.h"
+
+using namespace std::chrono;
+
+
+// The same cascade, one channel at a time
+static void scalar_filter(const std::vector<BiquadCoefficients>& sections, std::vector<float>& state,
+                          const float* in, float* out, size_t frames, size_t channels) {
+    for (size_t c = 0; c < channels; c++) {
+        for (size_t t = 0; t < frames; t++) {
+            float x = in[t * channels + c];
+            for (size_t s = 0; s < sections.size(); s++) {
+                const BiquadCoefficients& k = sections[s];
+                float& z1 = state[(s * channels + c) * 2];
+                float& z2 = state[(s * channels + c) * 2 + 1];
+                float y = k.b0 * x + z1;
+                z1 = k.b1 * x - k.a1 * y + z2;
+                z2 = k.b2 * x - k.a2 * y;
+                x = y;
+            }
+            out[t * channels + c] = x;
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string path = argc > 1 ? argv[1] : "MAY_10_FULL_SUIT_WORKING/control/joint_data.json";
+    int passes       = argc > 2 ? std::atoi(argv[2]) : 200;
+
+    SensorDataset dataset;
+    if (dataset.load(path, IMU_LOCATIONS) != 0 || dataset.channels() != 6) {
+        std::cerr << "Cannot load " << path << std::endl;
+        return 1;
+    }
+    const size_t frames = dataset.frames(), channels = 6;
+    std::vector<float> signal(frames * channels), out(signal.size());
+    for (size_t t = 0; t < frames; t++) {
+        for (size_t c = 0; c < channels; c++) signal[t * channels + c] = dataset.column(0, c)[t];
+    }
+    StreamingPreprocessor(channels).push(signal.data(), signal.data(), frames);
+    std::cout << path << ": " << frames << " frames, " << simd::ISA << " lanes" << std::endl;
+
+    for (size_t stages : {1, 2, 4}) {
+        FilterBank::Config config;
+        config.sample_rate_hz = 100.0;
+        for (size_t s = 0; s < stages; s++) {
+            config.stages.push_back({s % 2 ? FilterBank::Type::NOTCH : FilterBank::Type::LOWPASS, 10.0 + s, 0.0});
+        }
+        FilterBank bank;
+        if (bank.configure(channels, config) != 0) return 1;
+        std::vector<BiquadCoefficients> sections;
+        for (size_t s = 0; s < stages; s++) sections.push_back(bank.coefficients(s));
+        std::vector<float> state(stages * channels * 2, 0.0f);
+
+        auto start = steady_clock::now();
+        for (int p = 0; p < passes; p++)
+            for (size_t t = 0; t < frames; t++) bank.process(&signal[t * channels], &out[t * channels]);
+        double tick_ns = duration<double, std::nano>(steady_clock::now() - start).count() / passes / frames;
+
+        start = steady_clock::now();
+        for (int p = 0; p < passes; p++) bank.process(signal.data(), out.data(), frames);
+        double block_ns = duration<double, std::nano>(steady_clock::now() - start).count() / passes / frames;
+
+        start = steady_clock::now();
+        for (int p = 0; p < passes; p++)
+            for (size_t t = 0; t < frames; t++)
+                scalar_filter(sections, state, &signal[t * channels], &out[t * channels], 1, channels);
+        double scalar_tick_ns = duration<double, std::nano>(steady_clock::now() - start).count() / passes / frames;
+
+        start = steady_clock::now();
+        for (int p = 0; p < passes; p++) scalar_filter(sections, state, signal.data(), out.data(), frames, channels);
+        double scalar_block_ns = duration<double, std::nano>(steady_clock::now() - start).count() / passes / frames;
+
+        std::cout << "  " << stages << " section(s): per tick " << tick_ns << " ns/frame ("
+                  << tick_ns / channels << " ns/sample), per block " << block_ns << " ns/frame; scalar per tick "
+                  << scalar_tick_ns << ", per block " << scalar_block_ns << " ns/frame" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,90 @@
+// Per-sensor Euler read time: per-byte SMBus reads vs one combined I2C_RDWR burst.
+//
+// Run on the Pi with a BNO055 behind the TCA9548A:
+//   ./i2c_read_bench [device] [mux channel] [iterations]
+//   ./i2c_read_bench /dev/i2c-1 0 2000
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "i2c_dev_bus.h"
+
+using namespace std::chrono;
+
+static const u8 MUX_ADDR = 0x70;
+static const u8 IMU_ADDR = BNO055_I2C_ADDR2;
+
+struct Stats {
+    double mean_us;
+    double p50_us;
+    double p99_us;
+    int errors;
+};
+
+template <typename ReadFn>
+static Stats time_reads(int iterations, ReadFn read_fn) {
+    std::vector<double> samples;
+    samples.reserve(iterations);
+    int errors = 0;
+
+    for (int i = 0; i < iterations; i++) {
+        auto start = steady_clock::now();
+        if (read_fn() != BNO055_SUCCESS) errors++;
+        auto end = steady_clock::now();
+        samples.push_back(duration<double, std::micro>(end - start).count());
+    }
+
+    std::sort(samples.begin(), samples.end());
+    double total = 0.0;
+    for (double s : samples) total += s;
+
+    Stats stats;
+    stats.mean_us = total / samples.size();
+    stats.p50_us  = samples[samples.size() / 2];
+    stats.p99_us  = samples[(samples.size() * 99) / 100];
+    stats.errors  = errors;
+    return stats;
+}
+
+static void print_stats(const std::string& name, const Stats& s) {
+    std::cout << name << ": mean " << s.mean_us << " us, p50 " << s.p50_us
+              << " us, p99 " << s.p99_us << " us, errors " << s.errors
+              << ", 6 sensor sweep ~" << (s.mean_us * 6.0) / 1000.0 << " ms" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::string device = argc > 1 ? argv[1] : "/dev/i2c-1";
+    int channel        = argc > 2 ? std::atoi(argv[2]) : 0;
+    int iterations     = argc > 3 ? std::atoi(argv[3]) : 2000;
+
+    I2CDevBus bus(device);
+    if (bus.open() != 0) {
+        std::cerr << "Failed to open " << device << std::endl;
+        return -1;
+    }
+    if (bus.send_byte(MUX_ADDR, static_cast<u8>(1 << channel)) != BNO055_SUCCESS) {
+        std::cerr << "Failed to select multiplexer channel " << channel << std::endl;
+        return -1;
+    }
+
+    u8 euler[BNO055_EULER_HRP_DATA_SIZE];
+
+    Stats bytewise = time_reads(iterations, [&]() {
+        return bus.read_bytewise(IMU_ADDR, BNO055_EULER_H_LSB_ADDR, euler, BNO055_EULER_HRP_DATA_SIZE);
+    });
+    Stats burst = time_reads(iterations, [&]() {
+        return bus.read(IMU_ADDR, BNO055_EULER_H_LSB_ADDR, euler, BNO055_EULER_HRP_DATA_SIZE);
+    });
+
+    std::cout << "Euler read (" << BNO055_EULER_HRP_DATA_SIZE << " bytes), "
+              << iterations << " iterations on " << device << " channel " << channel << std::endl;
+    print_stats("  per-byte SMBus ", bytewise);
+    print_stats("  I2C_RDWR burst ", burst);
+    std::cout << "  speedup: " << bytewise.mean_us / burst.mean_us << "x" << std::endl;
+
+    bus.send_byte(MUX_ADDR, 0);
+    return 0;
+}
@@ -0,0 +1,89 @@
+// JSONL ingestion throughput: one nlohmann DOM per line (what getSensorData,
+// IMUDataLoader and normalized.cpp do) against the streaming scanner, on a
+// recording such as the MAY_10 joint_data.json (~5 minutes at 10 Hz):
+//   ./jsonl_scan_bench [recording] [passes]
+//   ./jsonl_scan_bench MAY_10_FULL_SUIT_WORKING/control/joint_data.json 20
+//
+// Every variant extracts the timestamp and the roll of all six sensors.
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include <nlohmann/json.hpp>
+#include "frame_types.h"
+#include "imu_jsonl_scan.h"
+#include "imu_replay.h"
+
+using namespace std::chrono;
+using json = nlohmann::json;
+
+
+// The per-line DOM path, columns filled the same way as the scanner's
+static size_t dom_ingest(const std::string& path, std::vector<int64_t>& t, std::vector<std::vector<float>>& roll) {
+    std::ifstream file(path);
+    std::string line;
+    size_t frames = 0;
+    while (std::getline(file, line)) {
+        if (line.empty()) continue;
+        json entry = json::parse(line);
+        int64_t ns = 0;
+        parse_log_timestamp(entry["timestamp"], &ns);
+        t.push_back(ns);
+        for (auto& column : roll) column.push_back(0.0f);
+        for (const auto& sensor : entry["sensors"]) {
+            for (size_t c = 0; c < IMU_LOCATIONS.size(); c++) {
+                if (sensor["location"] == IMU_LOCATIONS[c]) roll[c].back() = sensor["euler"]["roll"];
+            }
+        }
+        frames++;
+    }
+    return frames;
+}
+
+template <typename Fn>
+static void report(const std::string& name, double mb, int passes, Fn pass) {
+    size_t frames = 0;
+    auto start = steady_clock::now();
+    for (int i = 0; i < passes; i++) frames = pass();
+    double s = duration<double>(steady_clock::now() - start).count() / passes;
+    std::cout << "  " << name << ": " << s * 1000.0 << " ms per pass, " << mb / s << " MB/s, "
+              << frames / s / 1e6 << " M frames/s" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::string path = argc > 1 ? argv[1] : "MAY_10_FULL_SUIT_WORKING/control/joint_data.json";
+    int passes       = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+        std::cerr << "Cannot read " << path << std::endl;
+        return 1;
+    }
+    double mb = st.st_size / 1e6;
+    std::cout << path << ": " << mb << " MB, " << passes << " passes" << std::endl;
+
+    report("nlohmann DOM per line", mb, passes, [&] {
+        std::vector<int64_t> t;
+        std::vector<std::vector<float>> roll(IMU_LOCATIONS.size());
+        return dom_ingest(path, t, roll);
+    });
+
+    ImuJsonlScanner roll_scanner(IMU_LOCATIONS, IMU_JSON_TIMESTAMP | IMU_JSON_ROLL);
+    report("scanner, timestamp + roll", mb, passes, [&] {
+        ImuJsonlColumns columns;
+        roll_scanner.scan_file(path, columns);
+        return columns.frames();
+    });
+
+    ImuJsonlScanner all_scanner(IMU_LOCATIONS, IMU_JSON_ALL);
+    report("scanner, timestamp + euler", mb, passes, [&] {
+        ImuJsonlColumns columns;
+        all_scanner.scan_file(path, columns);
+        return columns.frames();
+    });
+    return 0;
+}
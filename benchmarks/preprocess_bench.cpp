@@ -0,0 +1,136 @@
+// Cost of the preprocessing kernels (sensor_preprocessing.h) on a recorded
+// session against the per-channel scalar loops they replace:
+//   ./preprocess_bench [recording] [passes]
+//   ./preprocess_bench MAY_10_FULL_SUIT_WORKING/control/joint_data.json 200
+//
+// "100-frame" is what the control loop used to do every tick, the whole
+// preprocessing over its last 100 frames; "full log" is one pass over the
+// recording, as the offline tools do. Standardization is the model's 30 x 6
+// input.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "frame_types.h"
+#include "sensor_dataset.h"
+#include "sensor_preprocessing.h"
+#include "simd_lanes.h"
+
+using namespace std::chrono;
+
+
+// process_sensor_data() before the kernels: transpose, scalar loops per channel, transpose back
+static void scalar_process(std::vector<std::vector<float>>& data, int section_size = 100, float diff_max = 200.0f) {
+    std::vector<std::vector<float>> channels(6, std::vector<float>(data.size()));
+    for (size_t t = 0; t < data.size(); ++t)
+        for (size_t j = 0; j < 6; ++j) channels[j][t] = data[t][j];
+
+    for (std::vector<float>& signal : channels) {
+        std::vector<float> unwrapped;
+        unwrapped.reserve(signal.size());
+        unwrapped.push_back(signal[0]);
+        float total = 0.0f;
+        total += signal[0];
+        for (size_t i = 1; i < signal.size(); ++i) {
+            int start = std::max(static_cast<int>(i) - section_size, 0);
+            float diff = signal[i] - total / (i - start);
+            unwrapped.push_back(diff > diff_max    ? signal[i] - 360.0f
+                                : diff < -diff_max ? signal[i] + 360.0f
+                                                   : signal[i]);
+            if (static_cast<int>(i) >= section_size) total -= unwrapped[i - section_size];
+            total += unwrapped[i];
+        }
+
+        std::deque<float> window;
+        total = 0.0f;
+        std::vector<float> normalized;
+        normalized.reserve(signal.size());
+        for (size_t i = 0; i < unwrapped.size(); ++i) {
+            if (window.size() >= static_cast<size_t>(section_size)) {
+                total -= window.front();
+                window.pop_front();
+            }
+            window.push_back(unwrapped[i]);
+            total += unwrapped[i];
+            normalized.push_back(unwrapped[i] - total / static_cast<float>(window.size()));
+        }
+        signal = std::move(normalized);
+    }
+
+    for (size_t t = 0; t < data.size(); ++t)
+        for (size_t j = 0; j < 6; ++j) data[t][j] = channels[j][t];
+}
+
+template <typename F>
+static double ns_per_call(int calls, F&& f) {
+    auto start = steady_clock::now();
+    for (int i = 0; i < calls; i++) f(i);
+    return duration<double, std::nano>(steady_clock::now() - start).count() / calls;
+}
+
+int main(int argc, char* argv[]) {
+    std::string path = argc > 1 ? argv[1] : "MAY_10_FULL_SUIT_WORKING/control/joint_data.json";
+    int passes       = argc > 2 ? std::atoi(argv[2]) : 200;
+
+    SensorDataset dataset;
+    if (dataset.load(path, IMU_LOCATIONS) != 0 || dataset.channels() != 6 || dataset.frames() < 100) {
+        std::cerr << "Cannot load " << path << std::endl;
+        return 1;
+    }
+    const size_t frames = dataset.frames();
+    std::vector<std::vector<float>> rows(frames, std::vector<float>(6));
+    std::vector<float> flat(frames * 6);
+    for (size_t t = 0; t < frames; t++) {
+        for (size_t c = 0; c < 6; c++) rows[t][c] = flat[t * 6 + c] = dataset.column(0, c)[t];
+    }
+    std::cout << path << ": " << frames << " frames, " << simd::ISA << " lanes" << std::endl;
+
+    // 100-frame buffer, a different one each call
+    const int ticks = passes * 100;
+    std::vector<std::vector<float>> buffer;
+    auto tick_buffer = [&](int i) {
+        size_t end = 100 + static_cast<size_t>(i) % (frames - 100);
+        buffer.assign(rows.begin() + end - 100, rows.begin() + end);
+    };
+    double copy_ns = ns_per_call(ticks, tick_buffer);
+    double scalar_ns = ns_per_call(ticks, [&](int i) { tick_buffer(i); scalar_process(buffer); }) - copy_ns;
+    double kernel_ns = ns_per_call(ticks, [&](int i) { tick_buffer(i); process_sensor_data(buffer); }) - copy_ns;
+    StreamingPreprocessor streaming(6);
+    float row[6];
+    double push_ns = ns_per_call(ticks, [&](int i) { streaming.push(&flat[(i % frames) * 6], row); });
+    std::cout << "  100-frame: scalar " << scalar_ns << " ns, process_sensor_data " << kernel_ns
+              << " ns, one StreamingPreprocessor::push " << push_ns << " ns" << std::endl;
+
+    // Whole recording
+    std::vector<float> out(flat.size());
+    double full_scalar = ns_per_call(passes, [&](int) { buffer = rows; scalar_process(buffer); });
+    double full_kernel = ns_per_call(passes, [&](int) { buffer = rows; process_sensor_data(buffer); });
+    double full_push = ns_per_call(passes, [&](int) {
+        StreamingPreprocessor preprocessor(6);
+        preprocessor.push(flat.data(), out.data(), frames);
+    });
+    std::cout << "  full log: scalar " << full_scalar / frames << " ns/frame, process_sensor_data "
+              << full_kernel / frames << " ns/frame, StreamingPreprocessor " << full_push / frames << " ns/frame"
+              << std::endl;
+
+    // 30 x 6 standardization
+    const float mean[6] = {-0.26f, -0.56f, -0.62f, -0.11f, 2.18f, 0.006f};
+    const float scale[6] = {12.6f, 19.3f, 6.7f, 7.1f, 15.9f, 5.1f};
+    std::vector<float> input(180);
+    double std_scalar = ns_per_call(ticks, [&](int i) {
+        const float* window = &flat[(i % (frames - 30)) * 6];
+        for (size_t t = 0; t < 30; t++)
+            for (size_t j = 0; j < 6; j++) input[t * 6 + j] = (window[t * 6 + j] - mean[j]) / scale[j];
+    });
+    double std_kernel = ns_per_call(ticks, [&](int i) {
+        standardize_frames(&flat[(i % (frames - 30)) * 6], input.data(), 30, 6, mean, scale);
+    });
+    std::cout << "  standardize 30 x 6: scalar " << std_scalar << " ns, standardize_frames " << std_kernel << " ns"
+              << std::endl;
+    return 0;
+}
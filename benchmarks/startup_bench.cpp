@@ -0,0 +1,97 @@
+// Time to the first trustworthy frame after power-on, cold (the sensors have
+// to be calibrated by moving the suit around) against warm (calibration
+// profiles restored from the store), on the simulated bus.
+//
+// A frame counts once every sensor reads and reports CALIB_STAT 0xFF. The
+// sensors are power-cycled between the two runs, so the warm run only has
+// what the store saved at the end of the cold one:
+//   ./startup_bench [calibration seconds] [scl_hz] [profile dir]
+//   ./startup_bench 15 100000 /tmp/exo_calibration
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "bno055_calibration.h"
+#include "imu_replay.h"
+#include "sensor_rig.h"
+#include "sensor_topology.h"
+#include "sim_i2c_bus.h"
+
+using namespace std::chrono;
+
+static const int POLL_MS = 10;
+
+struct StartupTime {
+    double init_ms;         // SensorRig::init(), mode switches included
+    double first_frame_ms;  // power-on to the first fully calibrated frame
+    size_t restored;
+};
+
+static StartupTime time_startup(const SensorTopology& topology, const CalibrationStore& store,
+                                int64_t calibration_ns, uint32_t scl_hz, bool warm, bool save) {
+    // A fresh bus is a power cycle: every sensor comes up in CONFIG without offsets
+    SimulatedI2CBus bus(SimBusTiming::at_clock(scl_hz), true);
+    bus.set_replay(make_synthetic_replay(topology.size(), 1000, 10000000));
+    bus.set_calibration_time_ns(calibration_ns);
+    for (size_t i = 0; i < topology.size(); i++) bus.add_bno055(topology[i].channel, topology[i].dev_addr, i);
+
+    SensorRig rig(topology, [&bus](const std::string&) -> I2CBus* { return &bus; });
+    if (warm) rig.set_calibration_store(&store);
+
+    StartupTime result;
+    auto start = steady_clock::now();
+    rig.init();
+    result.init_ms = duration<double, std::milli>(steady_clock::now() - start).count();
+    result.restored = rig.restored_profiles();
+
+    // Sweep at the controller's pace until every sensor is usable
+    while (true) {
+        ImuFrame frame{};
+        rig.sweep(frame);
+        bool ready = frame.valid_mask == (1u << topology.size()) - 1;
+        for (size_t i = 0; ready && i < topology.size(); i++) {
+            u8 status = 0;
+            ready = rig.read_calibration_status(i, &status) == BNO055_SUCCESS &&
+                    status == BNO055_CALIB_STAT_FULL;
+        }
+        if (ready) break;
+        std::this_thread::sleep_for(milliseconds(POLL_MS));
+    }
+    result.first_frame_ms = duration<double, std::milli>(steady_clock::now() - start).count();
+
+    if (save) {
+        rig.set_calibration_store(&store);
+        std::cout << "  saved " << rig.save_calibration() << " profiles to the store" << std::endl;
+    }
+    return result;
+}
+
+static void report(const std::string& name, const StartupTime& t) {
+    std::cout << "  " << name << ": init " << t.init_ms << " ms, first valid frame "
+              << t.first_frame_ms << " ms, " << t.restored << " profiles restored" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    double calibration_s = argc > 1 ? std::atof(argv[1]) : 5.0;
+    uint32_t scl_hz      = argc > 2 ? static_cast<uint32_t>(std::atoi(argv[2])) : 100000;
+    std::string dir      = argc > 3 ? argv[3] : "/tmp/exo_calibration";
+
+    CalibrationStore store(dir);
+
+    SensorTopology topology = default_topology();
+    for (auto& p : topology) p.bus = "sim";
+    int64_t calibration_ns = static_cast<int64_t>(calibration_s * 1e9);
+
+    std::cout << topology.size() << " sensors, " << scl_hz / 1000 << " kHz simulated bus, "
+              << calibration_s << " s of calibration motion needed from cold" << std::endl;
+
+    StartupTime cold = time_startup(topology, store, calibration_ns, scl_hz, false, true);
+    report("cold", cold);
+    StartupTime warm = time_startup(topology, store, calibration_ns, scl_hz, true, false);
+    report("warm", warm);
+
+    std::cout << "  warm start is " << cold.first_frame_ms - warm.first_frame_ms << " ms faster" << std::endl;
+    return 0;
+}
@@ -1,24 +1,22 @@
 #include "clean.h"
 
-#include <vector>
-
 // Constants for knee and hip offsets
 constexpr double KNEE_OFFSET = 0;  // Example value
 constexpr double HIP_OFFSET = 0;   // Example value
 
 // Function to clean the offset in AI data readings
-std::vector<float> cleanAIOffsets(const std::vector<float>& imuReadings) {
-  std::vector<float> cleanedReadings(6);
+JointAngles cleanAIOffsets(const JointAngles& imuReadings) {
+  JointAngles cleanedReadings;  // ankles stay zero
 
-      cleanedReadings[0] = imuReadings[0] - KNEE_OFFSET; // lk
-      cleanedReadings[4] = imuReadings[4] - KNEE_OFFSET; // rk
+      cleanedReadings[Joint::LEFT_KNEE] = imuReadings[Joint::LEFT_KNEE] - KNEE_OFFSET;
+      cleanedReadings[Joint::RIGHT_KNEE] = imuReadings[Joint::RIGHT_KNEE] - KNEE_OFFSET;
 
-      cleanedReadings[3] = imuReadings[3] - HIP_OFFSET; // rh
-      cleanedReadings[5] = imuReadings[5] - HIP_OFFSET; // lh
+      cleanedReadings[Joint::RIGHT_HIP] = imuReadings[Joint::RIGHT_HIP] - HIP_OFFSET;
+      cleanedReadings[Joint::LEFT_HIP] = imuReadings[Joint::LEFT_HIP] - HIP_OFFSET;
 
   // Fixing Knee angles to be relative to the hip
-  cleanedReadings[0] = cleanedReadings[0] - cleanedReadings[5]; // left leg
-  cleanedReadings[4] = cleanedReadings[4] - cleanedReadings[3]; // right leg
+  cleanedReadings[Joint::LEFT_KNEE] = cleanedReadings[Joint::LEFT_KNEE] - cleanedReadings[Joint::LEFT_HIP]; // left leg
+  cleanedReadings[Joint::RIGHT_KNEE] = cleanedReadings[Joint::RIGHT_KNEE] - cleanedReadings[Joint::RIGHT_HIP]; // right leg
 
   return cleanedReadings;
 }
\ No newline at end of file
@@ -1,9 +1,9 @@
 #ifndef CLEAN_H
 #define CLEAN_H
 
-#include <vector>
+#include "../../sensors/frame_types.h"
 
 // Function to clean the offset in AI data readings
-std::vector<float> cleanAIOffsets(const std::vector<float>& imuReadings);
+JointAngles cleanAIOffsets(const JointAngles& imuReadings);
 
 #endif  // CLEAN_H
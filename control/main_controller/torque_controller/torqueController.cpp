@@ -15,7 +15,6 @@
  #include <cmath>
  #include <cstdint>
  #include <iostream>
- #include <vector>
  
  // Torque Controller Values
  const double m1 = 2.3;   // Mass of thigh
@@ -28,15 +27,15 @@
  const double I2 = 0.01;  // Moment of inertia of shank about COM
  const double g = 9.81;   // Gravity constant
  
- std::vector<int16_t> TorqueController::computeTorque(JointState hipRight,
-                                                      JointState hipLeft,
-                                                      JointState kneeRight,
-                                                      JointState kneeLeft) {
-   std::vector<int16_t> torque_values(4);
+ TorqueCommand TorqueController::computeTorque(JointState hipRight,
+                                               JointState hipLeft,
+                                               JointState kneeRight,
+                                               JointState kneeLeft) {
+   TorqueCommand torque_values;
  
    // Helper lambda to compute torque for a single leg
    auto computeLegTorque = [&](const JointState& hip,
-                               const JointState& knee) -> std::vector<int16_t> {
+                               const JointState& knee) -> std::array<int16_t, 2> {
      std::array<std::array<double, 2>, 2> M, C;
      std::array<double, 2> G;
  
@@ -97,15 +96,15 @@
    auto rightTorques = computeLegTorque(hipRight, kneeRight);
  
    // Assign computed torques to the output array
-   torque_values[0] = rightTorques[0];  // Right hip
-   torque_values[1] = rightTorques[1];  // Right knee
-   torque_values[2] = leftTorques[0];   // Left hip
-   torque_values[3] = leftTorques[1];   // Left knee
+   torque_values[MotorChannel::RIGHT_HIP] = rightTorques[0];
+   torque_values[MotorChannel::RIGHT_KNEE] = rightTorques[1];
+   torque_values[MotorChannel::LEFT_HIP] = leftTorques[0];
+   torque_values[MotorChannel::LEFT_KNEE] = leftTorques[1];
  
    // Debug output for final torque values
-   std::cout << "  Final Scaled Torque Values: [" << torque_values[0] << ", "
-             << torque_values[1] << ", " << torque_values[2] << ", "
-             << torque_values[3] << "]" << std::endl << std::endl;
+   std::cout << "  Final Scaled Torque Values: [" << torque_values.values[0] << ", "
+             << torque_values.values[1] << ", " << torque_values.values[2] << ", "
+             << torque_values.values[3] << "]" << std::endl << std::endl;
  
    return torque_values;
  }
@@ -2,7 +2,8 @@
 
 #include <array>
 #include <cstdint>
-#include <vector>
+
+#include "../../sensors/frame_types.h"
 
 class TorqueController {
  public:
@@ -17,10 +18,10 @@ class TorqueController {
     double acceleration;
   };
 
-  std::vector<int16_t> computeTorque(struct JointState hipRight,
-                                     struct JointState hipLeft,
-                                     struct JointState kneeRight,
-                                     struct JointState kneeLeft);
+  TorqueCommand computeTorque(struct JointState hipRight,
+                              struct JointState hipLeft,
+                              struct JointState kneeRight,
+                              struct JointState kneeLeft);
 
  private:
   void computeMassMatrix(double q1, double q2,
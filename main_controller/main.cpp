@@ -6,26 +6,42 @@
 #include <iostream>
 #include <thread>
 #include <vector>
+#include <fstream>
 #include <cmath>
 #include <atomic>
 #include "../sensors/bno055.h"
 #include "../sensors/rpi_tca9548a.h"
+#include "../sensors/bno055_device.h"
+#include "../sensors/i2c_dev_bus.h"
 
 #include "../models/model.h"           // header file for model
 #include "../motors/motor_api.h"       // header file for motor API
-#include "../sensors/getSensorData.h"  // header file for normzalied sensor data
 #include "clean_angles/clean.h"        // header file for clean angles
 #include "joint_estimator/jointEstimator.h"
 #include "torque_controller/torqueController.h"
 #include "../sensors/sensor_preprocessing.h"
 #include "../sensors/data_collection.h" 
 #include "../sensors/liveSensorData.h"   // header file for sensor preprocessing
+#include "../sensors/imu_acquisition.h"  // IMU sweep thread + frame ring
+#include "../sensors/frame_aligner.h"    // mux skew correction
+#include "../sensors/sensor_rig.h"       // per-bus parallel sweeps
+#include "../sensors/i2c_stats.h"        // I2C latency histograms
+#include "../sensors/async_logger.h"     // background binary log writer
+#include "../sensors/imu_log_record.h"   // .exolog IMU log records
+#include "../sensors/exolog_codec.h"     // delta/varint compressed .exolog blocks
+#include "../sensors/ring_window.h"      // contiguous history of the last frames
+#include "../sensors/frame_types.h"      // fixed-size frames with named channels
+#include "../sensors/filter_bank.h"      // per-channel biquad low-pass/notch cascades
 
 // test settings
 const bool SIMULATION = false;  // true when running without motors
 const int MOTOR_NUMBER = 0;   // number of motors 0-4
 const int SLEEP_TIME = 100;   // sleep time in ms
-std::vector<std::vector<float>> full_sensor_buffer;
+const int ACQUISITION_CPU = 3;  // core the IMU sweep thread is pinned to
+const bool COMPRESS_IMU_LOG = true;  // delta/varint blocks, about half the raw record size
+const int ANKLE_RATE_DIVISOR = 3;  // ankles matter least to the controller, read every 3rd sweep
+const double MODEL_INPUT_LOWPASS_HZ = 0.0;  // 0: off, the model was trained on unfiltered roll
+const double ESTIMATOR_LOWPASS_HZ = 0.0;    // 0: off until validated on the suit; smooths velocity and acceleration only
 
 int16_t clampTorque(int16_t torque, int16_t min, int16_t max) {
   return std::max(min, std::min(max, torque));
@@ -53,9 +69,10 @@ volatile sig_atomic_t shutdown_requested = 0;
 //   }
 //   std::exit(signum);
 // }
+// Async-signal-safe: only sets the flag, the main loop shuts down in order
+// (rig.close_muxes() deselects every mux at the end)
 void signalHandler(int signum) {
   shutdown_requested = 1;
-  tca.no_channel();
 }
 
 
@@ -70,12 +87,18 @@ void log_message(const std::string& message) {
   std::cout << get_current_timestamp() << " - " << message << std::endl;
 }
 
+// log_message("torque for motor i: t") without building strings, it runs every tick
+void log_torque(size_t motor, int16_t torque) {
+  auto now = std::time(nullptr);
+  char buf[32];
+  strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", localtime(&now));
+  std::cout << buf << " - torque for motor " << motor << ": " << torque << std::endl;
+}
+
 int main() {
   std::vector<Motor> motors;  // vector of motors
-  double dt = 0.1;            // Sampling rate for model
-  int chunk_index = 0;
-  std::vector<int16_t> previous_torque_values(4, 0);
-  int addr = 0x29;
+  double dt = 0.1;            // Nominal model period, replaced by the measured frame spacing
+  TorqueCommand previous_torque_values;  // zero
   // std::vector<bno055_t> sensors;// Vector to store sensor objects
 
   // Load the model
@@ -105,6 +128,7 @@ int main() {
     // register Ctrl+C handler
     std::signal(SIGINT, signalHandler);
     std::signal(SIGTERM, signalHandler);
+    i2c_stats_install_signal();  // kill -USR1 <pid> prints the I2C latency histograms
 
     for (auto& m : motors) {
       if (!m.initializeMotor()) {
@@ -118,43 +142,80 @@ int main() {
 
   // initialize variables
   constexpr size_t WINDOW = 30;
-  std::vector<std::vector<float>> sensor_history(6, std::vector<float>(WINDOW));
   TorqueController::JointState hipLeft, kneeLeft, hipRight,
       kneeRight;  // initializing joints
-  std::vector<float> predicted_angles(6), clean_angles(6);
-  std::vector<int16_t> torque_values(4);
-  const std::string sensor_file =
-      "../filtered_imu_data_treadmill_5min_1.9mph.json";
-
-  // initialize sensors
-  std::vector<bno055_t> sensors(6);
-  rpi_tca9548a tca;
-  tca.init(0x70);
-  tca.no_channel();
-
-  for (size_t i = 0; i < sensorChannels.size(); i++) {
-    tca.set_channel(sensorChannelsBackup[i]);
-    std::this_thread::sleep_for(std::chrono::milliseconds(10));
-    //bno055_t imu;
-
-    if (initialize_imu(&sensors[i], addr) != BNO055_SUCCESS) {
-        std::cerr << "Failed to initialize sensor at address 0x" << std::hex << addr << std::endl;
-        continue;  // Skip this sensor and continue with others
-    }
-    if (setup_imu(&sensors[i]) != BNO055_SUCCESS) {
-        std::cerr << "Failed to set operation mode for sensor at address 0x" << std::hex << addr << std::endl;
-        continue;
-    }
-    //sensors.push_back(imu);
+  JointAngles predicted_angles, clean_angles, smoothed_angles;
+  TorqueCommand torque_values;
+  const std::string topology_file = "../sensor_topology.conf";
+  const std::string calibration_dir = "../calibration";
+  char imu_log_file[64];
+  std::time_t started = std::time(nullptr);
+  strftime(imu_log_file, sizeof(imu_log_file), "imu_data_%Y%m%d_%H%M%S.exolog", localtime(&started));
+
+  // Sensor wiring and rates come from the topology file when there is one,
+  // else the suit's single bus with the ankles on a slower rate. Each bus is
+  // swept on its own thread; sensors that fail to come up are retried in the
+  // background by their bus' health monitor.
+  SensorTopology topology;
+  if (!std::ifstream(topology_file).good() || load_topology(topology_file, topology) != 0) {
+    topology = default_topology();
+    topology[2].divisor = ANKLE_RATE_DIVISOR;  // Left Ankle
+    topology[3].divisor = ANKLE_RATE_DIVISOR;  // Right Ankle
   }
+  SensorRig rig(topology);
+
+  // Sensors calibrated in an earlier run skip the calibration motions
+  CalibrationStore calibration(calibration_dir);
+  rig.set_calibration_store(&calibration);
+  std::cout << "IMUs ready: " << rig.init() << "/" << rig.sensor_count()
+            << " on " << rig.bus_count() << " bus(es), " << rig.restored_profiles()
+            << " calibration profile(s) restored" << std::endl;
   //initialize_sensors_test(sensors, tca, 0x29);
-  std::vector<double> euler_roll;
+
+  // Every sweep is logged in binary; the sweep thread only copies the record
+  // into the logger's ring, the logger's thread compresses and writes
+  ExologSchema imu_log_format = imu_log_schema(sensorLocations, SLEEP_TIME * 1000000LL);
+  AsyncLogger::Config imu_log_config;
+  if (COMPRESS_IMU_LOG) {
+    imu_log_format.compression = EXOLOG_DELTA_VARINT;
+    auto encoder = std::make_shared<ExologBlockEncoder>(imu_log_format);
+    imu_log_config.encoder = [encoder](const uint8_t* records, size_t count, std::vector<uint8_t>& out) {
+      encoder->encode(records, count, out);
+    };
+  }
+  AsyncLogger imu_log(sizeof(ImuLogRecord), imu_log_config);
+  std::string imu_log_header = exolog_header(imu_log_format);
+  if (imu_log.open(imu_log_file, imu_log_header.data(), imu_log_header.size()) != 0) {
+    std::cerr << "IMU data will not be logged" << std::endl;
+  }
+
+  // IMU sweep runs on its own thread at a fixed rate, the loop below only drains frames
+  ImuAcquisition acquisition(
+      [&](ImuFrame& frame) { liveSensorData(rig, imu_log, frame); },
+      std::chrono::milliseconds(SLEEP_TIME), ACQUISITION_CPU);
+  acquisition.start();
 
   // Control system configuration/initializing
   JointEstimator hipRight_estimator;
   JointEstimator kneeRight_estimator;
   JointEstimator hipLeft_estimator;
   JointEstimator kneeLeft_estimator;
+  FrameAligner aligner;
+  StreamingPreprocessor preprocessor(IMU_CHANNELS);  // process_sensor_data() over every frame so far
+  // Filter stages at the frame rate; a bad config is reported and passes samples through
+  FilterBank model_filter, estimator_filter;
+  FilterBank::Config filter_config;
+  filter_config.sample_rate_hz = 1000.0 / SLEEP_TIME;
+  if (MODEL_INPUT_LOWPASS_HZ > 0) filter_config.stages = {{FilterBank::Type::LOWPASS, MODEL_INPUT_LOWPASS_HZ, 0.0}};
+  model_filter.configure(IMU_CHANNELS, filter_config);
+  filter_config.stages.clear();
+  // Runs once per model evaluation, so it assumes one sample per loop: after an
+  // overrun the loop pops several frames but the estimators still see one step
+  if (ESTIMATOR_LOWPASS_HZ > 0) filter_config.stages = {{FilterBank::Type::LOWPASS, ESTIMATOR_LOWPASS_HZ, 0.0}};
+  estimator_filter.configure(JointAngles::size(), filter_config);
+  RingWindow<float, IMU_CHANNELS, WINDOW> processed_history;  // last 30 preprocessed frames, no allocation
+  int64_t newest_frame_ns = 0;
+  int64_t last_update_ns = -1;  // frame time of the previous estimator update
 
 
   // Main loop
@@ -162,17 +223,27 @@ int main() {
     std::cout << "Running main loop: shutdown requested: " << shutdown_requested << std::endl;
     if (shutdown_requested) break;
     auto loop_start = std::chrono::steady_clock::now();
+    i2c_stats_poll(std::cout);
     
-    euler_roll = liveSensorData(sensors, tca);
-    std::vector<float> euler_roll_float(euler_roll.begin(), euler_roll.end());
-    full_sensor_buffer.push_back(euler_roll_float);
-
-    if (full_sensor_buffer.size() > 100) {
-        full_sensor_buffer.erase(full_sensor_buffer.begin(), full_sensor_buffer.end() - 100);
+    ImuFrame frame;
+    AlignedFrame aligned;
+    bool new_frame = false;
+    while (acquisition.pop(frame)) {
+      // channels are read tens of ms apart, interpolate all six to the sweep start
+      aligner.align(frame, aligned);
+      // unwrapped and normalized as it arrives, O(1) per frame
+      RollFrame row;
+      preprocessor.push(aligned.roll, row.data());
+      // after the unwrap, a +/-180 wrap would ring through the filter
+      if (preprocessor.frames() == 1) model_filter.prime(row.data());
+      model_filter.process(row.data(), row.data());
+      processed_history.push(row.data());
+      newest_frame_ns = aligned.time_ns;
+      new_frame = true;
     }
 
-    if (full_sensor_buffer.size() < 30) {
-        std::cout << "Waiting for 30 samples...\n";
+    if (!new_frame || !processed_history.full()) {
+        if (new_frame) std::cout << "Waiting for 30 samples...\n";
         auto loop_end = std::chrono::steady_clock::now();
         auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(loop_end - loop_start);
         int remaining_time = SLEEP_TIME - static_cast<int>(elapsed.count());
@@ -181,31 +252,11 @@ int main() {
         }
         continue;
     }
-    //auto raw = get_sensor_data(sensor_file, chunk_index, WINDOW);
-    // if (raw.size() < WINDOW) {
-    //   std::cerr << "Only " << raw.size() << " samples available; need "
-    //             << WINDOW << "\n";
-    //   std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    //   continue;
-    // }
-
-    chunk_index += 1;
-
-    // take the last WINDOW entries and transpose into [6][30]
-    // for (size_t j = 0; j < 6; ++j) {
-    //   for (size_t t = 0; t < WINDOW; ++t) {
-    //     sensor_history[j][t] = raw[t][j];
-    //   }
-    // }
-
     // lk la ra rh rk lh
 
     // running AI model
-    std::vector<std::vector<float>> processed = full_sensor_buffer;
-    process_sensor_data(processed);
-
-    std::vector<std::vector<float>> input_to_model(processed.end() - 30, processed.end());
-    predicted_angles = predict_joint_angles(model, input_to_model);
+    // [30][6] straight out of the ring, nothing copied
+    predicted_angles = predict_joint_angles(model, processed_history.last(WINDOW).data());
 
     // Print predicted angles
     // std::cout << "Predicted Angles:" << std::endl;
@@ -219,23 +270,36 @@ int main() {
     std::transform(clean_angles.begin(), clean_angles.end(), clean_angles.begin(),
                [](float angle) { return angle * M_PI / 180.0f; });
 
+    // smoothed copy for the estimators to differentiate, starting from the first
+    // angles rather than 0; torque still gets the unfiltered angle, without the lag
+    if (last_update_ns < 0) estimator_filter.prime(clean_angles.data());
+    estimator_filter.process(clean_angles.data(), smoothed_angles.data());
+
+    // dt is the real time between the frames the estimators saw, not the loop period
+    if (last_update_ns >= 0) dt = (newest_frame_ns - last_update_ns) * 1e-9;
+    last_update_ns = newest_frame_ns;
+
     // Assign angles to the corresponding joints and log the updates
-    hipRight = hipRight_estimator.update(clean_angles[3], dt);
+    hipRight = hipRight_estimator.update(smoothed_angles[Joint::RIGHT_HIP], dt);
+    hipRight.angle = clean_angles[Joint::RIGHT_HIP];
     std::cout << "Updated HipRight: angle = " << hipRight.angle 
               << ", velocity = " << hipRight.velocity 
               << ", acceleration = " << hipRight.acceleration << std::endl;
 
-    kneeRight = kneeRight_estimator.update(clean_angles[4], dt);
+    kneeRight = kneeRight_estimator.update(smoothed_angles[Joint::RIGHT_KNEE], dt);
+    kneeRight.angle = clean_angles[Joint::RIGHT_KNEE];
     std::cout << "Updated KneeRight: angle = " << kneeRight.angle 
               << ", velocity = " << kneeRight.velocity 
               << ", acceleration = " << kneeRight.acceleration << std::endl;
 
-    hipLeft = hipLeft_estimator.update(clean_angles[5], dt);
+    hipLeft = hipLeft_estimator.update(smoothed_angles[Joint::LEFT_HIP], dt);
+    hipLeft.angle = clean_angles[Joint::LEFT_HIP];
     std::cout << "Updated HipLeft: angle = " << hipLeft.angle 
               << ", velocity = " << hipLeft.velocity 
               << ", acceleration = " << hipLeft.acceleration << std::endl;
 
-    kneeLeft = kneeLeft_estimator.update(clean_angles[0], dt);
+    kneeLeft = kneeLeft_estimator.update(smoothed_angles[Joint::LEFT_KNEE], dt);
+    kneeLeft.angle = clean_angles[Joint::LEFT_KNEE];
     std::cout << "Updated KneeLeft: angle = " << kneeLeft.angle 
               << ", velocity = " << kneeLeft.velocity 
               << ", acceleration = " << kneeLeft.acceleration << std::endl;
@@ -246,17 +310,17 @@ int main() {
         torqueController.computeTorque(hipRight, hipLeft, kneeRight, kneeLeft);
       
     for (size_t i = 0; i < torque_values.size(); ++i) {
-      torque_values[i] = clampTorque(torque_values[i], -500, 500);  // Clamp to [-500, 500]
-      torque_values[i] = limitTorqueChange(torque_values[i], previous_torque_values[i], 50);  // Limit change to 50
+      int16_t& torque = torque_values.values[i];
+      torque = clampTorque(torque, -500, 500);  // Clamp to [-500, 500]
+      torque = limitTorqueChange(torque, previous_torque_values.values[i], 50);  // Limit change to 50
     }
     previous_torque_values = torque_values;
     if (!SIMULATION) {
       if (shutdown_requested) break;
       for (size_t i = 0; i < motors.size(); ++i) {
-        motors[i].setTargetTorque(torque_values[i]);
+        motors[i].setTargetTorque(torque_values.values[i]);
         if (shutdown_requested) break;
-        log_message("torque for motor " + std::to_string(i) + ": " +
-                    std::to_string(torque_values[i]));
+        log_torque(i, torque_values.values[i]);
       }
     }
 
@@ -267,10 +331,28 @@ int main() {
         std::this_thread::sleep_for(std::chrono::milliseconds(remaining_time));
     }
   }
+
+  // Motors off first: the IMU shutdown below takes seconds and the drives
+  // would keep applying the last torque meanwhile
   std::cout << "Disabling motors...\n";
-    for (auto& m : motors) {
-        m.disconnectMotor();
-    }
+  for (auto& m : motors) {
+    m.disconnectMotor();
+  }
+
+  acquisition.stop();
+  imu_log.close();
+  std::cout << "IMU log: " << imu_log.written() << " records in " << imu_log_file << " ("
+            << imu_log.bytes_written() << " bytes), dropped: " << imu_log.dropped() << ", write errors: " << imu_log.write_errors()
+            << std::endl;
+  std::cout << "IMU frames: " << acquisition.frames_published()
+            << ", overruns: " << acquisition.overruns()
+            << ", dropped: " << acquisition.dropped_frames() << std::endl;
+  std::cout << "IMU re-init attempts: " << rig.reinit_attempts()
+            << ", recoveries: " << rig.recoveries() << std::endl;
+  i2c_stats_dump(std::cout);
+  // Motors are off by now; sensors restored at start-up are skipped
+  std::cout << "Saved " << rig.save_calibration() << " IMU calibration profile(s)" << std::endl;
+  rig.close_muxes();
 
     std::cout << "Shutdown complete.\n";
     return 0;
@@ -1,7 +1,11 @@
 #include <torch/torch.h>
 #include <torch/script.h>
+#include <algorithm>
 #include <vector>
 #include <iostream>
+#include "../sensors/sensor_dataset.h"
+#include "../sensors/sensor_preprocessing.h"
+#include "../sensors/frame_types.h"
 
 std::vector<float> mean = {
     -0.2551588541666669,
@@ -21,45 +25,81 @@ std::vector<float> scale = {
     5.110401095770009
 };
 
+// Forward pass on a normalized [1][30][6] input, denormalized output
+static JointAngles run_model(torch::jit::script::Module& model, const at::Tensor& input_tensor) {
+    std::vector<torch::jit::IValue> inputs;
+    inputs.push_back(input_tensor);
+
+    at::Tensor output = model.forward(inputs).toTensor();
+
+    JointAngles denormalized_output;
+    for (size_t i = 0; i < denormalized_output.size(); ++i) {
+        float val = output[0][i].item<float>();
+        denormalized_output.values[i] = val * scale[i] + mean[i];
+    }
+    return denormalized_output;
+}
+
 /**
  * Predicts the next set of joint angles using the last 30 timesteps.
  * 
  * @param model A reference to the TorchScript model.
- * @param last_30_timesteps A vector of 30 timesteps, each timestep being a 6-float vector.
+ * @param last_30_timesteps 30 timesteps of 6 floats each, contiguous.
  *                          Shape: [30][6] = total 180 values in row-major format.
- * @return A std::vector<float> containing 6 predicted joint angles.
+ * @return The 6 predicted joint angles.
+ */
+JointAngles predict_joint_angles(torch::jit::script::Module& model, const float* last_30_timesteps) {
+    // Standardized straight into the tensor's [30][6] storage
+    at::Tensor input_tensor = torch::empty({1, 30, 6});
+    standardize_frames(last_30_timesteps, input_tensor.data_ptr<float>(), 30, 6, mean.data(), scale.data());
+
+    JointAngles denormalized_output = run_model(model, input_tensor);
+    std::cout << "Predicted joint angles: ";
+    for (const auto& angle : denormalized_output) {
+        std::cout << angle << " ";
+    }
+    std::cout << std::endl;
+
+    return denormalized_output;
+}
+
+/**
+ * Same prediction from 30 separately stored timesteps.
+ *
+ * @param last_30_timesteps A vector of 30 timesteps, each timestep being a 6-float vector.
  */
-std::vector<float> predict_joint_angles(torch::jit::script::Module& model, const std::vector<std::vector<float>>& last_30_timesteps) {
+JointAngles predict_joint_angles(torch::jit::script::Module& model, const std::vector<std::vector<float>>& last_30_timesteps) {
     if (last_30_timesteps.size() != 30) {
         throw std::invalid_argument("Expected 30 timesteps");
     }
 
-    at::Tensor input_tensor = torch::zeros({1, 30, 6});
+    float rows[30 * 6];
     for (int t = 0; t < 30; ++t) {
         if (last_30_timesteps[t].size() != 6) {
             throw std::invalid_argument("Each timestep must have 6 joint angles");
         }
-        for (int j = 0; j < 6; ++j) {
-            float normalized = (last_30_timesteps[t][j] - mean[j]) / scale[j];
-            input_tensor[0][t][j] = normalized;
-        }
+        std::copy(last_30_timesteps[t].begin(), last_30_timesteps[t].end(), rows + t * 6);
     }
+    return predict_joint_angles(model, rows);
+}
 
-    std::vector<torch::jit::IValue> inputs;
-    inputs.push_back(input_tensor);
-
-    at::Tensor output = model.forward(inputs).toTensor();
-
-    std::vector<float> denormalized_output(6);
-    for (int i = 0; i < 6; ++i) {
-        float val = output[0][i].item<float>();
-        denormalized_output[i] = val * scale[i] + mean[i];
-    }
-    std::cout << "Predicted joint angles: ";
-    for (const auto& angle : denormalized_output) {
-        std::cout << angle << " ";
+/**
+ * Same prediction for a 30 x 6 window of a SensorDataset, read column by
+ * column straight into the input tensor. Prints nothing, for offline
+ * evaluation over whole recordings.
+ */
+JointAngles predict_joint_angles(torch::jit::script::Module& model, const SensorWindow& window) {
+    if (window.frames() != 30 || window.channels() != 6) {
+        throw std::invalid_argument("Expected a 30 x 6 window");
     }
-    std::cout << std::endl;
 
-    return denormalized_output;
+    at::Tensor input_tensor = torch::empty({1, 30, 6});
+    auto input = input_tensor.accessor<float, 3>();
+    for (int j = 0; j < 6; ++j) {
+        const float* column = window.channel(j);
+        for (int t = 0; t < 30; ++t) {
+            input[0][t][j] = (column[t] - mean[j]) / scale[j];
+        }
+    }
+    return run_model(model, input_tensor);
 }
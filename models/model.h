@@ -3,5 +3,14 @@
 #include <torch/torch.h>
 #include <torch/script.h>
 #include <vector>
+#include "../sensors/frame_types.h"
 
-std::vector<float> predict_joint_angles(torch::jit::script::Module& model, const std::vector<std::vector<float>>& last_30_timesteps);
+class SensorWindow;
+
+JointAngles predict_joint_angles(torch::jit::script::Module& model, const std::vector<std::vector<float>>& last_30_timesteps);
+
+// Same, from 30 contiguous [30][6] rows (a RingWindow view)
+JointAngles predict_joint_angles(torch::jit::script::Module& model, const float* last_30_timesteps);
+
+// 30 x 6 window of a SensorDataset, quietly (offline evaluation)
+JointAngles predict_joint_angles(torch::jit::script::Module& model, const SensorWindow& window);
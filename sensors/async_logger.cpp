@@ -0,0 +1,130 @@
+#include "async_logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+#include "imu_acquisition.h"
+
+// How often the writer looks at the ring
+static const std::chrono::milliseconds WRITER_POLL(20);
+
+AsyncLogger::AsyncLogger(size_t record_size, Config config)
+    : record_size_(record_size), config_(config), ring_(new uint8_t[record_size * config.capacity]),
+      fd_(-1), stopping_(false) {}
+
+AsyncLogger::~AsyncLogger() {
+    close();
+}
+
+int AsyncLogger::open(const std::string& path, const void* header, size_t header_size) {
+    close();
+    fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd_ == -1) {
+        std::cerr << "Failed to open " << path << " for writing: " << std::strerror(errno) << std::endl;
+        return -1;
+    }
+    if (header_size > 0 && !write_all(static_cast<const uint8_t*>(header), header_size)) {
+        ::close(fd_);
+        fd_ = -1;
+        return -1;
+    }
+
+    head_.store(0, std::memory_order_relaxed);
+    tail_.store(0, std::memory_order_relaxed);
+    stopping_ = false;
+    writer_ = std::thread(&AsyncLogger::run, this);
+    return 0;
+}
+
+void AsyncLogger::close() {
+    if (writer_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_one();
+        writer_.join();
+    }
+    if (fd_ != -1) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+bool AsyncLogger::push(const void* record) {
+    pushed_.fetch_add(1, std::memory_order_relaxed);
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (fd_ == -1 || head - tail_.load(std::memory_order_acquire) == config_.capacity) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    std::memcpy(&ring_[(head % config_.capacity) * record_size_], record, record_size_);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+void AsyncLogger::run() {
+    const int64_t max_delay_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(config_.max_delay).count();
+    const size_t batch_records = std::max<size_t>(1, std::min(config_.batch_bytes / record_size_,
+                                                              config_.capacity / 2));
+    int64_t last_write_ns = monotonic_ns();
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        wake_.wait_for(lock, WRITER_POLL);
+        if (stopping_) break;
+
+        size_t pending = head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_relaxed);
+        int64_t now = monotonic_ns();
+        if (pending >= batch_records || (pending > 0 && now - last_write_ns >= max_delay_ns)) {
+            lock.unlock();
+            drain();
+            lock.lock();
+            last_write_ns = now;
+        }
+    }
+    lock.unlock();
+    drain();
+}
+
+void AsyncLogger::drain() {
+    const size_t head = head_.load(std::memory_order_acquire);
+    size_t tail = tail_.load(std::memory_order_relaxed);
+
+    // At most two writes, the run up to the end of the ring and the wrapped rest
+    while (tail != head) {
+        size_t index = tail % config_.capacity;
+        size_t count = std::min(head - tail, config_.capacity - index);
+        const uint8_t* data = &ring_[index * record_size_];
+        size_t size = count * record_size_;
+        if (config_.encoder) {
+            encoded_.clear();
+            config_.encoder(data, count, encoded_);
+            data = encoded_.data();
+            size = encoded_.size();
+        }
+        if (write_all(data, size)) {
+            written_.fetch_add(count, std::memory_order_relaxed);
+            bytes_written_.fetch_add(size, std::memory_order_relaxed);
+        } else {
+            write_errors_.fetch_add(1, std::memory_order_relaxed);
+        }
+        tail += count;
+        tail_.store(tail, std::memory_order_release);  // the space is free again either way
+    }
+}
+
+bool AsyncLogger::write_all(const uint8_t* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::write(fd_, data, size);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
@@ -0,0 +1,105 @@
+#ifndef ASYNC_LOGGER_H
+#define ASYNC_LOGGER_H
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Fixed-size record log written to disk by a background thread.
+ *
+ * The producer (the acquisition or control thread) copies each record into a
+ * preallocated single-producer/single-consumer ring; push() is a memcpy and
+ * two atomic index updates, it never allocates, blocks or touches the file.
+ * The writer thread wakes every few milliseconds and writes what has piled up
+ * straight from the ring with one write() per contiguous run, once there is
+ * at least batch_bytes of it or max_delay has passed since the last write. SD
+ * card stalls therefore only ever hold up the writer.
+ *
+ * When the ring is full a record is dropped and counted rather than waiting
+ * for the disk.
+ *
+ * An optional encoder (e.g. ExologBlockEncoder) turns each run of records
+ * into the bytes written instead, on the writer thread.
+ */
+class AsyncLogger {
+  public:
+    // Appends the encoded form of count records to out
+    using Encoder = std::function<void(const uint8_t* records, size_t count, std::vector<uint8_t>& out)>;
+
+    struct Config {
+        size_t capacity = 4096;            // records the ring holds
+        size_t batch_bytes = 64 * 1024;    // write once this much is pending...
+        std::chrono::milliseconds max_delay{1000};  // ...or the last write is this long ago
+        Encoder encoder;                   // none: records are written as they are
+    };
+
+    explicit AsyncLogger(size_t record_size) : AsyncLogger(record_size, Config()) {}
+    AsyncLogger(size_t record_size, Config config);
+    ~AsyncLogger();
+
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+    /**
+     * Creates (truncates) the file, writes the header and starts the writer.
+     *
+     * @return 0 on success, -1 if the file cannot be created.
+     */
+    int open(const std::string& path, const void* header = nullptr, size_t header_size = 0);
+
+    // Writes everything still in the ring, stops the writer and closes the file
+    void close();
+    bool is_open() const { return fd_ != -1; }
+
+    // Producer side, one thread only. False when the record was dropped.
+    bool push(const void* record);
+
+    template <typename Record>
+    bool push_record(const Record& record) {
+        static_assert(std::is_trivially_copyable<Record>::value, "log records are copied as bytes");
+        return sizeof(Record) == record_size_ && push(&record);
+    }
+
+    size_t record_size() const { return record_size_; }
+    uint64_t pushed() const { return pushed_.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    uint64_t written() const { return written_.load(std::memory_order_relaxed); }  // records on disk
+    uint64_t write_errors() const { return write_errors_.load(std::memory_order_relaxed); }
+    uint64_t bytes_written() const { return bytes_written_.load(std::memory_order_relaxed); }  // after the header
+
+  private:
+    void run();
+    void drain();
+    bool write_all(const uint8_t* data, size_t size);
+
+    size_t record_size_;
+    Config config_;
+    std::unique_ptr<uint8_t[]> ring_;
+    int fd_;
+
+    alignas(64) std::atomic<size_t> head_{0};  // next record the producer fills
+    alignas(64) std::atomic<size_t> tail_{0};  // next record the writer takes
+
+    std::atomic<uint64_t> pushed_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> written_{0};
+    std::atomic<uint64_t> write_errors_{0};
+    std::atomic<uint64_t> bytes_written_{0};
+    std::vector<uint8_t> encoded_;  // writer thread only
+
+    std::thread writer_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stopping_;
+};
+
+#endif // ASYNC_LOGGER_H
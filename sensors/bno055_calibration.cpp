@@ -0,0 +1,84 @@
+#include "bno055_calibration.h"
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <sys/stat.h>
+
+int save_calibration_profile(const std::string& path, const Bno055CalibrationProfile& profile) {
+    // Written next to the old one and renamed, so a crash never leaves half a profile
+    std::string tmp = path + ".tmp";
+    {
+        std::ofstream file(tmp, std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open " << tmp << " for writing" << std::endl;
+            return -1;
+        }
+        file << "# BNO055 calibration profile, registers 0x55-0x6A\n";
+        file << std::hex << std::setfill('0');
+        for (size_t i = 0; i < BNO055_CALIB_PROFILE_LEN; i++) {
+            file << std::setw(2) << static_cast<int>(profile.data[i])
+                 << (i + 1 < BNO055_CALIB_PROFILE_LEN ? ' ' : '\n');
+        }
+        if (!file.good()) return -1;
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+        std::cerr << "Failed to write " << path << std::endl;
+        return -1;
+    }
+    return 0;
+}
+
+int load_calibration_profile(const std::string& path, Bno055CalibrationProfile& profile) {
+    std::ifstream file(path);
+    if (!file.is_open()) return -1;
+
+    std::string line, bytes;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line[0] != '#') bytes += line + " ";
+    }
+
+    std::istringstream fields(bytes);
+    std::string field;
+    size_t n = 0;
+    while (fields >> field) {
+        unsigned long value = 0;
+        try {
+            size_t used = 0;
+            value = std::stoul(field, &used, 16);
+            if (used != field.size()) return -1;
+        } catch (const std::exception&) {
+            return -1;
+        }
+        if (n >= BNO055_CALIB_PROFILE_LEN || value > 0xFF) return -1;
+        profile.data[n++] = static_cast<u8>(value);
+    }
+    if (n != BNO055_CALIB_PROFILE_LEN) {
+        std::cerr << "Bad calibration profile " << path << std::endl;
+        return -1;
+    }
+    return 0;
+}
+
+std::string CalibrationStore::path_for(const SensorPlacement& placement) const {
+    // "/dev/i2c-1" -> "i2c-1"
+    std::string bus = placement.bus;
+    size_t slash = bus.find_last_of('/');
+    if (slash != std::string::npos) bus = bus.substr(slash + 1);
+
+    std::ostringstream name;
+    name << directory_ << "/bno055_" << bus << std::hex;
+    if (placement.mux_addr >= 0) name << "_mux" << placement.mux_addr << "_ch" << placement.channel;
+    name << "_addr" << static_cast<int>(placement.dev_addr) << ".cal";
+    return name.str();
+}
+
+int CalibrationStore::load(const SensorPlacement& placement, Bno055CalibrationProfile& profile) const {
+    return load_calibration_profile(path_for(placement), profile);
+}
+
+int CalibrationStore::save(const SensorPlacement& placement, const Bno055CalibrationProfile& profile) const {
+    mkdir(directory_.c_str(), 0755);  // first save on this machine, EEXIST otherwise
+    return save_calibration_profile(path_for(placement), profile);
+}
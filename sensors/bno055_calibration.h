@@ -0,0 +1,65 @@
+#ifndef BNO055_CALIBRATION_H
+#define BNO055_CALIBRATION_H
+
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include "bno055.h"
+#include "sensor_topology.h"
+
+// Accel/mag/gyro offsets and accel/mag radius, registers 0x55 - 0x6A on page 0
+constexpr u8 BNO055_CALIB_PROFILE_ADDR = BNO055_ACCEL_OFFSET_X_LSB_ADDR;
+constexpr u8 BNO055_CALIB_PROFILE_LEN = BNO055_MAG_RADIUS_MSB_ADDR - BNO055_ACCEL_OFFSET_X_LSB_ADDR + 1;
+
+// CALIB_STAT with system, gyro, accel and mag all at level 3
+constexpr u8 BNO055_CALIB_STAT_FULL = 0xFF;
+
+/**
+ * @brief Register image of a calibrated BNO055.
+ *
+ * The sensor forgets its offsets on every power cycle and has to be moved
+ * through the calibration motions again before the fusion output can be
+ * trusted. Writing a saved profile back in CONFIG mode makes it usable as
+ * soon as the fusion mode is up.
+ */
+struct Bno055CalibrationProfile {
+    u8 data[BNO055_CALIB_PROFILE_LEN];
+};
+
+// Calibration level (0-3) of one subsystem from CALIB_STAT
+inline int bno055_calib_level_sys(u8 status) { return (status >> 6) & 0x03; }
+inline int bno055_calib_level_gyro(u8 status) { return (status >> 4) & 0x03; }
+inline int bno055_calib_level_accel(u8 status) { return (status >> 2) & 0x03; }
+inline int bno055_calib_level_mag(u8 status) { return status & 0x03; }
+
+/**
+ * Writes/reads one profile as a small text file: a comment line and the 22
+ * register bytes in hex.
+ *
+ * @return 0 on success, -1 when the file cannot be written, read or parsed.
+ */
+int save_calibration_profile(const std::string& path, const Bno055CalibrationProfile& profile);
+int load_calibration_profile(const std::string& path, Bno055CalibrationProfile& profile);
+
+/**
+ * @brief Directory of calibration profiles, one file per sensor.
+ *
+ * A profile belongs to the physical sensor, so the file is named after where
+ * the sensor is wired (adapter, mux, channel, address) rather than after the
+ * joint it sits on.
+ */
+class CalibrationStore {
+  public:
+    explicit CalibrationStore(std::string directory) : directory_(std::move(directory)) {}
+
+    std::string path_for(const SensorPlacement& placement) const;
+
+    int load(const SensorPlacement& placement, Bno055CalibrationProfile& profile) const;
+    // Creates the directory when it does not exist yet
+    int save(const SensorPlacement& placement, const Bno055CalibrationProfile& profile) const;
+
+  private:
+    std::string directory_;
+};
+
+#endif // BNO055_CALIBRATION_H
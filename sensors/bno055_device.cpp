@@ -0,0 +1,211 @@
+#include "bno055_device.h"
+#include <chrono>
+#include <thread>
+#include "bno055_calibration.h"
+#include "i2c_bus.h"
+#include "rpi_tca9548a.h"
+
+// Value of the chip id register (page 0, 0x00) on every BNO055
+static const u8 BNO055_CHIP_ID_VALUE = 0xA0;
+
+// Page 0 chip id, accel/mag/gyro rev, sw rev lsb/msb, bootloader rev
+static const u8 BNO055_ID_BLOCK_SIZE = 7;
+
+Bno055Device::Bno055Device(I2CBus& bus, u8 dev_addr, rpi_tca9548a* mux, int channel)
+    : bus_(&bus), mux_(mux), channel_(channel), dev_addr_(dev_addr),
+      chip_id_(0), page_id_(BNO055_PAGE_ZERO), operation_mode_(BNO055_OPERATION_MODE_CONFIG),
+      euler_unit_(-1) {}
+
+void Bno055Device::delay_msec(u32 msec) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(msec));
+}
+
+s8 Bno055Device::select() {
+    if (mux_ == nullptr) return BNO055_SUCCESS;
+    if (channel_ < 0 || mux_->set_channel(static_cast<uint8_t>(channel_)) != 0) return BNO055_ERROR;
+    return BNO055_SUCCESS;
+}
+
+s8 Bno055Device::write_page_id(u8 page) {
+    if (bus_->write(dev_addr_, BNO055_PAGE_ID_ADDR, &page, 1) != BNO055_SUCCESS) return BNO055_ERROR;
+    page_id_ = page;
+    return BNO055_SUCCESS;
+}
+
+s8 Bno055Device::init() {
+    if (select() != BNO055_SUCCESS) return BNO055_ERROR;
+
+    // Write the default page as zero, then read the whole id block in one go
+    if (write_page_id(BNO055_PAGE_ZERO) != BNO055_SUCCESS) return BNO055_ERROR;
+
+    u8 ids[BNO055_ID_BLOCK_SIZE] = {0};
+    if (bus_->read(dev_addr_, BNO055_CHIP_ID_ADDR, ids, BNO055_ID_BLOCK_SIZE) != BNO055_SUCCESS) {
+        return BNO055_ERROR;
+    }
+    chip_id_ = ids[0];
+    euler_unit_ = -1;
+    if (chip_id_ != BNO055_CHIP_ID_VALUE) return BNO055_ERROR;
+
+    u8 mode = 0;
+    if (bus_->read(dev_addr_, BNO055_OPR_MODE_ADDR, &mode, 1) != BNO055_SUCCESS) return BNO055_ERROR;
+    operation_mode_ = mode & BNO055_OPERATION_MODE_MSK;
+    return BNO055_SUCCESS;
+}
+
+s8 Bno055Device::read_register(u8 page, u8 reg_addr, u8* data, u8 len) {
+    if (select() != BNO055_SUCCESS) return BNO055_ERROR;
+    if (page_id_ != page && write_page_id(page) != BNO055_SUCCESS) return BNO055_ERROR;
+    return bus_->read(dev_addr_, reg_addr, data, len);
+}
+
+s8 Bno055Device::write_register(u8 page, u8 reg_addr, const u8* data, u8 len) {
+    if (select() != BNO055_SUCCESS) return BNO055_ERROR;
+    if (page_id_ != page && write_page_id(page) != BNO055_SUCCESS) return BNO055_ERROR;
+    return bus_->write(dev_addr_, reg_addr, data, len);
+}
+
+s8 Bno055Device::get_operation_mode(u8* mode) {
+    u8 data = 0;
+    if (read_register(BNO055_PAGE_ZERO, BNO055_OPR_MODE_ADDR, &data, 1) != BNO055_SUCCESS) {
+        return BNO055_ERROR;
+    }
+    operation_mode_ = data & BNO055_OPERATION_MODE_MSK;
+    *mode = operation_mode_;
+    return BNO055_SUCCESS;
+}
+
+s8 Bno055Device::write_operation_mode(u8 mode) {
+    if (write_register(BNO055_PAGE_ZERO, BNO055_OPR_MODE_ADDR, &mode, 1) != BNO055_SUCCESS) {
+        return BNO055_ERROR;
+    }
+    operation_mode_ = mode;
+    return BNO055_SUCCESS;
+}
+
+s8 Bno055Device::set_operation_mode(u8 mode) {
+    u8 current = BNO055_OPERATION_MODE_CONFIG;
+    if (get_operation_mode(&current) != BNO055_SUCCESS) return BNO055_ERROR;
+
+    // Any mode change has to go through CONFIG mode first
+    if (current != BNO055_OPERATION_MODE_CONFIG) {
+        if (write_operation_mode(BNO055_OPERATION_MODE_CONFIG) != BNO055_SUCCESS) return BNO055_ERROR;
+        delay_msec(BNO055_CONFIG_MODE_SWITCHING_DELAY);
+    }
+
+    if (mode != BNO055_OPERATION_MODE_CONFIG) {
+        if (write_operation_mode(mode) != BNO055_SUCCESS) return BNO055_ERROR;
+        delay_msec(BNO055_MODE_SWITCHING_DELAY);
+    }
+    return BNO055_SUCCESS;
+}
+
+s8 Bno055Device::read_calibration_status(u8* status) {
+    return read_register(BNO055_PAGE_ZERO, BNO055_CALIB_STAT_ADDR, status, 1);
+}
+
+s8 Bno055Device::read_calibration_profile(Bno055CalibrationProfile* profile) {
+    u8 mode = BNO055_OPERATION_MODE_CONFIG;
+    if (get_operation_mode(&mode) != BNO055_SUCCESS) return BNO055_ERROR;
+    if (mode != BNO055_OPERATION_MODE_CONFIG &&
+        set_operation_mode(BNO055_OPERATION_MODE_CONFIG) != BNO055_SUCCESS) {
+        return BNO055_ERROR;
+    }
+
+    s8 result = read_register(BNO055_PAGE_ZERO, BNO055_CALIB_PROFILE_ADDR, profile->data,
+                              BNO055_CALIB_PROFILE_LEN);
+
+    // Back to where it was, even when the read failed
+    if (mode != BNO055_OPERATION_MODE_CONFIG && set_operation_mode(mode) != BNO055_SUCCESS) {
+        return BNO055_ERROR;
+    }
+    return result;
+}
+
+s8 Bno055Device::write_calibration_profile(const Bno055CalibrationProfile& profile) {
+    if (operation_mode_ != BNO055_OPERATION_MODE_CONFIG &&
+        set_operation_mode(BNO055_OPERATION_MODE_CONFIG) != BNO055_SUCCESS) {
+        return BNO055_ERROR;
+    }
+    return write_register(BNO055_PAGE_ZERO, BNO055_CALIB_PROFILE_ADDR, profile.data,
+                          BNO055_CALIB_PROFILE_LEN);
+}
+
+s8 Bno055Device::set_euler_unit(u8 unit) {
+    u8 unit_sel = 0;
+    if (read_register(BNO055_PAGE_ZERO, BNO055_UNIT_SEL_ADDR, &unit_sel, 1) != BNO055_SUCCESS) {
+        return BNO055_ERROR;
+    }
+    u8 wanted = static_cast<u8>((unit_sel & ~BNO055_EULER_UNIT_MSK) |
+                                ((unit << BNO055_EULER_UNIT_POS) & BNO055_EULER_UNIT_MSK));
+    if (wanted == unit_sel) {
+        euler_unit_ = unit;
+        return BNO055_SUCCESS;
+    }
+
+    // UNIT_SEL ignores writes outside CONFIG mode
+    u8 mode = BNO055_OPERATION_MODE_CONFIG;
+    if (get_operation_mode(&mode) != BNO055_SUCCESS) return BNO055_ERROR;
+    if (mode != BNO055_OPERATION_MODE_CONFIG &&
+        set_operation_mode(BNO055_OPERATION_MODE_CONFIG) != BNO055_SUCCESS) {
+        return BNO055_ERROR;
+    }
+
+    s8 result = write_register(BNO055_PAGE_ZERO, BNO055_UNIT_SEL_ADDR, &wanted, 1);
+    if (result == BNO055_SUCCESS) {
+        result = read_register(BNO055_PAGE_ZERO, BNO055_UNIT_SEL_ADDR, &unit_sel, 1);
+    }
+
+    // Back to where it was, even when the write failed
+    if (mode != BNO055_OPERATION_MODE_CONFIG && set_operation_mode(mode) != BNO055_SUCCESS) {
+        return BNO055_ERROR;
+    }
+    if (result != BNO055_SUCCESS || unit_sel != wanted) return BNO055_ERROR;
+    euler_unit_ = unit;
+    return BNO055_SUCCESS;
+}
+
+s8 Bno055Device::ensure_euler_degrees() {
+    if (euler_unit_ == BNO055_EULER_UNIT_DEG) return BNO055_SUCCESS;
+    return set_euler_unit(BNO055_EULER_UNIT_DEG);
+}
+
+s8 Bno055Device::read_euler_raw(bno055_euler_t* euler) {
+    if (ensure_euler_degrees() != BNO055_SUCCESS) return BNO055_ERROR;
+
+    u8 data[BNO055_EULER_HRP_DATA_SIZE] = {0};
+    if (read_register(BNO055_PAGE_ZERO, BNO055_EULER_H_LSB_ADDR, data, BNO055_EULER_HRP_DATA_SIZE) != BNO055_SUCCESS) {
+        return BNO055_ERROR;
+    }
+
+    euler->h = static_cast<s16>((data[1] << 8) | data[0]);
+    euler->r = static_cast<s16>((data[3] << 8) | data[2]);
+    euler->p = static_cast<s16>((data[5] << 8) | data[4]);
+    return BNO055_SUCCESS;
+}
+
+s8 Bno055Device::read(const Bno055ReadPlan& plan, Bno055Sample* sample) {
+    if (plan.length == 0) {
+        sample->quantities = 0;
+        return BNO055_SUCCESS;
+    }
+    if ((plan.quantities & BNO055_Q_EULER) && ensure_euler_degrees() != BNO055_SUCCESS) {
+        return BNO055_ERROR;
+    }
+
+    u8 data[BNO055_CALIB_STAT_ADDR - BNO055_ACCEL_DATA_X_LSB_ADDR + 1];
+    if (read_register(BNO055_PAGE_ZERO, plan.start_reg, data, plan.length) != BNO055_SUCCESS) {
+        return BNO055_ERROR;
+    }
+    bno055_decode_sample(plan, data, sample);
+    return BNO055_SUCCESS;
+}
+
+s8 Bno055Device::read_euler(bno055_euler_double_t* euler) {
+    bno055_euler_t raw;
+    if (read_euler_raw(&raw) != BNO055_SUCCESS) return BNO055_ERROR;
+
+    euler->h = raw.h / BNO055_EULER_DIV_DEG;
+    euler->r = raw.r / BNO055_EULER_DIV_DEG;
+    euler->p = raw.p / BNO055_EULER_DIV_DEG;
+    return BNO055_SUCCESS;
+}
@@ -0,0 +1,100 @@
+#ifndef BNO055_DEVICE_H
+#define BNO055_DEVICE_H
+
+#include "bno055.h"
+#include "bno055_read_plan.h"
+
+class I2CBus;
+class rpi_tca9548a;
+struct Bno055CalibrationProfile;
+
+/**
+ * @brief One BNO055 with its own bus handle, address, mux channel and cached
+ * register state (page id, operation mode).
+ *
+ * Unlike the bno055.c API, which keeps a single static p_bno055 that every
+ * bno055_init() overwrites, each instance carries its own context, so several
+ * sensors can be used side by side and sensors on different buses can be read
+ * from different threads. Devices that share a multiplexer must be driven from
+ * the same thread.
+ */
+class Bno055Device {
+  public:
+    /**
+     * @param bus      Adapter the sensor (or its multiplexer) is attached to.
+     * @param dev_addr I2C address of the sensor (0x28 or 0x29).
+     * @param mux      Multiplexer in front of the sensor, nullptr if directly attached.
+     * @param channel  Multiplexer channel (0-7), ignored without a mux.
+     */
+    Bno055Device(I2CBus& bus, u8 dev_addr = BNO055_I2C_ADDR2,
+                 rpi_tca9548a* mux = nullptr, int channel = -1);
+
+    // Selects page zero and reads the chip/revision ids, like bno055_init()
+    s8 init();
+
+    // Switches operation mode with the same CONFIG transitions and delays as
+    // bno055_set_operation_mode()
+    s8 set_operation_mode(u8 mode);
+    s8 get_operation_mode(u8* mode);
+
+    // Writes OPR_MODE and returns without waiting. The caller has to let
+    // BNO055_CONFIG_MODE_SWITCHING_DELAY (into CONFIG) or
+    // BNO055_MODE_SWITCHING_DELAY (out of CONFIG) pass before using the sensor.
+    s8 write_operation_mode(u8 mode);
+
+    // Register access on the given page, switching page only when needed
+    s8 read_register(u8 page, u8 reg_addr, u8* data, u8 len);
+    s8 write_register(u8 page, u8 reg_addr, const u8* data, u8 len);
+
+    // Euler angles in degrees, same result as bno055_convert_double_euler_hpr_deg()
+    s8 read_euler(bno055_euler_double_t* euler);
+
+    // Hot path: raw Euler angles in 1/16 degree (BNO055_EULER_DIV_DEG) from a
+    // single 6 byte burst. The unit and page are cached, so after the first
+    // call no unit register read or page switch is issued.
+    s8 read_euler_raw(bno055_euler_t* euler);
+
+    // Reads every quantity in the plan with one burst and decodes it raw
+    s8 read(const Bno055ReadPlan& plan, Bno055Sample* sample);
+
+    // CALIB_STAT: system, gyro, accel and mag levels (0-3), two bits each
+    s8 read_calibration_status(u8* status);
+
+    // The offset/radius registers are only accessible in CONFIG mode. Reading
+    // switches a fusing sensor to CONFIG and back (about 620 ms); writing
+    // leaves it in CONFIG for the caller's switch to the fusion mode.
+    s8 read_calibration_profile(Bno055CalibrationProfile* profile);
+    s8 write_calibration_profile(const Bno055CalibrationProfile& profile);
+
+    // UNIT_SEL is only writable in CONFIG mode: a fusing sensor is switched to
+    // CONFIG and back (about 620 ms) when the unit has to change. The unit is
+    // cached once read back, so read_euler_raw() never has to re-check it.
+    s8 set_euler_unit(u8 unit);
+
+    // Routes the multiplexer to this sensor (no-op when already selected)
+    s8 select();
+
+    u8 dev_addr() const { return dev_addr_; }
+    int channel() const { return channel_; }
+    u8 chip_id() const { return chip_id_; }
+    u8 page_id() const { return page_id_; }
+    u8 operation_mode() const { return operation_mode_; }
+    int euler_unit() const { return euler_unit_; }  // -1 until known
+
+  private:
+    s8 write_page_id(u8 page);
+    s8 ensure_euler_degrees();
+    void delay_msec(u32 msec);
+
+    I2CBus* bus_;
+    rpi_tca9548a* mux_;
+    int channel_;
+    u8 dev_addr_;
+
+    u8 chip_id_;
+    u8 page_id_;          // page last written to the page id register
+    u8 operation_mode_;
+    int euler_unit_;      // cached Euler unit bit, -1 if not read yet
+};
+
+#endif // BNO055_DEVICE_H
@@ -0,0 +1,73 @@
+#include "bno055_read_plan.h"
+
+namespace {
+
+struct Field {
+    uint32_t quantity;
+    u8 reg;
+    u8 len;
+};
+
+// Ordered by register address
+const Field FIELDS[] = {
+    {BNO055_Q_ACCEL,         BNO055_ACCEL_DATA_X_LSB_ADDR,        6},
+    {BNO055_Q_MAG,           BNO055_MAG_DATA_X_LSB_ADDR,          6},
+    {BNO055_Q_GYRO,          BNO055_GYRO_DATA_X_LSB_ADDR,         6},
+    {BNO055_Q_EULER_HEADING, BNO055_EULER_H_LSB_ADDR,             2},
+    {BNO055_Q_EULER_ROLL,    BNO055_EULER_R_LSB_ADDR,             2},
+    {BNO055_Q_EULER_PITCH,   BNO055_EULER_P_LSB_ADDR,             2},
+    {BNO055_Q_QUATERNION,    BNO055_QUATERNION_DATA_W_LSB_ADDR,   8},
+    {BNO055_Q_LINEAR_ACCEL,  BNO055_LINEAR_ACCEL_DATA_X_LSB_ADDR, 6},
+    {BNO055_Q_GRAVITY,       BNO055_GRAVITY_DATA_X_LSB_ADDR,      6},
+    {BNO055_Q_TEMP,          BNO055_TEMP_ADDR,                    1},
+    {BNO055_Q_CALIB_STAT,    BNO055_CALIB_STAT_ADDR,              1},
+};
+
+inline s16 le16(const u8* p) {
+    return static_cast<s16>((p[1] << 8) | p[0]);
+}
+
+void decode_vec(const u8* p, s16* dst, int n) {
+    for (int i = 0; i < n; i++) dst[i] = le16(p + 2 * i);
+}
+
+}  // namespace
+
+Bno055ReadPlan bno055_plan_read(uint32_t quantities) {
+    Bno055ReadPlan plan = {quantities & BNO055_Q_ALL, 0, 0};
+    int first = -1;
+    int last = -1;
+
+    for (const Field& f : FIELDS) {
+        if (!(plan.quantities & f.quantity)) continue;
+        if (first < 0) first = f.reg;
+        last = f.reg + f.len - 1;
+    }
+    if (first < 0) return plan;
+
+    plan.start_reg = static_cast<u8>(first);
+    plan.length = static_cast<u8>(last - first + 1);
+    return plan;
+}
+
+void bno055_decode_sample(const Bno055ReadPlan& plan, const u8* data, Bno055Sample* sample) {
+    for (const Field& f : FIELDS) {
+        if (!(plan.quantities & f.quantity)) continue;
+        const u8* p = data + (f.reg - plan.start_reg);
+
+        switch (f.quantity) {
+            case BNO055_Q_ACCEL:         decode_vec(p, sample->accel, 3); break;
+            case BNO055_Q_MAG:           decode_vec(p, sample->mag, 3); break;
+            case BNO055_Q_GYRO:          decode_vec(p, sample->gyro, 3); break;
+            case BNO055_Q_EULER_HEADING: sample->euler[0] = le16(p); break;
+            case BNO055_Q_EULER_ROLL:    sample->euler[1] = le16(p); break;
+            case BNO055_Q_EULER_PITCH:   sample->euler[2] = le16(p); break;
+            case BNO055_Q_QUATERNION:    decode_vec(p, sample->quaternion, 4); break;
+            case BNO055_Q_LINEAR_ACCEL:  decode_vec(p, sample->linear_accel, 3); break;
+            case BNO055_Q_GRAVITY:       decode_vec(p, sample->gravity, 3); break;
+            case BNO055_Q_TEMP:          sample->temp = static_cast<s8>(p[0]); break;
+            case BNO055_Q_CALIB_STAT:    sample->calib_stat = p[0]; break;
+        }
+    }
+    sample->quantities = plan.quantities;
+}
@@ -0,0 +1,80 @@
+#ifndef BNO055_READ_PLAN_H
+#define BNO055_READ_PLAN_H
+
+#include <stdint.h>
+#include "bno055.h"
+
+/**
+ * @brief Quantities that can be requested from the BNO055 page 0 data block
+ * (0x08 - 0x35). Combine with | to build a request mask.
+ */
+enum Bno055Quantity : uint32_t {
+    BNO055_Q_ACCEL          = 1u << 0,   // 0x08 - 0x0D
+    BNO055_Q_MAG            = 1u << 1,   // 0x0E - 0x13
+    BNO055_Q_GYRO           = 1u << 2,   // 0x14 - 0x19
+    BNO055_Q_EULER_HEADING  = 1u << 3,   // 0x1A - 0x1B
+    BNO055_Q_EULER_ROLL     = 1u << 4,   // 0x1C - 0x1D
+    BNO055_Q_EULER_PITCH    = 1u << 5,   // 0x1E - 0x1F
+    BNO055_Q_QUATERNION     = 1u << 6,   // 0x20 - 0x27
+    BNO055_Q_LINEAR_ACCEL   = 1u << 7,   // 0x28 - 0x2D
+    BNO055_Q_GRAVITY        = 1u << 8,   // 0x2E - 0x33
+    BNO055_Q_TEMP           = 1u << 9,   // 0x34
+    BNO055_Q_CALIB_STAT     = 1u << 10,  // 0x35
+
+    BNO055_Q_EULER = BNO055_Q_EULER_HEADING | BNO055_Q_EULER_ROLL | BNO055_Q_EULER_PITCH,
+    BNO055_Q_ALL   = (1u << 11) - 1
+};
+
+// Raw LSBs per unit with the default unit selection (m/s^2, uT, dps, degrees)
+#define BNO055_ACCEL_LSB_PER_MSQ      (100.0)
+#define BNO055_MAG_LSB_PER_UT         (16.0)
+#define BNO055_GYRO_LSB_PER_DPS       (16.0)
+#define BNO055_EULER_LSB_PER_DEG      (16.0)
+#define BNO055_QUATERNION_LSB         (16384.0)
+
+/**
+ * @brief One contiguous burst covering every requested quantity.
+ */
+struct Bno055ReadPlan {
+    uint32_t quantities;  // mask the plan was built for
+    u8 start_reg;         // first register of the burst
+    u8 length;            // number of bytes, 0 for an empty request
+};
+
+#pragma pack(push, 1)
+/**
+ * @brief Raw decoded sample. Only the fields named in `quantities` are valid.
+ */
+struct Bno055Sample {
+    uint32_t quantities;
+    s16 accel[3];         // x, y, z
+    s16 mag[3];
+    s16 gyro[3];
+    s16 euler[3];         // heading, roll, pitch
+    s16 quaternion[4];    // w, x, y, z
+    s16 linear_accel[3];
+    s16 gravity[3];
+    s8 temp;
+    u8 calib_stat;
+};
+#pragma pack(pop)
+
+/**
+ * Computes the minimal contiguous register span that covers every requested
+ * quantity, so the whole request is a single bus transaction.
+ *
+ * @param quantities Bitmask of Bno055Quantity values.
+ * @return The burst start register and length.
+ */
+Bno055ReadPlan bno055_plan_read(uint32_t quantities);
+
+/**
+ * Decodes a burst read with the given plan into sample.
+ *
+ * @param plan   Plan used for the read.
+ * @param data   plan.length bytes starting at plan.start_reg.
+ * @param sample Output, fields outside plan.quantities are left untouched.
+ */
+void bno055_decode_sample(const Bno055ReadPlan& plan, const u8* data, Bno055Sample* sample);
+
+#endif // BNO055_READ_PLAN_H
@@ -1,4 +1,5 @@
 #include "data_collection.h"
+#include "frame_types.h"
 #include <iostream>
 #include <fstream>
 #include <vector>
@@ -11,6 +12,7 @@
 #include <unistd.h>
 #include "bno055.h"
 #include "rpi_tca9548a.h"
+#include "i2c_bus.h"
 #include <nlohmann/json.hpp>
 
 
@@ -21,11 +23,10 @@ using namespace std::this_thread;
 std::ofstream logFile;
 bool running = true;
 rpi_tca9548a tca;
-int fd;
 
 const std::vector<int> sensorChannels = {0x01, 0x02, 0x04, 0x08, 0x10, 0x20};
 const std::vector<int> sensorChannelsBackup = {0, 1, 2, 3, 4, 5};
-const std::vector<std::string> sensorLocations = {"Left Hip", "Left Knee", "Left Ankle", "Right Ankle","Right Knee", "Right Hip"};
+const std::vector<std::string> sensorLocations = IMU_LOCATIONS;
 
 // void signal_handler(int signal) {
 //     std::cout << "\nStopping data logging..." << std::endl;
@@ -33,8 +34,7 @@ const std::vector<std::string> sensorLocations = {"Left Hip", "Left Knee", "Left
 // }
 
 bool initI2C() {
-    fd = wiringPiI2CSetup(0x29);
-    if (fd == -1) {
+    if (default_i2c_bus().open() != 0) {
         std::cerr << "Failed to initialize I2C connection!" << std::endl;
         return false;
     }
@@ -42,22 +42,16 @@ bool initI2C() {
 }
 
 s8 I2C_bus_write_with_tca(u8 dev_addr, u8 reg_addr, u8 *reg_data, u8 cnt) {
-    if (fd == -1) return BNO055_ERROR;
-    for (int i = 0; i < cnt; i++) {
-        if (wiringPiI2CWriteReg8(fd, reg_addr + i, reg_data[i]) == -1) {
-            return BNO055_ERROR;
-        }
-    }
-    return BNO055_SUCCESS;
+    I2CBus& bus = default_i2c_bus();
+    if (!bus.is_open()) return BNO055_ERROR;
+    return bus.write(dev_addr, reg_addr, reg_data, cnt);
 }
 
+// Burst read: register address write + cnt byte read in one combined transaction
 s8 I2C_bus_read(u8 dev_addr, u8 reg_addr, u8 *reg_data, u8 cnt) {
-    if (fd == -1) return BNO055_ERROR;
-    for (int i = 0; i < cnt; i++) {
-        reg_data[i  ] = wiringPiI2CReadReg8(fd, reg_addr + i);
-        if (reg_data[i] == -1) return BNO055_ERROR;
-    }
-    return BNO055_SUCCESS;
+    I2CBus& bus = default_i2c_bus();
+    if (!bus.is_open()) return BNO055_ERROR;
+    return bus.read(dev_addr, reg_addr, reg_data, cnt);
 }
 
 s8 read_euler_angles(bno055_t* imu, bno055_euler_double_t* euler) {
@@ -23,7 +23,6 @@ using namespace std::this_thread;
 extern std::ofstream logFile;
 extern bool running;
 extern rpi_tca9548a tca;
-extern int fd;
 
 extern const std::vector<int> sensorChannels;
 extern const std::vector<int> sensorChannelsBackup;
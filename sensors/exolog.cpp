@@ -0,0 +1,269 @@
+#include "exolog.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char EXOLOG_MAGIC[8] = {'E', 'X', 'O', 'L', 'O', 'G', '0', '1'};
+static const size_t EXOLOG_PREFIX = 16;            // magic + header_size + schema_size
+static const size_t EXOLOG_WRITE_BUFFER = 1 << 16;
+static const uint32_t EXOLOG_MAX_HEADER = 1 << 20;  // sanity bound when reading one
+
+static const char* TYPE_NAMES[] = {"i8", "u8", "i16", "u16", "i32", "u32", "i64", "u64", "f32", "f64"};
+static const size_t TYPE_SIZES[] = {1, 1, 2, 2, 4, 4, 8, 8, 4, 8};
+
+const char* exolog_type_name(ExologType type) {
+    return TYPE_NAMES[static_cast<size_t>(type)];
+}
+
+size_t exolog_type_size(ExologType type) {
+    return TYPE_SIZES[static_cast<size_t>(type)];
+}
+
+static bool parse_type(const std::string& name, ExologType* type) {
+    for (size_t i = 0; i < sizeof(TYPE_NAMES) / sizeof(TYPE_NAMES[0]); i++) {
+        if (name == TYPE_NAMES[i]) {
+            *type = static_cast<ExologType>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ExologSchema::add(const std::string& name, ExologType type, uint32_t count, uint32_t offset,
+                       double scale, const std::string& unit) {
+    fields.push_back({name, type, count, offset, scale, unit});
+    uint32_t end = offset + count * static_cast<uint32_t>(exolog_type_size(type));
+    if (end > record_size) record_size = end;
+}
+
+void ExologSchema::append(const std::string& name, ExologType type, uint32_t count,
+                          double scale, const std::string& unit) {
+    uint32_t end = 0, widest = 1;
+    for (const ExologField& f : fields) {
+        end = std::max(end, f.offset + f.count * static_cast<uint32_t>(exolog_type_size(f.type)));
+        widest = std::max(widest, static_cast<uint32_t>(exolog_type_size(f.type)));
+    }
+    uint32_t align = static_cast<uint32_t>(exolog_type_size(type));
+    add(name, type, count, (end + align - 1) / align * align, scale, unit);
+
+    // Pad the record so every field stays aligned from one record to the next
+    widest = std::max(widest, align);
+    record_size = (record_size + widest - 1) / widest * widest;
+}
+
+const ExologField* ExologSchema::find(const std::string& name) const {
+    for (const ExologField& f : fields) {
+        if (f.name == name) return &f;
+    }
+    return nullptr;
+}
+
+std::string exolog_header(const ExologSchema& schema) {
+    std::ostringstream text;
+    text.precision(17);
+    text << "period_ns " << schema.period_ns << "\n";
+    text << "record_size " << schema.record_size << "\n";
+    if (!schema.compression.empty()) text << "compression " << schema.compression << "\n";
+    if (schema.realtime_offset_ns != 0) text << "realtime_offset_ns " << schema.realtime_offset_ns << "\n";
+    for (const std::string& location : schema.locations) text << "channel " << location << "\n";
+    for (const ExologField& f : schema.fields) {
+        text << "field " << f.name << " " << exolog_type_name(f.type) << " " << f.count << " "
+             << f.offset << " " << f.scale << " " << (f.unit.empty() ? "-" : f.unit) << "\n";
+    }
+
+    std::string schema_text = text.str();
+    uint32_t schema_size = static_cast<uint32_t>(schema_text.size());
+    uint32_t header_size = static_cast<uint32_t>((EXOLOG_PREFIX + schema_size + 7) / 8 * 8);
+
+    std::string header(header_size, '\0');
+    std::memcpy(&header[0], EXOLOG_MAGIC, sizeof(EXOLOG_MAGIC));
+    std::memcpy(&header[8], &header_size, sizeof(header_size));
+    std::memcpy(&header[12], &schema_size, sizeof(schema_size));
+    std::memcpy(&header[EXOLOG_PREFIX], schema_text.data(), schema_size);
+    return header;
+}
+
+int parse_exolog_header(const void* data, size_t size, ExologSchema& schema, size_t* header_size) {
+    const char* bytes = static_cast<const char*>(data);
+    if (size < EXOLOG_PREFIX || std::memcmp(bytes, EXOLOG_MAGIC, sizeof(EXOLOG_MAGIC)) != 0) return -1;
+
+    uint32_t total = 0, schema_size = 0;
+    std::memcpy(&total, bytes + 8, sizeof(total));
+    std::memcpy(&schema_size, bytes + 12, sizeof(schema_size));
+    if (total > size || total % 8 != 0 || EXOLOG_PREFIX + schema_size > total) return -1;
+
+    schema = ExologSchema();
+    uint32_t record_size = 0;
+    std::istringstream text(std::string(bytes + EXOLOG_PREFIX, schema_size));
+    std::string line;
+    while (std::getline(text, line)) {
+        std::istringstream fields(line);
+        std::string key;
+        if (!(fields >> key)) continue;
+
+        if (key == "period_ns") {
+            if (!(fields >> schema.period_ns)) return -1;
+        } else if (key == "record_size") {
+            if (!(fields >> record_size)) return -1;
+        } else if (key == "compression") {
+            if (!(fields >> schema.compression)) return -1;
+        } else if (key == "realtime_offset_ns") {
+            if (!(fields >> schema.realtime_offset_ns)) return -1;
+        } else if (key == "channel") {
+            std::string location;
+            std::getline(fields >> std::ws, location);
+            schema.locations.push_back(location);
+        } else if (key == "field") {
+            ExologField f;
+            std::string type;
+            if (!(fields >> f.name >> type >> f.count >> f.offset >> f.scale >> f.unit) ||
+                !parse_type(type, &f.type)) {
+                return -1;
+            }
+            if (f.unit == "-") f.unit.clear();
+            schema.add(f.name, f.type, f.count, f.offset, f.scale, f.unit);
+        }
+        // other keys are left for newer writers
+    }
+
+    // Fields must fit the declared record
+    if (record_size == 0 || schema.record_size > record_size) return -1;
+    schema.record_size = record_size;
+    *header_size = total;
+    return 0;
+}
+
+int read_exolog_header(const std::string& path, ExologSchema& schema, size_t* header_size) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) return -1;
+
+    // The prefix holds the size of the rest
+    std::vector<char> header(EXOLOG_PREFIX);
+    uint32_t total = 0;
+    if (std::fread(header.data(), 1, EXOLOG_PREFIX, file) == EXOLOG_PREFIX) {
+        std::memcpy(&total, &header[8], sizeof(total));
+    }
+    int result = -1;
+    if (total >= EXOLOG_PREFIX && total <= EXOLOG_MAX_HEADER) {
+        header.resize(total);
+        if (std::fread(&header[EXOLOG_PREFIX], 1, total - EXOLOG_PREFIX, file) == total - EXOLOG_PREFIX) {
+            result = parse_exolog_header(header.data(), header.size(), schema, header_size);
+        }
+    }
+    std::fclose(file);
+    return result;
+}
+
+int ExologWriter::open(const std::string& path, const ExologSchema& schema) {
+    close();
+    file_ = std::fopen(path.c_str(), "wb");
+    if (file_ == nullptr) {
+        std::cerr << "Failed to open " << path << " for writing: " << std::strerror(errno) << std::endl;
+        return -1;
+    }
+    buffer_.resize(EXOLOG_WRITE_BUFFER);
+    std::setvbuf(file_, buffer_.data(), _IOFBF, buffer_.size());
+
+    std::string header = exolog_header(schema);
+    record_size_ = schema.record_size;
+    records_ = 0;
+    if (std::fwrite(header.data(), 1, header.size(), file_) != header.size()) {
+        close();
+        return -1;
+    }
+    return 0;
+}
+
+int ExologWriter::write(const void* record) {
+    if (file_ == nullptr || std::fwrite(record, 1, record_size_, file_) != record_size_) return -1;
+    records_++;
+    return 0;
+}
+
+int ExologWriter::close() {
+    if (file_ == nullptr) return 0;
+    int result = std::fclose(file_) == 0 ? 0 : -1;
+    file_ = nullptr;
+    return result;
+}
+
+int ExologReader::open(const std::string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        std::cerr << "Failed to open " << path << std::endl;
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        return -1;
+    }
+
+    void* map = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // the mapping keeps the file
+    if (map == MAP_FAILED) return -1;
+    data_ = static_cast<const uint8_t*>(map);
+    size_ = static_cast<size_t>(st.st_size);
+
+    if (parse_exolog_header(data_, size_, schema_, &header_size_) != 0) {
+        std::cerr << path << " is not an .exolog file" << std::endl;
+        close();
+        return -1;
+    }
+    if (!schema_.compression.empty()) {
+        std::cerr << path << " is compressed (" << schema_.compression << "), decompress it first (exolog_convert)" << std::endl;
+        close();
+        return -1;
+    }
+    madvise(const_cast<uint8_t*>(data_), size_, MADV_SEQUENTIAL);
+    return 0;
+}
+
+void ExologReader::close() {
+    if (data_ != nullptr) munmap(const_cast<uint8_t*>(data_), size_);
+    data_ = nullptr;
+    size_ = 0;
+    header_size_ = 0;
+    schema_ = ExologSchema();
+}
+
+size_t ExologReader::frames() const {
+    if (data_ == nullptr || schema_.record_size == 0) return 0;
+    return (size_ - header_size_) / schema_.record_size;
+}
+
+template <typename T>
+static double load(const uint8_t* p) {
+    T v;
+    std::memcpy(&v, p, sizeof(v));
+    return static_cast<double>(v);
+}
+
+double exolog_value(const ExologField& field, const uint8_t* record, size_t index) {
+    const uint8_t* p = record + field.offset + index * exolog_type_size(field.type);
+    double raw = 0.0;
+    switch (field.type) {
+        case ExologType::I8:  raw = load<int8_t>(p); break;
+        case ExologType::U8:  raw = load<uint8_t>(p); break;
+        case ExologType::I16: raw = load<int16_t>(p); break;
+        case ExologType::U16: raw = load<uint16_t>(p); break;
+        case ExologType::I32: raw = load<int32_t>(p); break;
+        case ExologType::U32: raw = load<uint32_t>(p); break;
+        case ExologType::I64: raw = load<int64_t>(p); break;
+        case ExologType::U64: raw = load<uint64_t>(p); break;
+        case ExologType::F32: raw = load<float>(p); break;
+        case ExologType::F64: raw = load<double>(p); break;
+    }
+    return raw * field.scale;
+}
+
+double ExologReader::value(const ExologField& field, size_t t, size_t index) const {
+    return exolog_value(field, record(t), index);
+}
@@ -0,0 +1,200 @@
+#ifndef EXOLOG_H
+#define EXOLOG_H
+
+#include <stdint.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * .exolog recordings: a self-describing header followed by packed
+ * fixed-width records, one per frame.
+ *
+ *   "EXOLOG01"  uint32 header_size  uint32 schema_size  schema text  zero padding
+ *   record 0, record 1, ...   (header_size bytes from the start, a multiple of 8)
+ *
+ * The schema text lists the frame rate, the sensor locations (channels) and
+ * every field of a record: name, type, count (1 or one per channel), byte
+ * offset, scale to physical units and unit. Logs timed on CLOCK_MONOTONIC
+ * also carry the offset to epoch time. Values are little-endian. A file cut
+ * short by a crash simply ends with a partial record, which readers ignore.
+ */
+
+enum class ExologType : uint8_t { I8, U8, I16, U16, I32, U32, I64, U64, F32, F64 };
+
+const char* exolog_type_name(ExologType type);
+size_t exolog_type_size(ExologType type);
+
+// Type tag of a C++ type, for typed views
+template <typename T> struct ExologTypeOf;
+template <> struct ExologTypeOf<int8_t>   { static constexpr ExologType value = ExologType::I8; };
+template <> struct ExologTypeOf<uint8_t>  { static constexpr ExologType value = ExologType::U8; };
+template <> struct ExologTypeOf<int16_t>  { static constexpr ExologType value = ExologType::I16; };
+template <> struct ExologTypeOf<uint16_t> { static constexpr ExologType value = ExologType::U16; };
+template <> struct ExologTypeOf<int32_t>  { static constexpr ExologType value = ExologType::I32; };
+template <> struct ExologTypeOf<uint32_t> { static constexpr ExologType value = ExologType::U32; };
+template <> struct ExologTypeOf<int64_t>  { static constexpr ExologType value = ExologType::I64; };
+template <> struct ExologTypeOf<uint64_t> { static constexpr ExologType value = ExologType::U64; };
+template <> struct ExologTypeOf<float>    { static constexpr ExologType value = ExologType::F32; };
+template <> struct ExologTypeOf<double>   { static constexpr ExologType value = ExologType::F64; };
+
+struct ExologField {
+    std::string name;
+    ExologType type;
+    uint32_t count;    // 1, or the number of channels for per-sensor values
+    uint32_t offset;   // bytes from the start of the record
+    double scale;      // physical value = raw * scale
+    std::string unit;
+};
+
+struct ExologSchema {
+    int64_t period_ns = 0;               // nominal frame period, 0 if unknown
+    std::vector<std::string> locations;  // channel names, sensorLocations order
+    std::vector<ExologField> fields;
+    uint32_t record_size = 0;
+    std::string compression;             // empty for raw records, see exolog_codec.h
+    int64_t realtime_offset_ns = 0;      // added to the *_ns fields gives epoch time, 0 if they are already
+
+    size_t channels() const { return locations.size(); }
+
+    // Field at an explicit offset, for records that mirror a C++ struct
+    void add(const std::string& name, ExologType type, uint32_t count, uint32_t offset,
+             double scale = 1.0, const std::string& unit = "");
+
+    // Field at the next naturally aligned offset; grows record_size
+    void append(const std::string& name, ExologType type, uint32_t count,
+                double scale = 1.0, const std::string& unit = "");
+
+    const ExologField* find(const std::string& name) const;
+};
+
+// Header bytes for a schema, ready to be written at the start of a file
+std::string exolog_header(const ExologSchema& schema);
+
+/**
+ * Parses a header from the start of a file.
+ *
+ * @return 0 on success with header_size set, -1 if the data is not an
+ *         .exolog header or the schema is inconsistent.
+ */
+int parse_exolog_header(const void* data, size_t size, ExologSchema& schema, size_t* header_size);
+
+// Reads just the header of a file, quietly; @return as parse_exolog_header()
+int read_exolog_header(const std::string& path, ExologSchema& schema, size_t* header_size);
+
+// A numeric field of a record in physical units (raw * scale)
+double exolog_value(const ExologField& field, const uint8_t* record, size_t index = 0);
+
+/**
+ * @brief [frames][channels] view of one field, straight into the mapped file.
+ */
+template <typename T>
+class ExologSpan {
+  public:
+    ExologSpan() : base_(nullptr), rows_(0), cols_(0), stride_(0) {}
+    ExologSpan(const uint8_t* base, size_t rows, size_t cols, size_t stride)
+        : base_(base), rows_(rows), cols_(cols), stride_(stride) {}
+
+    size_t rows() const { return rows_; }
+    size_t cols() const { return cols_; }
+    bool empty() const { return rows_ == 0; }
+
+    // The channels of frame t are contiguous
+    const T* row(size_t t) const { return reinterpret_cast<const T*>(base_ + t * stride_); }
+    T operator()(size_t t, size_t channel) const { return row(t)[channel]; }
+
+  private:
+    const uint8_t* base_;
+    size_t rows_;
+    size_t cols_;
+    size_t stride_;
+};
+
+/**
+ * @brief Appends records to an .exolog file (offline tools; the controller
+ * writes through AsyncLogger with exolog_header() as the file header).
+ */
+class ExologWriter {
+  public:
+    ExologWriter() : file_(nullptr), record_size_(0), records_(0) {}
+    ~ExologWriter() { close(); }
+
+    ExologWriter(const ExologWriter&) = delete;
+    ExologWriter& operator=(const ExologWriter&) = delete;
+
+    // @return 0 on success, -1 if the file cannot be created.
+    int open(const std::string& path, const ExologSchema& schema);
+    int write(const void* record);  // schema.record_size bytes
+    int close();
+
+    uint64_t records() const { return records_; }
+
+  private:
+    std::FILE* file_;
+    size_t record_size_;
+    uint64_t records_;
+    std::vector<char> buffer_;
+};
+
+/**
+ * @brief Memory-mapped .exolog file. Views stay valid until close().
+ */
+class ExologReader {
+  public:
+    ExologReader() : data_(nullptr), size_(0), header_size_(0) {}
+    ~ExologReader() { close(); }
+
+    ExologReader(const ExologReader&) = delete;
+    ExologReader& operator=(const ExologReader&) = delete;
+
+    // @return 0 on success, -1 if the file is missing, not an .exolog file or
+    //         compressed (read those with ExologBlockReader).
+    int open(const std::string& path);
+    void close();
+
+    const ExologSchema& schema() const { return schema_; }
+    size_t frames() const;
+    const uint8_t* record(size_t t) const { return data_ + header_size_ + t * schema_.record_size; }
+
+    // Empty span when the field does not exist or has a different type
+    template <typename T>
+    ExologSpan<T> field(const std::string& name) const {
+        const ExologField* f = schema_.find(name);
+        if (f == nullptr || f->type != ExologTypeOf<T>::value) return ExologSpan<T>();
+        return ExologSpan<T>(record(0) + f->offset, frames(), f->count, schema_.record_size);
+    }
+
+    // Any numeric field in physical units (raw * scale)
+    double value(const ExologField& field, size_t t, size_t index = 0) const;
+
+  private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t header_size_;
+    ExologSchema schema_;
+};
+
+/**
+ * Converts an imu_data.json / joint_data.json style recording (see
+ * load_imu_replay()) to .exolog: timestamp_ns (epoch time from the lines'
+ * "timestamp", so no realtime_offset_ns), heading, roll
+ * and pitch per sensor as float degrees, and a valid_mask of the sensors
+ * present in each line. Sensors are mapped to channels by location name.
+ *
+ * Implemented with nlohmann_json and only built when it is available.
+ *
+ * @return number of frames written, -1 on error.
+ */
+long jsonl_to_exolog(const std::string& jsonl_path, const std::string& exolog_path,
+                     const std::vector<std::string>& locations, int64_t period_ns = 100000000);
+
+/**
+ * Writes an .exolog file as JSON lines in the same layout: a "timestamp"
+ * from timestamp_ns plus the header's realtime_offset_ns, and per valid sensor its location and whichever of
+ * heading/roll/pitch the file has, in degrees.
+ *
+ * @return number of lines written, -1 on error.
+ */
+long exolog_to_jsonl(const std::string& exolog_path, const std::string& jsonl_path);
+
+#endif // EXOLOG_H
@@ -0,0 +1,295 @@
+#include "exolog_codec.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+const char* const EXOLOG_DELTA_VARINT = "delta-varint";
+
+static const char BLOCK_MAGIC[4] = {'E', 'X', 'Z', 'B'};
+static const size_t BLOCK_HEADER = 16;               // magic, records, payload_size, crc
+static const uint32_t MAX_PAYLOAD = 64u << 20;       // anything larger is a damaged header
+static const size_t READ_CHUNK = 1 << 16;
+
+struct Crc32Table {
+    uint32_t entry[256];
+    Crc32Table() {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            entry[i] = c;
+        }
+    }
+};
+
+uint32_t exolog_crc32(const void* data, size_t size, uint32_t crc) {
+    static const Crc32Table table;
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) crc = table.entry[(crc ^ p[i]) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
+
+std::vector<ExologColumn> exolog_columns(const ExologSchema& schema) {
+    std::vector<ExologColumn> columns;
+    for (const ExologField& f : schema.fields) {
+        uint32_t size = static_cast<uint32_t>(exolog_type_size(f.type));
+        bool is_signed = f.type == ExologType::I8 || f.type == ExologType::I16 ||
+                         f.type == ExologType::I32 || f.type == ExologType::I64;
+        for (uint32_t i = 0; i < f.count; i++) columns.push_back({f.offset + i * size, size, is_signed});
+    }
+    return columns;
+}
+
+// Field element as 64 bits: signed integers sign-extended, the rest zero-extended
+static inline uint64_t load(const uint8_t* p, const ExologColumn& column) {
+    uint64_t v = 0;
+    std::memcpy(&v, p, column.size);
+    if (column.is_signed && column.size < 8) {
+        unsigned shift = 64 - 8 * column.size;
+        v = static_cast<uint64_t>(static_cast<int64_t>(v << shift) >> shift);
+    }
+    return v;
+}
+
+static inline uint64_t zigzag(uint64_t v) {
+    return (v << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(v) >> 63);
+}
+
+static inline uint64_t unzigzag(uint64_t z) {
+    return (z >> 1) ^ (0 - (z & 1));
+}
+
+static inline size_t varint_size(uint64_t v) {
+    return (64 - __builtin_clzll(v | 1) + 6) / 7;
+}
+
+static inline void put_varint(std::vector<uint8_t>& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+static inline bool get_varint(const uint8_t*& p, const uint8_t* end, uint64_t* v) {
+    uint64_t result = 0;
+    for (unsigned shift = 0; shift < 64 && p < end; shift += 7) {
+        uint8_t byte = *p++;
+        result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            *v = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+static inline void put_u32(std::vector<uint8_t>& out, uint32_t v) {
+    uint8_t bytes[4];
+    std::memcpy(bytes, &v, sizeof(v));
+    out.insert(out.end(), bytes, bytes + 4);
+}
+
+ExologBlockEncoder::ExologBlockEncoder(const ExologSchema& schema)
+    : columns_(exolog_columns(schema)), record_size_(schema.record_size) {}
+
+void ExologBlockEncoder::encode(const void* records, size_t count, std::vector<uint8_t>& out) {
+    const uint8_t* base = static_cast<const uint8_t*>(records);
+    payload_.assign((columns_.size() + 7) / 8, 0);  // mode bits
+    delta_.resize(count);
+    delta2_.resize(count);
+
+    for (size_t i = 0; i < columns_.size(); i++) {
+        const ExologColumn& column = columns_[i];
+        // Both encodings at once, keep the smaller
+        uint64_t prev = 0, prev_delta = 0;
+        size_t size1 = 0, size2 = 0;
+        const uint8_t* p = base + column.offset;
+        for (size_t r = 0; r < count; r++, p += record_size_) {
+            uint64_t v = load(p, column);
+            uint64_t d = v - prev;
+            delta_[r] = zigzag(d);
+            delta2_[r] = zigzag(d - prev_delta);
+            size1 += varint_size(delta_[r]);
+            size2 += varint_size(delta2_[r]);
+            prev = v;
+            prev_delta = d;
+        }
+        bool second = size2 < size1;
+        if (second) payload_[i / 8] |= static_cast<uint8_t>(1u << (i % 8));
+        for (uint64_t z : second ? delta2_ : delta_) put_varint(payload_, z);
+    }
+
+    out.insert(out.end(), BLOCK_MAGIC, BLOCK_MAGIC + sizeof(BLOCK_MAGIC));
+    put_u32(out, static_cast<uint32_t>(count));
+    put_u32(out, static_cast<uint32_t>(payload_.size()));
+    put_u32(out, exolog_crc32(payload_.data(), payload_.size()));
+    out.insert(out.end(), payload_.begin(), payload_.end());
+}
+
+ExologBlockDecoder::ExologBlockDecoder(const ExologSchema& schema)
+    : columns_(exolog_columns(schema)), record_size_(schema.record_size) {}
+
+long ExologBlockDecoder::decode(const uint8_t* data, size_t size, std::vector<uint8_t>& records) {
+    if (size < sizeof(BLOCK_MAGIC)) return 0;
+    if (std::memcmp(data, BLOCK_MAGIC, sizeof(BLOCK_MAGIC)) != 0) return -1;
+    if (size < BLOCK_HEADER) return 0;
+
+    uint32_t count = 0, payload_size = 0, crc = 0;
+    std::memcpy(&count, data + 4, sizeof(count));
+    std::memcpy(&payload_size, data + 8, sizeof(payload_size));
+    std::memcpy(&crc, data + 12, sizeof(crc));
+    // Every column takes at least a byte per record
+    const size_t mode_bytes = (columns_.size() + 7) / 8;
+    if (payload_size > MAX_PAYLOAD || payload_size < mode_bytes || (!columns_.empty() && count > payload_size)) return -1;
+    if (size < BLOCK_HEADER + payload_size) return 0;
+
+    const uint8_t* modes = data + BLOCK_HEADER;
+    const uint8_t* end = modes + payload_size;
+    if (exolog_crc32(modes, payload_size) != crc) return -1;
+
+    const uint8_t* p = modes + mode_bytes;
+    size_t first = records.size();
+    records.resize(first + static_cast<size_t>(count) * record_size_, 0);
+    for (size_t i = 0; i < columns_.size(); i++) {
+        const ExologColumn& column = columns_[i];
+        bool second = (modes[i / 8] >> (i % 8)) & 1;
+        uint64_t prev = 0, prev_delta = 0;
+        uint8_t* out = records.data() + first + column.offset;
+        for (uint32_t r = 0; r < count; r++, out += record_size_) {
+            uint64_t z;
+            if (!get_varint(p, end, &z)) {
+                records.resize(first);
+                return -1;
+            }
+            uint64_t d = second ? prev_delta + unzigzag(z) : unzigzag(z);
+            prev += d;
+            prev_delta = d;
+            std::memcpy(out, &prev, column.size);
+        }
+    }
+    if (p != end) {
+        records.resize(first);
+        return -1;
+    }
+    return static_cast<long>(BLOCK_HEADER + payload_size);
+}
+
+int ExologBlockReader::open(const std::string& path) {
+    close();
+    size_t header_size = 0;
+    if (read_exolog_header(path, schema_, &header_size) != 0 || schema_.compression != EXOLOG_DELTA_VARINT) {
+        std::cerr << path << " is not a compressed .exolog file" << std::endl;
+        return -1;
+    }
+    file_ = std::fopen(path.c_str(), "rb");
+    if (file_ == nullptr || std::fseek(file_, static_cast<long>(header_size), SEEK_SET) != 0) {
+        std::cerr << "Failed to open " << path << std::endl;
+        close();
+        return -1;
+    }
+    decoder_.reset(new ExologBlockDecoder(schema_));
+    buffer_.clear();
+    begin_ = 0;
+    bad_blocks_ = 0;
+    return 0;
+}
+
+void ExologBlockReader::close() {
+    if (file_ != nullptr) std::fclose(file_);
+    file_ = nullptr;
+    decoder_.reset();
+    buffer_.clear();
+    begin_ = 0;
+}
+
+bool ExologBlockReader::fill() {
+    buffer_.erase(buffer_.begin(), buffer_.begin() + begin_);
+    begin_ = 0;
+    size_t old = buffer_.size();
+    buffer_.resize(old + READ_CHUNK);
+    size_t n = std::fread(&buffer_[old], 1, READ_CHUNK, file_);
+    buffer_.resize(old + n);
+    return n > 0;
+}
+
+size_t ExologBlockReader::next(std::vector<uint8_t>& records) {
+    records.clear();
+    if (file_ == nullptr) return 0;
+    for (;;) {
+        long n = decoder_->decode(buffer_.data() + begin_, buffer_.size() - begin_, records);
+        if (n > 0) {
+            begin_ += static_cast<size_t>(n);
+            if (!records.empty()) return records.size() / schema_.record_size;
+            continue;
+        }
+        if (n == 0) {
+            if (!fill()) return 0;  // a partial block at the end is what a crash leaves
+            continue;
+        }
+
+        // Damaged: look for the next block marker past this one
+        bad_blocks_++;
+        begin_++;
+        for (;;) {
+            const uint8_t* start = buffer_.data() + begin_;
+            const uint8_t* found = static_cast<const uint8_t*>(
+                memmem(start, buffer_.size() - begin_, BLOCK_MAGIC, sizeof(BLOCK_MAGIC)));
+            if (found != nullptr) {
+                begin_ += static_cast<size_t>(found - start);
+                break;
+            }
+            // Keep a possible marker split across reads
+            if (buffer_.size() - begin_ >= sizeof(BLOCK_MAGIC)) begin_ = buffer_.size() - (sizeof(BLOCK_MAGIC) - 1);
+            if (!fill()) return 0;
+        }
+    }
+}
+
+long exolog_decompress(const std::string& in_path, const std::string& out_path) {
+    ExologBlockReader in;
+    if (in.open(in_path) != 0) return -1;
+    ExologSchema schema = in.schema();
+    schema.compression.clear();
+
+    ExologWriter out;
+    if (out.open(out_path, schema) != 0) return -1;
+    std::vector<uint8_t> records;
+    long total = 0;
+    while (size_t count = in.next(records)) {
+        for (size_t r = 0; r < count; r++) {
+            if (out.write(&records[r * schema.record_size]) != 0) return -1;
+        }
+        total += static_cast<long>(count);
+    }
+    if (in.bad_blocks() > 0) std::cerr << in_path << ": skipped " << in.bad_blocks() << " damaged block(s)" << std::endl;
+    return out.close() == 0 ? total : -1;
+}
+
+long exolog_compress(const std::string& in_path, const std::string& out_path, size_t block_records) {
+    ExologReader in;
+    if (in.open(in_path) != 0) return -1;
+    ExologSchema schema = in.schema();
+    schema.compression = EXOLOG_DELTA_VARINT;
+
+    std::FILE* out = std::fopen(out_path.c_str(), "wb");
+    if (out == nullptr) {
+        std::cerr << "Failed to open " << out_path << " for writing: " << std::strerror(errno) << std::endl;
+        return -1;
+    }
+    std::string header = exolog_header(schema);
+    bool ok = std::fwrite(header.data(), 1, header.size(), out) == header.size();
+
+    block_records = std::max<size_t>(block_records, 1);
+    ExologBlockEncoder encoder(schema);
+    std::vector<uint8_t> block;
+    size_t frames = in.frames();
+    for (size_t t = 0; ok && t < frames; t += block_records) {
+        block.clear();
+        encoder.encode(in.record(t), std::min(block_records, frames - t), block);
+        ok = std::fwrite(block.data(), 1, block.size(), out) == block.size();
+    }
+    ok = std::fclose(out) == 0 && ok;
+    return ok ? static_cast<long>(frames) : -1;
+}
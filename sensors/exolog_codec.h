@@ -0,0 +1,120 @@
+#ifndef EXOLOG_CODEC_H
+#define EXOLOG_CODEC_H
+
+#include <stdint.h>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#include "exolog.h"
+
+/**
+ * Compressed .exolog recordings ("compression delta-varint" in the schema).
+ *
+ * After the usual header come self-contained blocks instead of raw records:
+ *
+ *   "EXZB"  uint32 records  uint32 payload_size  uint32 crc32(payload)  payload
+ *
+ * The payload holds the records column by column, one column per element of
+ * every schema field (roll[0], roll[1], ...), each as one zigzag LEB128
+ * varint per record. A column stores either the delta to the previous record
+ * or the delta of that delta, whichever is smaller for the block; a leading
+ * bitmap, one bit per column, says which. Integers are taken at
+ * their width, floats by their bit pattern, so the round trip is exact for
+ * every byte a field covers; padding comes back as zeros.
+ *
+ * Quantized BNO055 values move by a few LSBs per frame and timestamps by a
+ * nearly constant step, so most columns take one byte per record.
+ */
+
+extern const char* const EXOLOG_DELTA_VARINT;  // ExologSchema::compression value
+
+// CRC-32 (IEEE 802.3), continuing from crc
+uint32_t exolog_crc32(const void* data, size_t size, uint32_t crc = 0);
+
+// One column of the block payload: an element of a schema field
+struct ExologColumn {
+    uint32_t offset;   // in the record
+    uint32_t size;     // bytes
+    bool is_signed;
+};
+
+std::vector<ExologColumn> exolog_columns(const ExologSchema& schema);
+
+class ExologBlockEncoder {
+  public:
+    explicit ExologBlockEncoder(const ExologSchema& schema);
+
+    // Appends one block holding count records (schema.record_size bytes each)
+    void encode(const void* records, size_t count, std::vector<uint8_t>& out);
+
+  private:
+    std::vector<ExologColumn> columns_;
+    size_t record_size_;
+    std::vector<uint64_t> delta_;   // scratch, zigzagged, one column
+    std::vector<uint64_t> delta2_;
+    std::vector<uint8_t> payload_;
+};
+
+class ExologBlockDecoder {
+  public:
+    explicit ExologBlockDecoder(const ExologSchema& schema);
+
+    /**
+     * Decodes the block at the start of data, appending its records.
+     *
+     * @return bytes the block took, 0 if data ends inside it, -1 if it is
+     *         not a block or fails its checksum.
+     */
+    long decode(const uint8_t* data, size_t size, std::vector<uint8_t>& records);
+
+  private:
+    std::vector<ExologColumn> columns_;
+    size_t record_size_;
+};
+
+/**
+ * @brief Reads a compressed .exolog file block by block, without loading it
+ * whole. A damaged block is counted and skipped to the next block marker; a
+ * block cut short by a crash ends the file.
+ */
+class ExologBlockReader {
+  public:
+    ExologBlockReader() : file_(nullptr), bad_blocks_(0) {}
+    ~ExologBlockReader() { close(); }
+
+    ExologBlockReader(const ExologBlockReader&) = delete;
+    ExologBlockReader& operator=(const ExologBlockReader&) = delete;
+
+    // @return 0 on success, -1 if the file is missing or not a compressed .exolog file.
+    int open(const std::string& path);
+    void close();
+
+    const ExologSchema& schema() const { return schema_; }
+
+    // Replaces records with the next block's; @return its record count, 0 at the end
+    size_t next(std::vector<uint8_t>& records);
+
+    uint64_t bad_blocks() const { return bad_blocks_; }
+
+  private:
+    bool fill();
+
+    std::FILE* file_;
+    ExologSchema schema_;
+    std::unique_ptr<ExologBlockDecoder> decoder_;
+    std::vector<uint8_t> buffer_;
+    size_t begin_ = 0;
+    uint64_t bad_blocks_;
+};
+
+/**
+ * Rewrites a compressed .exolog file as a plain one (or the reverse), e.g.
+ * before opening it with ExologReader.
+ *
+ * @return number of records written, -1 on error.
+ */
+long exolog_decompress(const std::string& in_path, const std::string& out_path);
+long exolog_compress(const std::string& in_path, const std::string& out_path, size_t block_records = 1024);
+
+#endif // EXOLOG_CODEC_H
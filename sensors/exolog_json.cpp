@@ -0,0 +1,116 @@
+#include "exolog.h"
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include "imu_jsonl_scan.h"
+
+using json = nlohmann::json;
+
+static const char* EULER_FIELDS[] = {"heading", "roll", "pitch"};
+
+// ns since the epoch to "YYYY-MM-DD HH:MM:SS.mmm" (UTC), what the JSONL readers parse
+static std::string format_log_timestamp(int64_t ns) {
+    std::time_t seconds = static_cast<std::time_t>(ns / 1000000000LL);
+    std::tm tm = {};
+    gmtime_r(&seconds, &tm);
+    char buffer[40];
+    size_t n = std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &tm);
+    std::snprintf(buffer + n, sizeof(buffer) - n, ".%03d", static_cast<int>(ns / 1000000 % 1000));
+    return buffer;
+}
+
+template <typename T>
+static void put(std::vector<uint8_t>& record, const ExologField& field, size_t index, T value) {
+    std::memcpy(&record[field.offset + index * sizeof(T)], &value, sizeof(T));
+}
+
+// Nanosecond fields exceed a double's 53 bits, read them without the detour
+static int64_t read_ns(const ExologReader& reader, const ExologField& field, size_t t, size_t index = 0) {
+    if (field.type != ExologType::I64 || field.scale != 1.0) {
+        return static_cast<int64_t>(reader.value(field, t, index));
+    }
+    int64_t ns;
+    std::memcpy(&ns, reader.record(t) + field.offset + index * sizeof(ns), sizeof(ns));
+    return ns;
+}
+
+long jsonl_to_exolog(const std::string& jsonl_path, const std::string& exolog_path,
+                     const std::vector<std::string>& locations, int64_t period_ns) {
+    if (locations.empty() || locations.size() > 8) {
+        std::cerr << "jsonl_to_exolog: 1-8 sensor locations are supported" << std::endl;
+        return -1;
+    }
+    ImuJsonlScanner scanner(locations, IMU_JSON_ALL, period_ns);
+    ImuJsonlColumns columns;
+    if (scanner.scan_file(jsonl_path, columns) != 0) return -1;
+
+    const uint32_t channels = static_cast<uint32_t>(locations.size());
+    ExologSchema schema;
+    schema.period_ns = period_ns;
+    schema.locations = locations;
+    schema.append("timestamp_ns", ExologType::I64, 1, 1.0, "ns");
+    for (const char* name : EULER_FIELDS) schema.append(name, ExologType::F32, channels, 1.0, "deg");
+    schema.append("valid_mask", ExologType::U8, 1);
+
+    ExologWriter writer;
+    if (writer.open(exolog_path, schema) != 0) return -1;
+
+    const std::vector<std::vector<float>>* euler[] = {&columns.heading, &columns.roll, &columns.pitch};
+    std::vector<uint8_t> record(schema.record_size);
+    for (size_t f = 0; f < columns.frames(); f++) {
+        put(record, *schema.find("timestamp_ns"), 0, columns.timestamp_ns[f]);
+        for (size_t q = 0; q < 3; q++) {
+            const ExologField& field = *schema.find(EULER_FIELDS[q]);
+            for (size_t c = 0; c < channels; c++) put(record, field, c, (*euler[q])[c][f]);
+        }
+        put(record, *schema.find("valid_mask"), 0, columns.valid_mask[f]);
+        if (writer.write(record.data()) != 0) return -1;
+    }
+    if (writer.close() != 0) return -1;
+    return static_cast<long>(writer.records());
+}
+
+long exolog_to_jsonl(const std::string& exolog_path, const std::string& jsonl_path) {
+    ExologReader reader;
+    if (reader.open(exolog_path) != 0) return -1;
+    const ExologSchema& schema = reader.schema();
+    const ExologField* time_field = schema.find("timestamp_ns");
+    const ExologField* mask_field = schema.find("valid_mask");
+    const ExologField* sample_field = schema.find("sample_ns");
+
+    std::vector<std::pair<const char*, const ExologField*>> euler;
+    for (const char* name : EULER_FIELDS) {
+        const ExologField* f = schema.find(name);
+        if (f != nullptr && f->count == schema.channels()) euler.emplace_back(name, f);
+    }
+
+    std::ofstream out(jsonl_path);
+    if (!out.is_open()) {
+        std::cerr << "Failed to open " << jsonl_path << " for writing" << std::endl;
+        return -1;
+    }
+
+    for (size_t t = 0; t < reader.frames(); t++) {
+        json entry;
+        if (time_field != nullptr) {
+            entry["timestamp"] = format_log_timestamp(read_ns(reader, *time_field, t) + schema.realtime_offset_ns);
+        }
+        entry["sensors"] = json::array();
+
+        uint32_t valid = mask_field != nullptr ? static_cast<uint32_t>(reader.value(*mask_field, t)) : ~0u;
+        for (size_t c = 0; c < schema.channels(); c++) {
+            if (!(valid & (1u << c))) continue;
+            json sensor;
+            sensor["location"] = schema.locations[c];
+            sensor["euler"] = json::object();
+            for (const auto& q : euler) sensor["euler"][q.first] = reader.value(*q.second, t, c);
+            if (sample_field != nullptr) sensor["t_ns"] = read_ns(reader, *sample_field, t, c);
+            entry["sensors"].push_back(sensor);
+        }
+        out << entry.dump() << "\n";
+    }
+    return out.good() ? static_cast<long>(reader.frames()) : -1;
+}
@@ -0,0 +1,139 @@
+#include "filter_bank.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstring>
+#include <iostream>
+#include "simd_lanes.h"
+
+// RBJ audio EQ cookbook sections, designed in double and normalized by a0
+static BiquadCoefficients normalized(double b0, double b1, double b2, double a0, double a1, double a2) {
+    return {static_cast<float>(b0 / a0), static_cast<float>(b1 / a0), static_cast<float>(b2 / a0),
+            static_cast<float>(a1 / a0), static_cast<float>(a2 / a0)};
+}
+
+BiquadCoefficients design_lowpass(double cutoff_hz, double sample_rate_hz, double q) {
+    const double w0 = 2.0 * M_PI * cutoff_hz / sample_rate_hz;
+    const double alpha = std::sin(w0) / (2.0 * q);
+    const double c = std::cos(w0);
+    return normalized((1.0 - c) / 2.0, 1.0 - c, (1.0 - c) / 2.0, 1.0 + alpha, -2.0 * c, 1.0 - alpha);
+}
+
+BiquadCoefficients design_notch(double center_hz, double sample_rate_hz, double q) {
+    const double w0 = 2.0 * M_PI * center_hz / sample_rate_hz;
+    const double alpha = std::sin(w0) / (2.0 * q);
+    const double c = std::cos(w0);
+    return normalized(1.0, -2.0 * c, 1.0, 1.0 + alpha, -2.0 * c, 1.0 - alpha);
+}
+
+double biquad_magnitude(const BiquadCoefficients& c, double frequency_hz, double sample_rate_hz) {
+    const std::complex<double> z1 = std::polar(1.0, -2.0 * M_PI * frequency_hz / sample_rate_hz);  // z^-1
+    const std::complex<double> z2 = z1 * z1;
+    const std::complex<double> numerator = double(c.b0) + double(c.b1) * z1 + double(c.b2) * z2;
+    return std::abs(numerator / (1.0 + double(c.a1) * z1 + double(c.a2) * z2));
+}
+
+int FilterBank::configure(size_t channels, const Config& config) {
+    channels_ = channels;
+    lanes_ = (channels + simd::LANES - 1) / simd::LANES * simd::LANES;
+    sample_rate_hz_ = config.sample_rate_hz;
+    coefficients_.clear();
+
+    if (config.stages.size() > MAX_STAGES) {
+        std::cerr << "Filter bank takes at most " << MAX_STAGES << " sections, not " << config.stages.size()
+                  << std::endl;
+        reset();
+        return -1;
+    }
+    for (const Stage& stage : config.stages) {
+        if (!(stage.frequency_hz > 0.0 && stage.frequency_hz < config.sample_rate_hz / 2.0)) {
+            std::cerr << "Filter frequency " << stage.frequency_hz << " Hz is outside (0, "
+                      << config.sample_rate_hz / 2.0 << ") Hz for " << config.sample_rate_hz << " Hz samples"
+                      << std::endl;
+            coefficients_.clear();
+            reset();
+            return -1;
+        }
+        if (stage.type == Type::LOWPASS) {
+            coefficients_.push_back(stage.q > 0.0 ? design_lowpass(stage.frequency_hz, config.sample_rate_hz, stage.q)
+                                                  : design_lowpass(stage.frequency_hz, config.sample_rate_hz));
+        } else {
+            coefficients_.push_back(stage.q > 0.0 ? design_notch(stage.frequency_hz, config.sample_rate_hz, stage.q)
+                                                  : design_notch(stage.frequency_hz, config.sample_rate_hz));
+        }
+    }
+    reset();
+    return 0;
+}
+
+void FilterBank::reset() {
+    state_.assign(coefficients_.size() * 2 * lanes_, 0.0f);
+}
+
+void FilterBank::prime(const float* frame) {
+    // A constant x leaves each section at y = g x, g its DC gain, with
+    // z1 = y - b0 x and z2 = b2 x - a2 y
+    for (size_t c = 0; c < channels_; ++c) {
+        float x = frame[c];
+        for (size_t s = 0; s < coefficients_.size(); ++s) {
+            const BiquadCoefficients& k = coefficients_[s];
+            float y = x * (k.b0 + k.b1 + k.b2) / (1.0f + k.a1 + k.a2);
+            state_[(s * 2) * lanes_ + c] = y - k.b0 * x;
+            state_[(s * 2 + 1) * lanes_ + c] = k.b2 * x - k.a2 * y;
+            x = y;
+        }
+    }
+}
+
+void FilterBank::process(const float* in, float* out, size_t frames) {
+    const size_t stages = coefficients_.size();
+    if (stages == 0) {
+        if (in != out) std::memmove(out, in, frames * channels_ * sizeof(float));
+        return;
+    }
+
+    simd::F8 b0[MAX_STAGES], b1[MAX_STAGES], b2[MAX_STAGES], a1[MAX_STAGES], a2[MAX_STAGES];
+    for (size_t s = 0; s < stages; ++s) {
+        const BiquadCoefficients& k = coefficients_[s];
+        b0[s] = simd::set1(k.b0);
+        b1[s] = simd::set1(k.b1);
+        b2[s] = simd::set1(k.b2);
+        a1[s] = simd::set1(k.a1);
+        a2[s] = simd::set1(k.a2);
+    }
+
+    // Each block of lanes runs through all the frames, every sample through
+    // the whole cascade, with the state of every section held locally
+    simd::F8 z1[MAX_STAGES], z2[MAX_STAGES];
+    for (size_t b = 0; b < lanes_; b += simd::LANES) {
+        const size_t n = std::min(simd::LANES, channels_ - b);
+        for (size_t s = 0; s < stages; ++s) {
+            z1[s] = simd::load(&state_[(s * 2) * lanes_ + b]);
+            z2[s] = simd::load(&state_[(s * 2 + 1) * lanes_ + b]);
+        }
+
+        for (size_t t = 0; t < frames; ++t) {
+            const size_t at = t * channels_ + b;
+            simd::F8 x = simd::load_n(in + at, n);
+            for (size_t s = 0; s < stages; ++s) {
+                const simd::F8 y = b0[s] * x + z1[s];
+                z1[s] = b1[s] * x - a1[s] * y + z2[s];
+                z2[s] = b2[s] * x - a2[s] * y;
+                x = y;
+            }
+            simd::store_n(out + at, x, n);
+        }
+
+        for (size_t s = 0; s < stages; ++s) {
+            simd::store(&state_[(s * 2) * lanes_ + b], z1[s]);
+            simd::store(&state_[(s * 2 + 1) * lanes_ + b], z2[s]);
+        }
+    }
+}
+
+double FilterBank::magnitude(double frequency_hz) const {
+    double gain = 1.0;
+    for (const BiquadCoefficients& k : coefficients_) gain *= biquad_magnitude(k, frequency_hz, sample_rate_hz_);
+    return gain;
+}
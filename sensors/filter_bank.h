@@ -0,0 +1,86 @@
+#ifndef FILTER_BANK_H
+#define FILTER_BANK_H
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief One second-order IIR section, normalized so a0 = 1.
+ *
+ * y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2]
+ */
+struct BiquadCoefficients {
+    float b0, b1, b2, a1, a2;
+};
+
+// Butterworth low-pass at Q = 1/sqrt(2): -3 dB at cutoff_hz, unity gain at DC
+BiquadCoefficients design_lowpass(double cutoff_hz, double sample_rate_hz, double q = 0.7071067811865476);
+// Notch with zero gain at center_hz, unity gain at DC and Nyquist; -3 dB about
+// center_hz / q wide when well below Nyquist
+BiquadCoefficients design_notch(double center_hz, double sample_rate_hz, double q = 5.0);
+
+// |H(f)| of one section at frequency_hz
+double biquad_magnitude(const BiquadCoefficients& c, double frequency_hz, double sample_rate_hz);
+
+/**
+ * @brief The same cascade of biquads on every channel of an interleaved
+ * [frames][channels] stream.
+ *
+ * Sections run in transposed direct form II with their two state values per
+ * channel kept between calls, so a stream can be fed a frame per control
+ * tick or a block at a time with the same result. Channels are processed
+ * eight at a time across SIMD lanes (simd_lanes.h), each sample through the
+ * whole cascade with every section's state held locally over a call.
+ *
+ * Run it on angles after preprocessing has unwrapped them: a +/-180 degree
+ * wrap fed straight in rings through the whole cascade.
+ */
+class FilterBank {
+  public:
+    enum class Type { LOWPASS, NOTCH };
+    static constexpr size_t MAX_STAGES = 8;
+
+    struct Stage {
+        Type type;
+        double frequency_hz;  // low-pass cutoff or notch center
+        double q;             // 0: the designer's default
+    };
+
+    struct Config {
+        double sample_rate_hz = 0.0;
+        std::vector<Stage> stages;  // applied in order; none passes samples through
+    };
+
+    FilterBank() : channels_(0), lanes_(0) {}
+
+    /**
+     * Designs the sections and clears the state.
+     *
+     * @return 0 on success, -1 (and no sections) if a frequency is not
+     *         inside (0, sample_rate / 2) or there are more than MAX_STAGES.
+     */
+    int configure(size_t channels, const Config& config);
+
+    // Filters frames [frames][channels] rows; in and out may be the same
+    void process(const float* in, float* out, size_t frames = 1);
+
+    // Zero state, as if the input had been 0 forever
+    void reset();
+    // State of a stream that has been sitting at frame (channels values) forever
+    void prime(const float* frame);
+
+    size_t channels() const { return channels_; }
+    size_t stages() const { return coefficients_.size(); }
+    const BiquadCoefficients& coefficients(size_t stage) const { return coefficients_[stage]; }
+    // |H(f)| of the whole cascade
+    double magnitude(double frequency_hz) const;
+
+  private:
+    size_t channels_;
+    size_t lanes_;        // channels rounded up to whole blocks of lanes
+    double sample_rate_hz_ = 0.0;
+    std::vector<BiquadCoefficients> coefficients_;
+    std::vector<float> state_;  // [stage][2][lanes]: z1 then z2
+};
+
+#endif // FILTER_BANK_H
@@ -0,0 +1,61 @@
+#include "frame_aligner.h"
+#include <algorithm>
+#include <cmath>
+
+static float wrap_deg(float deg) {
+    float wrapped = std::fmod(deg + 180.0f, 360.0f);
+    if (wrapped < 0.0f) wrapped += 360.0f;
+    return wrapped - 180.0f;
+}
+
+float interpolate_angle_deg(float a, float b, float fraction) {
+    float delta = wrap_deg(b - a);
+    return wrap_deg(a + delta * fraction);
+}
+
+FrameAligner::FrameAligner() {
+    reset();
+}
+
+void FrameAligner::reset() {
+    for (size_t i = 0; i < IMU_CHANNELS; i++) {
+        have_last_[i] = false;
+        last_ns_[i] = 0;
+        last_roll_[i] = 0.0f;
+    }
+}
+
+void FrameAligner::align(const ImuFrame& frame, AlignedFrame& out) {
+    out.sequence = frame.sequence;
+    out.time_ns = frame.timestamp_ns;
+    out.valid_mask = 0;
+
+    for (size_t i = 0; i < IMU_CHANNELS; i++) {
+        bool valid = frame.valid_mask & (1u << i);
+        if (!valid) {
+            // Stand-ins from the health monitor are used as they are, never
+            // kept as an interpolation anchor
+            bool substituted = frame.substituted_mask & (1u << i);
+            out.roll[i] = substituted ? roll_deg(frame, i) : last_roll_[i];
+            bool held = !substituted && have_last_[i];
+            out.age_ns[i] = held ? std::max<int64_t>(out.time_ns - last_ns_[i], 0) : 0;
+            continue;
+        }
+
+        float roll = roll_deg(frame, i);
+        int64_t t = frame.sample_ns[i];
+        out.roll[i] = roll;
+        out.age_ns[i] = sample_age_ns(frame, i);
+        if (have_last_[i] && t > last_ns_[i] && out.time_ns >= last_ns_[i] && out.time_ns <= t) {
+            float fraction = static_cast<float>(out.time_ns - last_ns_[i]) /
+                             static_cast<float>(t - last_ns_[i]);
+            out.roll[i] = interpolate_angle_deg(last_roll_[i], roll, fraction);
+            out.age_ns[i] = 0;
+        }
+        out.valid_mask |= static_cast<uint8_t>(1u << i);
+
+        have_last_[i] = true;
+        last_ns_[i] = t;
+        last_roll_[i] = roll;
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef FRAME_ALIGNER_H
+#define FRAME_ALIGNER_H
+
+#include <stdint.h>
+#include "imu_acquisition.h"
+
+/**
+ * @brief All channels resampled to one instant.
+ */
+struct AlignedFrame {
+    uint64_t sequence;          // sequence of the sweep it was built from
+    int64_t time_ns;            // CLOCK_MONOTONIC the channels are aligned to
+    float roll[IMU_CHANNELS];   // degrees
+    uint8_t valid_mask;         // bit i clear when channel i is held from an older sample
+    int64_t age_ns[IMU_CHANNELS];  // how old roll[i] is at time_ns, 0 when interpolated to it
+};
+
+/**
+ * @brief Removes the mux skew from sweeps by interpolating every channel to
+ * the sweep start time.
+ *
+ * Channels are read one after another, so within a sweep channel i is
+ * sample_ns[i] - timestamp_ns later than the sweep start. Every sample of the
+ * previous sweep lies before that start and every sample of the current one
+ * after it, so each channel is linearly interpolated between its last good
+ * sample and its current one, never extrapolated. Roll is interpolated along
+ * the shorter arc so a +/-180 degree wrap does not produce a spike.
+ *
+ * A channel that fails to read holds its last good value (or takes the
+ * health monitor's stand-in when the frame carries one) with its valid bit
+ * cleared. The first sweep has nothing to interpolate from and passes its
+ * samples through unchanged. A channel on a slower schedule carries its last
+ * sample between reads; it stays valid and is passed on with its age.
+ */
+class FrameAligner {
+  public:
+    FrameAligner();
+
+    // Aligns one sweep, call with every frame in sequence order
+    void align(const ImuFrame& frame, AlignedFrame& out);
+
+    void reset();
+
+  private:
+    bool have_last_[IMU_CHANNELS];
+    int64_t last_ns_[IMU_CHANNELS];     // time of the last good sample
+    float last_roll_[IMU_CHANNELS];     // degrees
+};
+
+// Linear interpolation of an angle in degrees along the shorter arc, result in [-180, 180)
+float interpolate_angle_deg(float a, float b, float fraction);
+
+#endif // FRAME_ALIGNER_H
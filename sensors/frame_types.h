@@ -0,0 +1,59 @@
+#ifndef FRAME_TYPES_H
+#define FRAME_TYPES_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Roll inputs, in the order of the recordings' "location" list
+enum class ImuChannel : size_t { LEFT_HIP, LEFT_KNEE, LEFT_ANKLE, RIGHT_ANKLE, RIGHT_KNEE, RIGHT_HIP, COUNT };
+
+// Those "location" names, indexed by ImuChannel
+inline const std::vector<std::string> IMU_LOCATIONS = {"Left Hip", "Left Knee", "Left Ankle",
+                                                       "Right Ankle", "Right Knee", "Right Hip"};
+
+// Model outputs as the controller reads them ("lk la ra rh rk lh")
+enum class Joint : size_t { LEFT_KNEE, LEFT_ANKLE, RIGHT_ANKLE, RIGHT_HIP, RIGHT_KNEE, LEFT_HIP, COUNT };
+
+// Torque commands, in the order of the motors vector
+enum class MotorChannel : size_t { RIGHT_HIP, RIGHT_KNEE, LEFT_HIP, LEFT_KNEE, COUNT };
+
+/**
+ * @brief Fixed-size frame of one value per channel, indexed by name.
+ *
+ * A std::array inline, so frames are passed and returned by value without
+ * touching the heap. operator[] takes only the frame's own Channel enum,
+ * so a joint frame cannot be indexed with a motor channel or a bare
+ * number; loops over all channels go through values or data().
+ *
+ * @tparam T       Value type.
+ * @tparam Channel Enum naming the channels, ending in COUNT.
+ */
+template <typename T, typename Channel>
+struct ChannelFrame {
+    static constexpr size_t SIZE = static_cast<size_t>(Channel::COUNT);
+
+    std::array<T, SIZE> values{};
+
+    T& operator[](Channel c) { return values[static_cast<size_t>(c)]; }
+    const T& operator[](Channel c) const { return values[static_cast<size_t>(c)]; }
+
+    T* data() { return values.data(); }
+    const T* data() const { return values.data(); }
+    static constexpr size_t size() { return SIZE; }
+    typename std::array<T, SIZE>::iterator begin() { return values.begin(); }
+    typename std::array<T, SIZE>::iterator end() { return values.end(); }
+    typename std::array<T, SIZE>::const_iterator begin() const { return values.begin(); }
+    typename std::array<T, SIZE>::const_iterator end() const { return values.end(); }
+
+    bool operator==(const ChannelFrame& other) const { return values == other.values; }
+    bool operator!=(const ChannelFrame& other) const { return values != other.values; }
+};
+
+using RollFrame = ChannelFrame<float, ImuChannel>;        // degrees, one per IMU
+using JointAngles = ChannelFrame<float, Joint>;           // model prediction, degrees or radians
+using TorqueCommand = ChannelFrame<int16_t, MotorChannel>;  // scaled motor torque units
+
+#endif // FRAME_TYPES_H
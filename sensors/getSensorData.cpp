@@ -1,47 +1,180 @@
 #include "getSensorData.h"
+#include "imu_jsonl_scan.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 
-using json = nlohmann::json;
+static const char INDEX_MAGIC[8] = {'E', 'X', 'O', 'I', 'D', 'X', '0', '1'};
 
 
-std::vector<std::vector<float>> get_sensor_data(
-    const std::string &filename,
-    int chunk_index,
-    int step_size
-){ 
-    std::ifstream file(filename);
-    std::string line;
-    std::vector<std::vector<float>> output;
-    
-    if (!file.is_open()) {
+int SensorLogReader::open(const std::string& filename) {
+    close();
+    int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
         std::cerr << "Failed to open file: " << filename << std::endl;
-        return {};
+        return -1;
     }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ > 0) {
+        void* map = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map == MAP_FAILED) {
+            ::close(fd);
+            size_ = 0;
+            return -1;
+        }
+        data_ = static_cast<const char*>(map);
+    }
+    ::close(fd);  // the mapping keeps the file
+    filename_ = filename;
 
-    int start_line = chunk_index;
-    int end_line = start_line + step_size;
-    int current_line = 0;
+    int64_t mtime_ns = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+    std::string index_path = filename + ".idx";
+    index_loaded_ = load_index(index_path, size_, mtime_ns);
+    if (!index_loaded_) {
+        build_index();
+        save_index(index_path, size_, mtime_ns);
+    }
+    rolls_.resize(lines());
+    roll_state_.assign(lines(), ROLL_UNPARSED);
+    return 0;
+}
 
-    while (std::getline(file, line)) {
-        if (current_line >= start_line && current_line < end_line) {
-            json entry = json::parse(line);
+void SensorLogReader::close() {
+    if (data_ != nullptr) munmap(const_cast<char*>(data_), size_);
+    data_ = nullptr;
+    size_ = 0;
+    filename_.clear();
+    line_start_.clear();
+    rolls_.clear();
+    roll_state_.clear();
+    index_loaded_ = false;
+}
 
-            std::array<float, 6> rolls;
-            int idx = 0;
+void SensorLogReader::build_index() {
+    line_start_.clear();
+    size_t pos = 0;
+    while (pos < size_) {
+        line_start_.push_back(pos);
+        const void* nl = std::memchr(data_ + pos, '\n', size_ - pos);
+        pos = nl != nullptr ? static_cast<size_t>(static_cast<const char*>(nl) - data_) + 1 : size_;
+    }
+    line_start_.push_back(size_);
+}
 
-            for (const auto &sensor : entry["sensors"]) {
-                rolls[idx++] = sensor["euler"]["roll"];
-            }
+// Sidecar layout: magic, log size, log mtime (ns), line count + 1, offsets
+bool SensorLogReader::load_index(const std::string& path, uint64_t file_size, int64_t mtime_ns) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) return false;
+
+    char magic[8];
+    uint64_t size = 0, count = 0;
+    int64_t mtime = 0;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(&size), sizeof(size));
+    in.read(reinterpret_cast<char*>(&mtime), sizeof(mtime));
+    in.read(reinterpret_cast<char*>(&count), sizeof(count));
+    if (!in || std::memcmp(magic, INDEX_MAGIC, sizeof(magic)) != 0 || size != file_size ||
+        mtime != mtime_ns || count == 0 || count > file_size + 1) {
+        return false;
+    }
 
-            if (idx == 6) output.push_back(std::vector<float>(rolls.begin(), rolls.end()));
+    line_start_.resize(count);
+    in.read(reinterpret_cast<char*>(line_start_.data()), count * sizeof(uint64_t));
+    if (!in || line_start_.back() != file_size) {
+        line_start_.clear();
+        return false;
+    }
+    return true;
+}
+
+void SensorLogReader::save_index(const std::string& path, uint64_t file_size, int64_t mtime_ns) const {
+    // Written next to the old one and renamed, so a reader never sees half an index.
+    // Read-only log directories just go without a cache.
+    std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return;
+        uint64_t count = line_start_.size();
+        out.write(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+        out.write(reinterpret_cast<const char*>(&file_size), sizeof(file_size));
+        out.write(reinterpret_cast<const char*>(&mtime_ns), sizeof(mtime_ns));
+        out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        out.write(reinterpret_cast<const char*>(line_start_.data()), count * sizeof(uint64_t));
+        if (!out) {
+            out.close();
+            std::remove(tmp.c_str());
+            return;
         }
+    }
+    std::rename(tmp.c_str(), path.c_str());
+}
+
+const char* SensorLogReader::line(size_t i, size_t* length) const {
+    size_t begin = line_start_[i];
+    size_t end = line_start_[i + 1];
+    while (end > begin && (data_[end - 1] == '\n' || data_[end - 1] == '\r')) end--;
+    *length = end - begin;
+    return data_ + begin;
+}
+
+bool SensorLogReader::parse_rolls(size_t i) const {
+    if (roll_state_[i] != ROLL_UNPARSED) return roll_state_[i] == ROLL_OK;
+
+    // Only the rolls are pulled out, in recorded sensor order
+    size_t length = 0;
+    const char* text = line(i, &length);
+    ImuJsonLine entry;
+    roll_state_[i] = ROLL_SKIP;
+    if (!scan_imu_json_line(text, text + length, IMU_JSON_ROLL, entry) || entry.sensors < 6) return false;
 
-        current_line++;
-        if (current_line >= end_line) break;
+    std::array<float, 6>& rolls = rolls_[i];
+    for (size_t idx = 0; idx < rolls.size(); idx++) {
+        if (!entry.sensor[idx].has_euler) return false;
+        rolls[idx] = entry.sensor[idx].roll;
+    }
+    roll_state_[i] = ROLL_OK;
+    return true;
+}
+
+std::vector<std::vector<float>> SensorLogReader::roll_window(size_t start, size_t count) const {
+    std::vector<std::vector<float>> output;
+    size_t end = std::min(lines(), start + count);
+    for (size_t i = start; i < end; i++) {
+        if (parse_rolls(i)) output.push_back(std::vector<float>(rolls_[i].begin(), rolls_[i].end()));
     }
     return output;
 }
 
+std::vector<std::vector<float>> get_sensor_data(
+    const std::string &filename,
+    int chunk_index,
+    int step_size
+){
+    // One reader for the file being replayed, called from one thread
+    static SensorLogReader reader;
+    if (chunk_index < 0 || step_size <= 0) return {};
+
+    bool reopen = !reader.is_open() || reader.filename() != filename;
+    if (!reopen && static_cast<size_t>(chunk_index) + step_size > reader.lines()) {
+        // The log may still be being written
+        struct stat st;
+        reopen = stat(filename.c_str(), &st) == 0 && static_cast<size_t>(st.st_size) != reader.size();
+    }
+    if (reopen && reader.open(filename) != 0) return {};
+
+    return reader.roll_window(static_cast<size_t>(chunk_index), static_cast<size_t>(step_size));
+}
+
 // int main(){
 //     auto chunk = get_sensor_data("/home/dylan-exo/control_system/filtered_imu_data_treadmill_5min_1.9mph.json", 0, 30);
 
@@ -52,4 +185,4 @@ std::vector<std::vector<float>> get_sensor_data(
 //         }
 //         std::cout << std::endl;
 //     }
-// }
\ No newline at end of file
+// }
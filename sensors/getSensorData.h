@@ -1,17 +1,83 @@
+#ifndef GET_SENSOR_DATA_H
+#define GET_SENSOR_DATA_H
+
 #include <iostream>
 #include <fstream>
-#include <nlohmann/json.hpp>
 #include <vector>
 #include <string>
 #include <array>
+#include <stdint.h>
+
+
+/**
+ * Random access to the lines of a JSONL sensor log.
+ *
+ * The file is memory-mapped once and the byte offset of every line is kept
+ * in an index, so any window of frames costs only its own lines; each
+ * line's rolls are parsed once and kept, so overlapping windows are cheap. The index
+ * is cached next to the log as "<file>.idx" and reused while the log's size
+ * and modification time match; a missing or stale sidecar is rebuilt.
+ */
+class SensorLogReader {
+  public:
+    SensorLogReader() : data_(nullptr), size_(0) {}
+    ~SensorLogReader() { close(); }
+
+    SensorLogReader(const SensorLogReader&) = delete;
+    SensorLogReader& operator=(const SensorLogReader&) = delete;
+
+    // @return 0 on success, -1 if the file cannot be opened.
+    int open(const std::string& filename);
+    void close();
+
+    bool is_open() const { return !filename_.empty(); }
+    const std::string& filename() const { return filename_; }
+    size_t size() const { return size_; }
+    size_t lines() const { return line_start_.empty() ? 0 : line_start_.size() - 1; }
+
+    // Line i without its newline
+    const char* line(size_t i, size_t* length) const;
+
+    /**
+     * Roll angles of lines [start, start + count), one [6] row per line that
+     * has six sensors, in recorded sensor order (lines without are skipped,
+     * as are lines past the end).
+     */
+    std::vector<std::vector<float>> roll_window(size_t start, size_t count) const;
+
+    // Whether open() used the sidecar index instead of scanning the log
+    bool index_loaded() const { return index_loaded_; }
+
+  private:
+    bool load_index(const std::string& path, uint64_t file_size, int64_t mtime_ns);
+    void build_index();
+    void save_index(const std::string& path, uint64_t file_size, int64_t mtime_ns) const;
+    bool parse_rolls(size_t i) const;
+
+    enum : uint8_t { ROLL_UNPARSED, ROLL_OK, ROLL_SKIP };
+
+    std::string filename_;
+    const char* data_;
+    size_t size_;
+    std::vector<uint64_t> line_start_;  // one per line plus the end of the data
+    mutable std::vector<std::array<float, 6>> rolls_;  // per line, filled on first use
+    mutable std::vector<uint8_t> roll_state_;
+    bool index_loaded_ = false;
+};
 
 
 /**
  * Parses roll angles from json .
- * 
+ *
+ * Keeps a SensorLogReader on the last file it was called with, so replaying
+ * a log window by window neither reopens nor rescans the file. A window
+ * past the end reopens the file if it has grown since.
+ *
  * @param filename Path to JSON file.
  * @param step_size Number of timesteps per chunk (i.e. read 30 lines per call).
  * @param chunk_index Index of the chunk to extract (index 1:0-30 entries. index 2: 31-60).
  * @return A vector of [step_size][6]
  */
-std::vector<std::vector<float>> get_sensor_data(const std::string &filename, int chunk_index, int step_size);
\ No newline at end of file
+std::vector<std::vector<float>> get_sensor_data(const std::string &filename, int chunk_index, int step_size);
+
+#endif // GET_SENSOR_DATA_H
@@ -0,0 +1,43 @@
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+
+#include "bno055.h"
+
+class I2CStats;
+
+/**
+ * @brief Register level I2C backend shared by the BNO055 driver code and the
+ * TCA9548A multiplexer.
+ *
+ * I2CDevBus talks to a real adapter through i2c-dev; SimulatedI2CBus models
+ * the multiplexer and sensors in software so the sensing path can run off-target.
+ * All calls return BNO055_SUCCESS or BNO055_ERROR.
+ */
+class I2CBus {
+  public:
+    virtual ~I2CBus() = default;
+
+    virtual int open() { return 0; }  // 0 on success, -1 on error
+    virtual bool is_open() const { return true; }
+
+    // Burst register access, one bus transaction per call
+    virtual s8 read(u8 dev_addr, u8 reg_addr, u8* reg_data, u8 cnt) = 0;
+    virtual s8 write(u8 dev_addr, u8 reg_addr, const u8* reg_data, u8 cnt) = 0;
+
+    // Register-less single byte access (TCA9548A control register)
+    virtual s8 send_byte(u8 dev_addr, u8 value) = 0;
+    virtual s8 receive_byte(u8 dev_addr, u8* value) = 0;
+
+    // Transaction histograms of this bus, nullptr when it keeps none
+    virtual I2CStats* io_stats() { return nullptr; }
+};
+
+// Process wide bus shared by the bno055_t bus callbacks and the multiplexer.
+// This is the /dev/i2c-1 adapter unless replaced with set_default_i2c_bus().
+I2CBus& default_i2c_bus();
+
+// Routes the default bus to another backend (e.g. a SimulatedI2CBus), nullptr
+// restores the i2c-dev adapter. Call before any sensor is initialised.
+void set_default_i2c_bus(I2CBus* bus);
+
+#endif // I2C_BUS_H
@@ -0,0 +1,148 @@
+#include "i2c_dev_bus.h"
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+I2CDevBus::I2CDevBus(const std::string& device)
+    : device_(device), fd_(-1), slave_addr_(-1), io_stats_(device) {}
+
+I2CDevBus::~I2CDevBus() {
+    close();
+}
+
+int I2CDevBus::open() {
+    if (fd_ != -1) return 0;
+    fd_ = ::open(device_.c_str(), O_RDWR);
+    if (fd_ == -1) return -1;
+    slave_addr_ = -1;
+    return 0;
+}
+
+void I2CDevBus::close() {
+    if (fd_ != -1) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+s8 I2CDevBus::read(u8 dev_addr, u8 reg_addr, u8* reg_data, u8 cnt) {
+    if (fd_ == -1) return BNO055_ERROR;
+
+    // Write the start register, then read cnt bytes after a repeated start
+    struct i2c_msg msgs[2];
+    msgs[0].addr  = dev_addr;
+    msgs[0].flags = 0;
+    msgs[0].len   = 1;
+    msgs[0].buf   = &reg_addr;
+    msgs[1].addr  = dev_addr;
+    msgs[1].flags = I2C_M_RD;
+    msgs[1].len   = cnt;
+    msgs[1].buf   = reg_data;
+
+    struct i2c_rdwr_ioctl_data xfer;
+    xfer.msgs  = msgs;
+    xfer.nmsgs = 2;
+
+    int64_t start = I2CStats::now_ns();
+    bool ok = ioctl(fd_, I2C_RDWR, &xfer) >= 0;
+    io_stats_.record(I2COp::READ, dev_addr, start, ok);
+    return ok ? BNO055_SUCCESS : BNO055_ERROR;
+}
+
+s8 I2CDevBus::write(u8 dev_addr, u8 reg_addr, const u8* reg_data, u8 cnt) {
+    if (fd_ == -1) return BNO055_ERROR;
+
+    // The BNO055 auto-increments the register address, so the whole payload
+    // goes out as one message: [reg_addr, data0, data1, ...]
+    u8 buf[1 + 255];
+    buf[0] = reg_addr;
+    std::memcpy(buf + 1, reg_data, cnt);
+
+    struct i2c_msg msg;
+    msg.addr  = dev_addr;
+    msg.flags = 0;
+    msg.len   = static_cast<u16>(cnt + 1);
+    msg.buf   = buf;
+
+    struct i2c_rdwr_ioctl_data xfer;
+    xfer.msgs  = &msg;
+    xfer.nmsgs = 1;
+
+    int64_t start = I2CStats::now_ns();
+    bool ok = ioctl(fd_, I2C_RDWR, &xfer) >= 0;
+    io_stats_.record(I2COp::WRITE, dev_addr, start, ok);
+    return ok ? BNO055_SUCCESS : BNO055_ERROR;
+}
+
+s8 I2CDevBus::send_byte(u8 dev_addr, u8 value) {
+    if (fd_ == -1) return BNO055_ERROR;
+
+    struct i2c_msg msg;
+    msg.addr  = dev_addr;
+    msg.flags = 0;
+    msg.len   = 1;
+    msg.buf   = &value;
+
+    struct i2c_rdwr_ioctl_data xfer;
+    xfer.msgs  = &msg;
+    xfer.nmsgs = 1;
+
+    if (ioctl(fd_, I2C_RDWR, &xfer) < 0) return BNO055_ERROR;
+    return BNO055_SUCCESS;
+}
+
+s8 I2CDevBus::receive_byte(u8 dev_addr, u8* value) {
+    if (fd_ == -1) return BNO055_ERROR;
+
+    struct i2c_msg msg;
+    msg.addr  = dev_addr;
+    msg.flags = I2C_M_RD;
+    msg.len   = 1;
+    msg.buf   = value;
+
+    struct i2c_rdwr_ioctl_data xfer;
+    xfer.msgs  = &msg;
+    xfer.nmsgs = 1;
+
+    if (ioctl(fd_, I2C_RDWR, &xfer) < 0) return BNO055_ERROR;
+    return BNO055_SUCCESS;
+}
+
+int I2CDevBus::select_slave(u8 dev_addr) {
+    if (slave_addr_ == dev_addr) return 0;
+    if (ioctl(fd_, I2C_SLAVE, dev_addr) < 0) return -1;
+    slave_addr_ = dev_addr;
+    return 0;
+}
+
+s8 I2CDevBus::read_bytewise(u8 dev_addr, u8 reg_addr, u8* reg_data, u8 cnt) {
+    if (fd_ == -1 || select_slave(dev_addr) != 0) return BNO055_ERROR;
+
+    for (int i = 0; i < cnt; i++) {
+        union i2c_smbus_data data;
+        struct i2c_smbus_ioctl_data args;
+        args.read_write = I2C_SMBUS_READ;
+        args.command    = static_cast<u8>(reg_addr + i);
+        args.size       = I2C_SMBUS_BYTE_DATA;
+        args.data       = &data;
+
+        if (ioctl(fd_, I2C_SMBUS, &args) < 0) return BNO055_ERROR;
+        reg_data[i] = data.byte;
+    }
+    return BNO055_SUCCESS;
+}
+
+static I2CBus* default_bus_override = nullptr;
+
+I2CBus& default_i2c_bus() {
+    static I2CDevBus bus;
+    if (default_bus_override != nullptr) return *default_bus_override;
+    return bus;
+}
+
+void set_default_i2c_bus(I2CBus* bus) {
+    default_bus_override = bus;
+}
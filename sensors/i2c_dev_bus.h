@@ -0,0 +1,54 @@
+#ifndef I2C_DEV_BUS_H
+#define I2C_DEV_BUS_H
+
+#include <string>
+#include "i2c_bus.h"
+#include "i2c_stats.h"
+
+/**
+ * @brief Linux i2c-dev adapter (e.g. /dev/i2c-1) used as the BNO055 bus backend.
+ *
+ * Register reads are issued as a single I2C_RDWR combined transaction
+ * (register address write, repeated start, N byte read), so a 6 byte Euler
+ * read costs one syscall and one bus transaction instead of six.
+ * The slave address is carried in every message, so one open adapter can
+ * talk to the multiplexer and every sensor behind it.
+ */
+class I2CDevBus : public I2CBus {
+  public:
+    explicit I2CDevBus(const std::string& device = "/dev/i2c-1");
+    ~I2CDevBus();
+
+    I2CDevBus(const I2CDevBus&) = delete;
+    I2CDevBus& operator=(const I2CDevBus&) = delete;
+
+    int open() override;   // 0 on success, -1 on error
+    void close();
+    bool is_open() const override { return fd_ != -1; }
+    int fd() const { return fd_; }
+    const std::string& device() const { return device_; }
+
+    // Burst register access, one bus transaction per call
+    s8 read(u8 dev_addr, u8 reg_addr, u8* reg_data, u8 cnt) override;
+    s8 write(u8 dev_addr, u8 reg_addr, const u8* reg_data, u8 cnt) override;
+
+    // Register-less single byte access (TCA9548A control register)
+    s8 send_byte(u8 dev_addr, u8 value) override;
+    s8 receive_byte(u8 dev_addr, u8* value) override;
+
+    // Legacy path: one SMBus read-byte-data transaction per register, the
+    // same pattern as wiringPiI2CReadReg8. Kept as a benchmark reference.
+    s8 read_bytewise(u8 dev_addr, u8 reg_addr, u8* reg_data, u8 cnt);
+
+    I2CStats* io_stats() override { return &io_stats_; }
+
+  private:
+    int select_slave(u8 dev_addr);
+
+    std::string device_;
+    int fd_;
+    int slave_addr_;  // address last set with I2C_SLAVE, -1 if none
+    I2CStats io_stats_;
+};
+
+#endif // I2C_DEV_BUS_H
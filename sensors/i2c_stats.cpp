@@ -0,0 +1,168 @@
+#include "i2c_stats.h"
+#include <algorithm>
+#include <csignal>
+#include <iomanip>
+#include <mutex>
+#include <vector>
+#include <time.h>
+
+const char* i2c_op_name(I2COp op) {
+    switch (op) {
+        case I2COp::MUX_SWITCH: return "mux";
+        case I2COp::READ:       return "read";
+        case I2COp::WRITE:      return "write";
+    }
+    return "?";
+}
+
+void LatencyHistogram::record(int64_t ns, bool ok) {
+    uint64_t value = ns > 0 ? static_cast<uint64_t>(ns) : 0;
+    uint64_t us = value / 1000;
+    size_t bucket = 0;
+    while (bucket + 1 < BUCKETS && us >= bucket_upper_us(bucket)) bucket++;
+
+    count.fetch_add(1, std::memory_order_relaxed);
+    if (!ok) errors.fetch_add(1, std::memory_order_relaxed);
+    total_ns.fetch_add(value, std::memory_order_relaxed);
+    buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t seen = max_ns.load(std::memory_order_relaxed);
+    while (value > seen && !max_ns.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {}
+}
+
+void LatencyHistogram::reset() {
+    count.store(0, std::memory_order_relaxed);
+    errors.store(0, std::memory_order_relaxed);
+    total_ns.store(0, std::memory_order_relaxed);
+    max_ns.store(0, std::memory_order_relaxed);
+    for (auto& b : buckets) b.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::quantile_us(double q) const {
+    uint64_t n = count.load(std::memory_order_relaxed);
+    if (n == 0) return 0;
+    uint64_t wanted = static_cast<uint64_t>(q * n);
+    uint64_t seen = 0;
+    for (size_t b = 0; b < BUCKETS; b++) {
+        seen += buckets[b].load(std::memory_order_relaxed);
+        if (seen > wanted) return bucket_upper_us(b);
+    }
+    return bucket_upper_us(BUCKETS - 1);
+}
+
+#ifdef EXO_I2C_STATS
+
+// Buses that exist right now, for dumps
+static std::mutex registry_mutex;
+static std::vector<I2CStats*> registry;
+
+I2CStats::I2CStats(std::string bus_name) : bus_name_(std::move(bus_name)), channel_(NO_CHANNEL) {
+    for (auto& row : devices_) {
+        for (auto& dev : row) dev.store(nullptr, std::memory_order_relaxed);
+    }
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    registry.push_back(this);
+}
+
+I2CStats::~I2CStats() {
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        registry.erase(std::remove(registry.begin(), registry.end(), this), registry.end());
+    }
+    for (auto& row : devices_) {
+        for (auto& dev : row) delete dev.load(std::memory_order_relaxed);
+    }
+}
+
+int64_t I2CStats::now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+I2CStats::Device* I2CStats::device(int channel, u8 dev_addr) {
+    std::atomic<Device*>& slot = devices_[channel][dev_addr & 0x7F];
+    Device* dev = slot.load(std::memory_order_acquire);
+    if (dev != nullptr) return dev;
+
+    // First transaction with this device; another thread may race us to it
+    Device* fresh = new Device();
+    if (slot.compare_exchange_strong(dev, fresh, std::memory_order_acq_rel)) return fresh;
+    delete fresh;
+    return dev;
+}
+
+void I2CStats::record(I2COp op, int channel, u8 dev_addr, int64_t start_ns, bool ok) {
+    if (channel < 0 || channel >= static_cast<int>(CHANNELS)) channel = NO_CHANNEL;
+    device(channel, dev_addr)->ops[static_cast<size_t>(op)].record(now_ns() - start_ns, ok);
+}
+
+const LatencyHistogram* I2CStats::histogram(int channel, u8 dev_addr, I2COp op) const {
+    if (channel < 0 || channel >= static_cast<int>(CHANNELS)) channel = NO_CHANNEL;
+    const Device* dev = devices_[channel][dev_addr & 0x7F].load(std::memory_order_acquire);
+    if (dev == nullptr) return nullptr;
+    const LatencyHistogram& h = dev->ops[static_cast<size_t>(op)];
+    return h.count.load(std::memory_order_relaxed) > 0 ? &h : nullptr;
+}
+
+void I2CStats::dump(std::ostream& out) const {
+    out << "I2C " << bus_name_ << std::endl;
+    for (size_t ch = 0; ch < CHANNELS; ch++) {
+        for (int addr = 0; addr < 128; addr++) {
+            for (size_t op = 0; op < I2C_OP_COUNT; op++) {
+                const LatencyHistogram* h = histogram(static_cast<int>(ch), static_cast<u8>(addr),
+                                                      static_cast<I2COp>(op));
+                if (h == nullptr) continue;
+
+                uint64_t n = h->count.load(std::memory_order_relaxed);
+                out << "  " << (ch == NO_CHANNEL ? std::string("  -") : "ch" + std::to_string(ch))
+                    << " 0x" << std::hex << std::setw(2) << std::setfill('0') << addr
+                    << std::dec << std::setfill(' ') << " " << std::left << std::setw(5)
+                    << i2c_op_name(static_cast<I2COp>(op)) << std::right
+                    << " n=" << n << " err=" << h->errors.load(std::memory_order_relaxed)
+                    << " mean=" << h->total_ns.load(std::memory_order_relaxed) / n / 1000 << "us"
+                    << " p50<" << h->quantile_us(0.50) << "us"
+                    << " p99<" << h->quantile_us(0.99) << "us"
+                    << " max=" << h->max_ns.load(std::memory_order_relaxed) / 1000 << "us" << std::endl;
+            }
+        }
+    }
+}
+
+void I2CStats::reset() {
+    for (auto& row : devices_) {
+        for (auto& slot : row) {
+            Device* dev = slot.load(std::memory_order_acquire);
+            if (dev == nullptr) continue;
+            for (auto& h : dev->ops) h.reset();
+        }
+    }
+}
+
+void i2c_stats_dump(std::ostream& out) {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    for (const I2CStats* stats : registry) stats->dump(out);
+}
+
+#else
+
+void i2c_stats_dump(std::ostream&) {}
+
+#endif  // EXO_I2C_STATS
+
+static volatile std::sig_atomic_t dump_requested = 0;
+
+static void request_dump(int) {
+    dump_requested = 1;
+}
+
+void i2c_stats_install_signal() {
+    std::signal(SIGUSR1, request_dump);
+}
+
+bool i2c_stats_poll(std::ostream& out) {
+    if (!dump_requested) return false;
+    dump_requested = 0;
+    i2c_stats_dump(out);
+    return true;
+}
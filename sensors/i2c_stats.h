@@ -0,0 +1,126 @@
+#ifndef I2C_STATS_H
+#define I2C_STATS_H
+
+#include <stdint.h>
+#include <atomic>
+#include <ostream>
+#include <string>
+#include "bno055.h"
+
+/**
+ * I2C transaction instrumentation.
+ *
+ * Every bus keeps latency histograms and error counts per device (mux channel
+ * + address) and per operation. Recording is a clock read and a few relaxed
+ * atomic increments; a report can be taken from any thread while the buses
+ * are in use. Built without EXO_I2C_STATS the same API compiles to nothing.
+ */
+
+enum class I2COp : uint8_t {
+    MUX_SWITCH,  // TCA9548A channel change, settle time and read-back included
+    READ,        // register burst read
+    WRITE,       // register burst write
+};
+constexpr size_t I2C_OP_COUNT = 3;
+
+const char* i2c_op_name(I2COp op);
+
+/**
+ * @brief Log2 latency histogram, bucket b holds [2^(b-1), 2^b) microseconds
+ * (bucket 0 everything under 1 us, the last one everything above).
+ */
+struct LatencyHistogram {
+    static constexpr size_t BUCKETS = 20;
+
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> errors{0};
+    std::atomic<uint64_t> total_ns{0};
+    std::atomic<uint64_t> max_ns{0};
+    std::atomic<uint64_t> buckets[BUCKETS] = {};
+
+    void record(int64_t ns, bool ok);
+    void reset();
+
+    // Upper bound of the bucket holding quantile q (0-1), in microseconds
+    uint64_t quantile_us(double q) const;
+    static uint64_t bucket_upper_us(size_t bucket) { return 1ull << bucket; }
+};
+
+#ifdef EXO_I2C_STATS
+
+/**
+ * @brief Histograms of one bus, registered for dumps while it exists.
+ */
+class I2CStats {
+  public:
+    static constexpr bool enabled = true;
+    static constexpr int NO_CHANNEL = 8;  // directly on the bus, or no mux channel open
+
+    explicit I2CStats(std::string bus_name);
+    ~I2CStats();
+
+    I2CStats(const I2CStats&) = delete;
+    I2CStats& operator=(const I2CStats&) = delete;
+
+    static int64_t now_ns();
+
+    // Transaction with dev_addr that started at start_ns, attributed to the
+    // mux channel that is open (see set_channel())
+    void record(I2COp op, u8 dev_addr, int64_t start_ns, bool ok) {
+        record(op, channel_.load(std::memory_order_relaxed), dev_addr, start_ns, ok);
+    }
+    void record(I2COp op, int channel, u8 dev_addr, int64_t start_ns, bool ok);
+
+    // Mux channel the next transactions go through, -1 for none
+    void set_channel(int channel) {
+        channel_.store(channel < 0 || channel > 7 ? NO_CHANNEL : channel, std::memory_order_relaxed);
+    }
+
+    // nullptr until the device saw its first transaction of that kind
+    const LatencyHistogram* histogram(int channel, u8 dev_addr, I2COp op) const;
+
+    const std::string& bus_name() const { return bus_name_; }
+    void dump(std::ostream& out) const;
+    void reset();
+
+  private:
+    static constexpr size_t CHANNELS = 9;  // mux channels 0-7 + NO_CHANNEL
+    struct Device {
+        LatencyHistogram ops[I2C_OP_COUNT];
+    };
+
+    Device* device(int channel, u8 dev_addr);
+
+    std::string bus_name_;
+    std::atomic<int> channel_;
+    std::atomic<Device*> devices_[CHANNELS][128];  // allocated on first use
+};
+
+#else
+
+class I2CStats {
+  public:
+    static constexpr bool enabled = false;
+    static constexpr int NO_CHANNEL = 8;
+
+    explicit I2CStats(const std::string&) {}
+    static int64_t now_ns() { return 0; }
+    void record(I2COp, u8, int64_t, bool) {}
+    void record(I2COp, int, u8, int64_t, bool) {}
+    void set_channel(int) {}
+    const LatencyHistogram* histogram(int, u8, I2COp) const { return nullptr; }
+    void dump(std::ostream&) const {}
+    void reset() {}
+};
+
+#endif  // EXO_I2C_STATS
+
+// Report of every bus that currently exists
+void i2c_stats_dump(std::ostream& out);
+
+// SIGUSR1 asks for a report. The handler only sets a flag, the report is
+// written by the next i2c_stats_poll() outside of signal context.
+void i2c_stats_install_signal();
+bool i2c_stats_poll(std::ostream& out);
+
+#endif // I2C_STATS_H
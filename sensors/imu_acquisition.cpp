@@ -0,0 +1,84 @@
+#include "imu_acquisition.h"
+#include <cerrno>
+#include <iostream>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+static const int64_t NSEC_PER_SEC = 1000000000LL;
+
+int64_t monotonic_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+int64_t realtime_offset_ns() {
+    struct timespec real;
+    clock_gettime(CLOCK_REALTIME, &real);
+    return static_cast<int64_t>(real.tv_sec) * NSEC_PER_SEC + real.tv_nsec - monotonic_ns();
+}
+
+static void sleep_until_ns(int64_t deadline_ns) {
+    struct timespec ts;
+    ts.tv_sec  = deadline_ns / NSEC_PER_SEC;
+    ts.tv_nsec = deadline_ns % NSEC_PER_SEC;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {}
+}
+
+ImuAcquisition::ImuAcquisition(SweepFn sweep, std::chrono::microseconds period, int cpu)
+    : sweep_(std::move(sweep)), period_(period), cpu_(cpu) {}
+
+ImuAcquisition::~ImuAcquisition() {
+    stop();
+}
+
+bool ImuAcquisition::start() {
+    if (running()) return true;
+    running_.store(true, std::memory_order_release);
+    thread_ = std::thread(&ImuAcquisition::run, this);
+
+    if (cpu_ >= 0) {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(cpu_, &cpuset);
+        if (pthread_setaffinity_np(thread_.native_handle(), sizeof(cpuset), &cpuset) != 0) {
+            std::cerr << "Failed to pin IMU acquisition thread to CPU " << cpu_ << std::endl;
+        }
+    }
+    return true;
+}
+
+void ImuAcquisition::stop() {
+    running_.store(false, std::memory_order_release);
+    if (thread_.joinable()) thread_.join();
+}
+
+void ImuAcquisition::run() {
+    const int64_t period_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(period_).count();
+    int64_t deadline = monotonic_ns();
+    uint64_t sequence = 0;
+
+    while (running()) {
+        ImuFrame frame{};
+        frame.sequence = sequence++;
+        frame.timestamp_ns = monotonic_ns();
+        sweep_(frame);
+
+        if (ring_.push(frame)) {
+            published_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        deadline += period_ns;
+        int64_t now = monotonic_ns();
+        if (now > deadline) {
+            // Sweep ran past its slot: count it and re-anchor instead of bursting to catch up
+            overruns_.fetch_add(1, std::memory_order_relaxed);
+            deadline = now;
+            continue;
+        }
+        sleep_until_ns(deadline);
+    }
+}
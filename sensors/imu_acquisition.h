@@ -0,0 +1,96 @@
+#ifndef IMU_ACQUISITION_H
+#define IMU_ACQUISITION_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include "spsc_ring.h"
+
+constexpr size_t IMU_CHANNELS = 6;
+
+/**
+ * @brief One sweep over all IMUs, in sensorLocations order.
+ */
+struct ImuFrame {
+    uint64_t sequence;      // sweep counter, gaps mean dropped frames
+    int64_t timestamp_ns;   // CLOCK_MONOTONIC at the start of the sweep
+    int16_t roll[IMU_CHANNELS];  // raw BNO055 roll, 1/16 degree
+    int64_t sample_ns[IMU_CHANNELS];  // CLOCK_MONOTONIC at the middle of channel i's read
+    uint8_t valid_mask;     // bit i set when channel i was read successfully
+    uint8_t substituted_mask;  // bit i set when roll[i] is a stand-in for a failed sensor
+    uint8_t fresh_mask;     // bit i set when channel i was read in this sweep; a valid
+                            // channel without it carries an earlier sweep's sample
+};
+
+// Raw BNO055 Euler LSBs per degree
+constexpr float ROLL_LSB_PER_DEG = 16.0f;
+
+inline float roll_deg(const ImuFrame& frame, size_t channel) {
+    return frame.roll[channel] / ROLL_LSB_PER_DEG;
+}
+
+// How old channel i's value was at the start of the sweep, 0 for this sweep's reads
+inline int64_t sample_age_ns(const ImuFrame& frame, size_t channel) {
+    int64_t age = frame.timestamp_ns - frame.sample_ns[channel];
+    return age > 0 ? age : 0;
+}
+
+// CLOCK_MONOTONIC in nanoseconds
+int64_t monotonic_ns();
+
+// CLOCK_REALTIME minus CLOCK_MONOTONIC right now: added to a monotonic_ns()
+// time it gives epoch time, as long as the wall clock is not stepped
+int64_t realtime_offset_ns();
+
+/**
+ * @brief Runs the mux/BNO055 sweep on its own thread at a fixed rate and
+ * publishes frames to the control loop through a wait-free SPSC ring.
+ *
+ * The sweep function fills roll/sample_ns/valid_mask; sequence and timestamp
+ * are set by the engine. The controller drains frames with pop(), which never blocks.
+ */
+class ImuAcquisition {
+  public:
+    using SweepFn = std::function<void(ImuFrame&)>;
+    static constexpr size_t RING_CAPACITY = 64;
+
+    /**
+     * @param sweep  Reads every sensor once into the frame.
+     * @param period Sweep period (e.g. 100 ms).
+     * @param cpu    Core to pin the acquisition thread to, -1 to leave unpinned.
+     */
+    ImuAcquisition(SweepFn sweep, std::chrono::microseconds period, int cpu = -1);
+    ~ImuAcquisition();
+
+    ImuAcquisition(const ImuAcquisition&) = delete;
+    ImuAcquisition& operator=(const ImuAcquisition&) = delete;
+
+    bool start();
+    void stop();
+    bool running() const { return running_.load(std::memory_order_acquire); }
+
+    // Consumer side, call from the control thread only
+    bool pop(ImuFrame& frame) { return ring_.pop(frame); }
+
+    uint64_t frames_published() const { return published_.load(std::memory_order_relaxed); }
+    uint64_t overruns() const { return overruns_.load(std::memory_order_relaxed); }
+    uint64_t dropped_frames() const { return dropped_.load(std::memory_order_relaxed); }
+
+  private:
+    void run();
+
+    SweepFn sweep_;
+    std::chrono::microseconds period_;
+    int cpu_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    SpscRing<ImuFrame, RING_CAPACITY> ring_;
+
+    std::atomic<uint64_t> published_{0};
+    std::atomic<uint64_t> overruns_{0};  // sweeps that ran past their deadline
+    std::atomic<uint64_t> dropped_{0};   // frames lost because the ring was full
+};
+
+#endif // IMU_ACQUISITION_H
@@ -0,0 +1,345 @@
+#include "imu_jsonl_scan.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Nesting the scanner follows before it gives up on a line
+static const int MAX_DEPTH = 32;
+
+// Powers of ten a double holds exactly
+static const double POW10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                               1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+namespace {
+
+struct Cursor {
+    const char* p;
+    const char* end;
+
+    void skip_ws() {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) p++;
+    }
+    bool consume(char c) {
+        skip_ws();
+        if (p < end && *p == c) {
+            p++;
+            return true;
+        }
+        return false;
+    }
+    bool peek(char c) {
+        skip_ws();
+        return p < end && *p == c;
+    }
+};
+
+// Raw string contents between the quotes, escapes left as they are
+bool read_string(Cursor& c, const char** text, size_t* size) {
+    if (!c.consume('"')) return false;
+    const char* start = c.p;
+    while (c.p < c.end && *c.p != '"') {
+        if (*c.p == '\\') c.p++;
+        c.p++;
+    }
+    if (c.p >= c.end) return false;
+    *text = start;
+    *size = static_cast<size_t>(c.p - start);
+    c.p++;
+    return true;
+}
+
+bool read_number(Cursor& c, double* value) {
+    c.skip_ws();
+    const char* start = c.p;
+    bool negative = c.p < c.end && *c.p == '-';
+    if (negative) c.p++;
+
+    uint64_t mantissa = 0;
+    int digits = 0, exponent = 0;
+    for (; c.p < c.end && *c.p >= '0' && *c.p <= '9'; c.p++, digits++) mantissa = mantissa * 10 + (*c.p - '0');
+    if (c.p < c.end && *c.p == '.') {
+        for (c.p++; c.p < c.end && *c.p >= '0' && *c.p <= '9'; c.p++, digits++, exponent--) {
+            mantissa = mantissa * 10 + (*c.p - '0');
+        }
+    }
+    if (digits == 0) return false;
+    if (c.p < c.end && (*c.p == 'e' || *c.p == 'E')) {
+        c.p++;
+        bool negative_exp = c.p < c.end && *c.p == '-';
+        if (c.p < c.end && (*c.p == '-' || *c.p == '+')) c.p++;
+        int e = 0;
+        for (; c.p < c.end && *c.p >= '0' && *c.p <= '9'; c.p++) e = std::min(e * 10 + (*c.p - '0'), 10000);
+        exponent += negative_exp ? -e : e;
+    }
+
+    // Exact mantissa and power of ten: one rounding, same as strtod
+    if (digits <= 19 && mantissa <= (1ull << 53) && exponent >= -22 && exponent <= 22) {
+        double v = static_cast<double>(mantissa);
+        v = exponent < 0 ? v / POW10[-exponent] : v * POW10[exponent];
+        *value = negative ? -v : v;
+        return true;
+    }
+
+    // Long mantissas (17 significant digits turn up in Python dumps)
+    char buffer[64];
+    size_t size = static_cast<size_t>(c.p - start);
+    if (size >= sizeof(buffer)) return false;
+    std::memcpy(buffer, start, size);
+    buffer[size] = '\0';
+    *value = std::strtod(buffer, nullptr);
+    return true;
+}
+
+bool skip_value(Cursor& c, int depth);
+
+bool skip_container(Cursor& c, char close, bool keys, int depth) {
+    if (depth > MAX_DEPTH) return false;
+    c.p++;  // the opening bracket
+    if (c.consume(close)) return true;
+    do {
+        if (keys) {
+            const char* key;
+            size_t key_size;
+            if (!read_string(c, &key, &key_size) || !c.consume(':')) return false;
+        }
+        if (!skip_value(c, depth + 1)) return false;
+    } while (c.consume(','));
+    return c.consume(close);
+}
+
+bool skip_value(Cursor& c, int depth) {
+    c.skip_ws();
+    if (c.p >= c.end) return false;
+    switch (*c.p) {
+        case '{': return skip_container(c, '}', true, depth);
+        case '[': return skip_container(c, ']', false, depth);
+        case '"': {
+            const char* text;
+            size_t size;
+            return read_string(c, &text, &size);
+        }
+        case 't': case 'f': case 'n':
+            while (c.p < c.end && *c.p >= 'a' && *c.p <= 'z') c.p++;
+            return true;
+        default: {
+            double v;
+            return read_number(c, &v);
+        }
+    }
+}
+
+bool key_is(const char* key, size_t size, const char* name) {
+    return std::strlen(name) == size && std::memcmp(key, name, size) == 0;
+}
+
+// Calls fn(key, size) for every member with the cursor on its value; fn must consume the value
+template <typename Fn>
+bool for_each_member(Cursor& c, Fn fn) {
+    if (!c.consume('{')) return false;
+    if (c.consume('}')) return true;
+    do {
+        const char* key;
+        size_t size;
+        if (!read_string(c, &key, &size) || !c.consume(':') || !fn(key, size)) return false;
+    } while (c.consume(','));
+    return c.consume('}');
+}
+
+// Days since 1970-01-01 of a proleptic Gregorian date
+int64_t days_from_civil(int64_t y, int64_t m, int64_t d) {
+    y -= m <= 2;
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    int64_t yoe = y - era * 400;
+    int64_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+bool read_int(const char*& p, const char* end, int64_t* value) {
+    const char* start = p;
+    int64_t v = 0;
+    for (; p < end && *p >= '0' && *p <= '9' && p - start < 10; p++) v = v * 10 + (*p - '0');
+    *value = v;
+    return p > start;
+}
+
+// "YYYY-MM-DD HH:MM:SS.fff", the same reading as parse_log_timestamp()
+bool parse_timestamp(const char* p, const char* end, int64_t* ns) {
+    int64_t year, month, day, hour, minute, second, fraction = 0;
+    if (!read_int(p, end, &year) || p >= end || *p++ != '-' || !read_int(p, end, &month) ||
+        p >= end || *p++ != '-' || !read_int(p, end, &day) || p >= end || *p++ != ' ' ||
+        !read_int(p, end, &hour) || p >= end || *p++ != ':' || !read_int(p, end, &minute) ||
+        p >= end || *p++ != ':' || !read_int(p, end, &second)) {
+        return false;
+    }
+    if (p < end && *p == '.') {
+        int digits = 0;
+        for (p++; p < end && *p >= '0' && *p <= '9'; p++, digits++) {
+            if (digits < 9) fraction = fraction * 10 + (*p - '0');
+        }
+        for (; digits < 9; digits++) fraction *= 10;
+    }
+    int64_t seconds = days_from_civil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+    *ns = seconds * 1000000000LL + fraction;
+    return true;
+}
+
+bool read_euler(Cursor& c, uint32_t fields, ImuJsonLine::Sensor& sensor) {
+    return for_each_member(c, [&](const char* key, size_t size) {
+        float* target = nullptr;
+        if ((fields & IMU_JSON_ROLL) && key_is(key, size, "roll")) target = &sensor.roll;
+        else if ((fields & IMU_JSON_HEADING) && key_is(key, size, "heading")) target = &sensor.heading;
+        else if ((fields & IMU_JSON_PITCH) && key_is(key, size, "pitch")) target = &sensor.pitch;
+        if (target == nullptr) return skip_value(c, 2);
+
+        double v;
+        if (!read_number(c, &v)) return false;
+        *target = static_cast<float>(v);
+        return true;
+    });
+}
+
+bool read_sensors(Cursor& c, uint32_t fields, ImuJsonLine& line) {
+    if (!c.consume('[')) return false;
+    if (c.consume(']')) return true;
+    do {
+        ImuJsonLine::Sensor scratch;
+        ImuJsonLine::Sensor& sensor = line.sensors < ImuJsonLine::MAX_SENSORS ? line.sensor[line.sensors] : scratch;
+        sensor = ImuJsonLine::Sensor{"", 0, 0.0f, 0.0f, 0.0f, false};
+        bool ok = for_each_member(c, [&](const char* key, size_t size) {
+            if (key_is(key, size, "location")) return read_string(c, &sensor.location, &sensor.location_size);
+            if (key_is(key, size, "euler") && c.peek('{')) {
+                sensor.has_euler = true;
+                return read_euler(c, fields, sensor);
+            }
+            return skip_value(c, 2);
+        });
+        if (!ok) return false;
+        if (line.sensors < ImuJsonLine::MAX_SENSORS) line.sensors++;
+    } while (c.consume(','));
+    return c.consume(']');
+}
+
+}  // namespace
+
+bool ImuJsonLine::is_location(size_t i, const std::string& name) const {
+    return sensor[i].location_size == name.size() &&
+           std::memcmp(sensor[i].location, name.data(), name.size()) == 0;
+}
+
+bool scan_imu_json_line(const char* begin, const char* end, uint32_t fields, ImuJsonLine& line) {
+    line.has_timestamp = false;
+    line.timestamp_ns = 0;
+    line.sensors = 0;
+
+    bool has_sensors = false;
+    Cursor c{begin, end};
+    if (!c.peek('{')) return false;
+    bool ok = for_each_member(c, [&](const char* key, size_t size) {
+        if (key_is(key, size, "sensors") && c.peek('[')) {
+            has_sensors = true;
+            return read_sensors(c, fields, line);
+        }
+        if ((fields & IMU_JSON_TIMESTAMP) && key_is(key, size, "timestamp") && c.peek('"')) {
+            const char* text;
+            size_t text_size;
+            if (!read_string(c, &text, &text_size)) return false;
+            line.has_timestamp = parse_timestamp(text, text + text_size, &line.timestamp_ns);
+            return true;
+        }
+        return skip_value(c, 1);
+    });
+    return ok && has_sensors;
+}
+
+ImuJsonlScanner::ImuJsonlScanner(std::vector<std::string> locations, uint32_t fields, int64_t default_period_ns)
+    : locations_(std::move(locations)), fields_(fields), default_period_ns_(default_period_ns) {
+    if (locations_.size() > 8) locations_.resize(8);  // valid_mask is 8 bits
+}
+
+void ImuJsonlScanner::prepare(ImuJsonlColumns& columns, size_t frames) const {
+    columns = ImuJsonlColumns();
+    columns.locations = locations_;
+    columns.timestamp_ns.reserve(frames);
+    columns.valid_mask.reserve(frames);
+    auto column = [&](uint32_t field, std::vector<std::vector<float>>& out) {
+        if (!(fields_ & field)) return;
+        out.resize(locations_.size());
+        for (auto& c : out) c.reserve(frames);
+    };
+    column(IMU_JSON_HEADING, columns.heading);
+    column(IMU_JSON_ROLL, columns.roll);
+    column(IMU_JSON_PITCH, columns.pitch);
+}
+
+size_t ImuJsonlScanner::scan(const char* data, size_t size, ImuJsonlColumns& columns) const {
+    if (columns.locations != locations_) prepare(columns, 0);
+
+    const char* end = data + size;
+    size_t appended = 0;
+    ImuJsonLine line;
+    for (const char* p = data; p < end;) {
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        const char* line_end = nl != nullptr ? nl : end;
+        bool scanned = scan_imu_json_line(p, line_end, fields_, line);
+        p = nl != nullptr ? nl + 1 : end;
+        if (!scanned) continue;
+
+        // Recorded time when it parses, else one period after the previous frame
+        int64_t t = columns.frames() == 0 ? 0 : columns.timestamp_ns.back() + default_period_ns_;
+        if (line.has_timestamp) t = line.timestamp_ns;
+        columns.timestamp_ns.push_back(t);
+
+        uint8_t valid = 0;
+        for (auto* column : {&columns.heading, &columns.roll, &columns.pitch}) {
+            for (auto& c : *column) c.push_back(0.0f);
+        }
+        for (size_t s = 0; s < line.sensors; s++) {
+            if (!line.sensor[s].has_euler) continue;
+            for (size_t ch = 0; ch < locations_.size(); ch++) {
+                if (!line.is_location(s, locations_[ch])) continue;
+                if (!columns.heading.empty()) columns.heading[ch].back() = line.sensor[s].heading;
+                if (!columns.roll.empty()) columns.roll[ch].back() = line.sensor[s].roll;
+                if (!columns.pitch.empty()) columns.pitch[ch].back() = line.sensor[s].pitch;
+                valid |= static_cast<uint8_t>(1u << ch);
+                break;
+            }
+        }
+        columns.valid_mask.push_back(valid);
+        appended++;
+    }
+    return appended;
+}
+
+int ImuJsonlScanner::scan_file(const std::string& path, ImuJsonlColumns& columns) const {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        std::cerr << "Failed to open " << path << std::endl;
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    // Recordings run 500-800 bytes per line; reserving avoids regrowing the columns
+    prepare(columns, size / 400 + 1);
+    if (size == 0) {
+        ::close(fd);
+        return 0;
+    }
+
+    void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) return -1;
+    madvise(map, size, MADV_SEQUENTIAL);
+    scan(static_cast<const char*>(map), size, columns);
+    munmap(map, size);
+    return 0;
+}
@@ -0,0 +1,99 @@
+#ifndef IMU_JSONL_SCAN_H
+#define IMU_JSONL_SCAN_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+ * Streaming extraction of IMU JSON lines (imu_data.json, joint_data.json,
+ * the treadmill recordings):
+ *
+ *   {"sensors": [{"euler": {"heading": h, "roll": r, "pitch": p}, "location": "Left Hip"}, ...],
+ *    "timestamp": "YYYY-MM-DD HH:MM:SS.mmm"}
+ *
+ * A purpose-built scanner walks each line once and pulls only the requested
+ * fields; everything else is skipped without being decoded. Nothing is
+ * allocated per line: a line is scanned into a fixed-size ImuJsonLine, and
+ * ImuJsonlScanner appends whole files to preallocated columns.
+ */
+
+enum ImuJsonField : uint32_t {
+    IMU_JSON_TIMESTAMP = 1u << 0,
+    IMU_JSON_HEADING   = 1u << 1,
+    IMU_JSON_ROLL      = 1u << 2,
+    IMU_JSON_PITCH     = 1u << 3,
+
+    IMU_JSON_EULER = IMU_JSON_HEADING | IMU_JSON_ROLL | IMU_JSON_PITCH,
+    IMU_JSON_ALL   = IMU_JSON_TIMESTAMP | IMU_JSON_EULER
+};
+
+/**
+ * @brief One scanned line. Strings point into the scanned text.
+ */
+struct ImuJsonLine {
+    static constexpr size_t MAX_SENSORS = 16;
+
+    struct Sensor {
+        const char* location;   // raw, escapes not decoded
+        size_t location_size;
+        float heading, roll, pitch;  // degrees, 0 when not requested or missing
+        bool has_euler;
+    };
+
+    bool has_timestamp;
+    int64_t timestamp_ns;   // see parse_log_timestamp()
+    size_t sensors;         // in recorded order, extra ones beyond MAX_SENSORS dropped
+    Sensor sensor[MAX_SENSORS];
+
+    bool is_location(size_t i, const std::string& name) const;
+};
+
+/**
+ * Scans one line (without its newline).
+ *
+ * @return false if the line is not a JSON object with a "sensors" array.
+ */
+bool scan_imu_json_line(const char* begin, const char* end, uint32_t fields, ImuJsonLine& line);
+
+/**
+ * @brief Per-channel columns of a recording, sensors mapped to channels by
+ * location name.
+ */
+struct ImuJsonlColumns {
+    std::vector<std::string> locations;
+    std::vector<int64_t> timestamp_ns;       // per frame, spaced by the default period where missing
+    std::vector<uint8_t> valid_mask;         // bit c set when channel c was in the line
+    std::vector<std::vector<float>> heading; // [channel][frame], only the requested quantities
+    std::vector<std::vector<float>> roll;
+    std::vector<std::vector<float>> pitch;
+
+    size_t frames() const { return timestamp_ns.size(); }
+};
+
+class ImuJsonlScanner {
+  public:
+    /**
+     * @param locations         Channel order, at most 8 channels.
+     * @param fields            ImuJsonField mask of what to extract.
+     * @param default_period_ns Frame spacing for lines without a timestamp.
+     */
+    ImuJsonlScanner(std::vector<std::string> locations, uint32_t fields = IMU_JSON_ALL,
+                    int64_t default_period_ns = 100000000);
+
+    // Empty columns for this scanner's channels and fields, with room for frames
+    void prepare(ImuJsonlColumns& columns, size_t frames) const;
+
+    // Appends every sensor line of data; @return lines appended
+    size_t scan(const char* data, size_t size, ImuJsonlColumns& columns) const;
+
+    // Maps the file and scans it; @return 0 on success, -1 if it cannot be read
+    int scan_file(const std::string& path, ImuJsonlColumns& columns) const;
+
+  private:
+    std::vector<std::string> locations_;
+    uint32_t fields_;
+    int64_t default_period_ns_;
+};
+
+#endif // IMU_JSONL_SCAN_H
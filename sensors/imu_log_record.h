@@ -0,0 +1,64 @@
+#ifndef IMU_LOG_RECORD_H
+#define IMU_LOG_RECORD_H
+
+#include <stdint.h>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "exolog.h"
+#include "imu_acquisition.h"
+
+/**
+ * Record of the controller's IMU log, an .exolog file (exolog.h) with one
+ * ImuLogRecord per sweep in sensorLocations order. Records are plain memory
+ * images so the acquisition thread only has to copy them into the logger's
+ * ring; imu_log_schema() describes the same layout to readers.
+ */
+
+struct ImuLogRecord {
+    uint64_t sequence;
+    int64_t timestamp_ns;               // sweep start, CLOCK_MONOTONIC (see realtime_offset_ns)
+    int64_t sample_ns[IMU_CHANNELS];
+    int16_t roll[IMU_CHANNELS];         // raw BNO055 roll, 1/16 degree
+    uint8_t valid_mask;
+    uint8_t substituted_mask;
+    uint8_t fresh_mask;
+    uint8_t reserved;
+};
+static_assert(sizeof(ImuLogRecord) == 80, "ImuLogRecord layout is part of the file format");
+
+// Header schema of the controller's IMU log, period_ns being the sweep period.
+// The realtime anchor is taken now, so make the schema when opening the log.
+inline ExologSchema imu_log_schema(const std::vector<std::string>& locations, int64_t period_ns) {
+    const uint32_t channels = IMU_CHANNELS;
+    ExologSchema schema;
+    schema.period_ns = period_ns;
+    schema.realtime_offset_ns = realtime_offset_ns();
+    schema.locations = locations;
+    schema.locations.resize(channels);
+    schema.add("sequence", ExologType::U64, 1, offsetof(ImuLogRecord, sequence));
+    schema.add("timestamp_ns", ExologType::I64, 1, offsetof(ImuLogRecord, timestamp_ns), 1.0, "ns");
+    schema.add("sample_ns", ExologType::I64, channels, offsetof(ImuLogRecord, sample_ns), 1.0, "ns");
+    schema.add("roll", ExologType::I16, channels, offsetof(ImuLogRecord, roll), 1.0 / 16.0, "deg");
+    schema.add("valid_mask", ExologType::U8, 1, offsetof(ImuLogRecord, valid_mask));
+    schema.add("substituted_mask", ExologType::U8, 1, offsetof(ImuLogRecord, substituted_mask));
+    schema.add("fresh_mask", ExologType::U8, 1, offsetof(ImuLogRecord, fresh_mask));
+    schema.record_size = sizeof(ImuLogRecord);
+    return schema;
+}
+
+inline ImuLogRecord imu_log_record(const ImuFrame& frame) {
+    ImuLogRecord record;
+    record.sequence = frame.sequence;
+    record.timestamp_ns = frame.timestamp_ns;
+    std::memcpy(record.sample_ns, frame.sample_ns, sizeof(record.sample_ns));
+    std::memcpy(record.roll, frame.roll, sizeof(record.roll));
+    record.valid_mask = frame.valid_mask;
+    record.substituted_mask = frame.substituted_mask;
+    record.fresh_mask = frame.fresh_mask;
+    record.reserved = 0;
+    return record;
+}
+
+#endif // IMU_LOG_RECORD_H
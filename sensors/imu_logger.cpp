@@ -1,4 +1,7 @@
 #include "driver.h"
+#include "bno055_device.h"
+#include "bno055_read_plan.h"
+#include "i2c_dev_bus.h"
 #include <iostream>
 #include <fstream>
 #include <vector>
@@ -50,20 +53,30 @@ int main() {
     int sampleIntervalMs = 50;  // Sampling rate in milliseconds
     std::vector<int> sensorAddresses = { 0x29 };  // List of I2C sensor addresses
 
-    std::vector<bno055_t> sensors;  // Vector to store sensor objects
+    if (default_i2c_bus().open() != 0) {
+        std::cerr << "Failed to open the I2C bus" << std::endl;
+        return -1;
+    }
+
+    std::vector<Bno055Device> sensors;  // Vector to store sensor objects
     for (int addr : sensorAddresses) {
-        bno055_t imu;
-        if (initialize_imu(&imu, addr) != BNO055_SUCCESS) {
+        Bno055Device imu(default_i2c_bus(), addr);
+        if (imu.init() != BNO055_SUCCESS) {
             std::cerr << "Failed to initialize sensor at address 0x" << std::hex << addr << std::endl;
             continue;  // Skip this sensor and continue with others
         }
-        if (setup_imu(&imu) != BNO055_SUCCESS) {
+        if (imu.set_operation_mode(BNO055_OPERATION_MODE_NDOF) != BNO055_SUCCESS) {
             std::cerr << "Failed to set operation mode for sensor at address 0x" << std::hex << addr << std::endl;
             continue;
         }
         sensors.push_back(imu);
     }
 
+    // Everything the log needs (0x08 - 0x33) in a single burst instead of seven reads
+    const Bno055ReadPlan plan = bno055_plan_read(BNO055_Q_ACCEL | BNO055_Q_MAG | BNO055_Q_GYRO |
+                                                 BNO055_Q_EULER | BNO055_Q_QUATERNION |
+                                                 BNO055_Q_LINEAR_ACCEL | BNO055_Q_GRAVITY);
+
     // Open the log file for writing
     logFile.open("imu_data.json");
     if (!logFile.is_open()) {
@@ -80,61 +93,51 @@ int main() {
 
         // Loop through all sensors and record data
         for (auto &imu : sensors) {
-            bno055_euler_double_t euler_angles;
-            bno055_accel_double_t accel_xyz;
-            bno055_linear_accel_double_t linear_accel_xyz;
-            bno055_gravity_double_t gravity_xyz;
-            bno055_gyro_double_t angular_velocity_xyz;
-            bno055_mag_double_t mag_field_xyz;
-            bno055_quaternion_t quater_wxyz;
-
-            // Read sensor data
-            read_euler_angles(&imu, &euler_angles);
-            read_acceleration(&imu, &accel_xyz);
-            read_linear_acceleration(&imu, &linear_accel_xyz);
-            read_gravity(&imu, &gravity_xyz);
-            read_gyro(&imu, &angular_velocity_xyz);
-            read_magnetic_field(&imu, &mag_field_xyz);
-            read_quaternion(&imu, &quater_wxyz);
+            Bno055Sample sample;
+            if (imu.read(plan, &sample) != BNO055_SUCCESS) {
+                std::cerr << "Failed to read sensor at address 0x" << std::hex << int(imu.dev_addr()) << std::endl;
+                continue;
+            }
 
             // Store sensor data in JSON format
             json sensorData;
-            sensorData["id"] = imu.dev_addr;  // Use the device address as an identifier
+            sensorData["id"] = imu.dev_addr();  // Use the device address as an identifier
             sensorData["euler"] = {
-                {"heading", euler_angles.h},
-                {"roll", euler_angles.r},
-                {"pitch", euler_angles.p}
+                {"heading", sample.euler[0] / BNO055_EULER_LSB_PER_DEG},
+                {"roll", sample.euler[1] / BNO055_EULER_LSB_PER_DEG},
+                {"pitch", sample.euler[2] / BNO055_EULER_LSB_PER_DEG}
             };
             sensorData["acceleration"] = {
-                {"x", accel_xyz.x},
-                {"y", accel_xyz.y},
-                {"z", accel_xyz.z}
+                {"x", sample.accel[0] / BNO055_ACCEL_LSB_PER_MSQ},
+                {"y", sample.accel[1] / BNO055_ACCEL_LSB_PER_MSQ},
+                {"z", sample.accel[2] / BNO055_ACCEL_LSB_PER_MSQ}
             };
             sensorData["linear_acceleration"] = {
-                {"x", linear_accel_xyz.x},
-                {"y", linear_accel_xyz.y},
-                {"z", linear_accel_xyz.z}
+                {"x", sample.linear_accel[0] / BNO055_ACCEL_LSB_PER_MSQ},
+                {"y", sample.linear_accel[1] / BNO055_ACCEL_LSB_PER_MSQ},
+                {"z", sample.linear_accel[2] / BNO055_ACCEL_LSB_PER_MSQ}
             };
             sensorData["gravity"] = {
-                {"x", gravity_xyz.x},
-                {"y", gravity_xyz.y},
-                {"z", gravity_xyz.z}
+                {"x", sample.gravity[0] / BNO055_ACCEL_LSB_PER_MSQ},
+                {"y", sample.gravity[1] / BNO055_ACCEL_LSB_PER_MSQ},
+                {"z", sample.gravity[2] / BNO055_ACCEL_LSB_PER_MSQ}
             };
             sensorData["angular_velocity"] = {
-                {"x", angular_velocity_xyz.x},
-                {"y", angular_velocity_xyz.y},
-                {"z", angular_velocity_xyz.z}
+                {"x", sample.gyro[0] / BNO055_GYRO_LSB_PER_DPS},
+                {"y", sample.gyro[1] / BNO055_GYRO_LSB_PER_DPS},
+                {"z", sample.gyro[2] / BNO055_GYRO_LSB_PER_DPS}
             };
             sensorData["magnetic_field"] = {
-                {"x", mag_field_xyz.x},
-                {"y", mag_field_xyz.y},
-                {"z", mag_field_xyz.z}
+                {"x", sample.mag[0] / BNO055_MAG_LSB_PER_UT},
+                {"y", sample.mag[1] / BNO055_MAG_LSB_PER_UT},
+                {"z", sample.mag[2] / BNO055_MAG_LSB_PER_UT}
             };
+            // Raw s16 counts (1/16384 per unit) as the log always carried them
             sensorData["quaternion"] = {
-                {"w", quater_wxyz.w},
-                {"x", quater_wxyz.x},
-                {"y", quater_wxyz.y},
-                {"z", quater_wxyz.z}
+                {"w", sample.quaternion[0]},
+                {"x", sample.quaternion[1]},
+                {"y", sample.quaternion[2]},
+                {"z", sample.quaternion[3]}
             };
 
             logEntry["sensors"].push_back(sensorData);
@@ -0,0 +1,42 @@
+#include "imu_replay.h"
+#include <algorithm>
+#include <cmath>
+
+int64_t ImuReplay::duration_ns() const {
+    if (frames() < 2) return 0;
+    int64_t span = timestamp_ns.back() - timestamp_ns.front();
+    return span + span / static_cast<int64_t>(frames() - 1);
+}
+
+size_t ImuReplay::frame_at(int64_t t_ns) const {
+    int64_t duration = duration_ns();
+    if (duration <= 0 || t_ns < 0) return 0;
+
+    int64_t t = timestamp_ns.front() + t_ns % duration;
+    auto it = std::upper_bound(timestamp_ns.begin(), timestamp_ns.end(), t);
+    return static_cast<size_t>(it - timestamp_ns.begin()) - 1;
+}
+
+s16 euler_deg_to_raw(double deg) {
+    return static_cast<s16>(std::lround(deg * BNO055_EULER_DIV_DEG));
+}
+
+ImuReplay make_synthetic_replay(size_t channels, size_t frames, int64_t period_ns) {
+    ImuReplay replay;
+    replay.channels = channels;
+    replay.timestamp_ns.resize(frames);
+    replay.euler.resize(frames * channels);
+
+    for (size_t f = 0; f < frames; f++) {
+        replay.timestamp_ns[f] = static_cast<int64_t>(f) * period_ns;
+        for (size_t c = 0; c < channels; c++) {
+            // One gait-like cycle per second, phase shifted per channel
+            double phase = 2.0 * M_PI * (f * period_ns * 1e-9 + c / 6.0);
+            bno055_euler_t& e = replay.euler[f * channels + c];
+            e.h = euler_deg_to_raw(180.0 + 10.0 * std::cos(phase));
+            e.r = euler_deg_to_raw(30.0 * std::sin(phase));
+            e.p = euler_deg_to_raw(5.0 * std::sin(2.0 * phase));
+        }
+    }
+    return replay;
+}
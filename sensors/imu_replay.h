@@ -0,0 +1,62 @@
+#ifndef IMU_REPLAY_H
+#define IMU_REPLAY_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "bno055.h"
+
+/**
+ * @brief Recorded Euler angles to be served by SimulatedI2CBus.
+ *
+ * Frames are stored frame major in channel order, as raw BNO055 values in
+ * 1/16 degree so the simulated registers hold exactly what a sensor would.
+ */
+struct ImuReplay {
+    size_t channels = 0;
+    std::vector<int64_t> timestamp_ns;  // per frame, relative to the first frame
+    std::vector<bno055_euler_t> euler;  // frames * channels
+
+    size_t frames() const { return timestamp_ns.size(); }
+    const bno055_euler_t& at(size_t frame, size_t channel) const {
+        return euler[frame * channels + channel];
+    }
+
+    // Length of one pass, one extra frame interval so a looped replay keeps its pace
+    int64_t duration_ns() const;
+
+    // Frame shown at time t (ns since replay start), looping at the end
+    size_t frame_at(int64_t t_ns) const;
+};
+
+// Degrees to raw BNO055 Euler LSBs, rounded to nearest
+s16 euler_deg_to_raw(double deg);
+
+/**
+ * Generates a replay with a different sine per channel (roll amplitude 30
+ * degrees), for benchmarks and tests that have no recording at hand.
+ */
+ImuReplay make_synthetic_replay(size_t channels, size_t frames, int64_t period_ns);
+
+/**
+ * Loads an imu_data.json / joint_data.json style recording: one JSON object
+ * per line with a "sensors" array of {"location", "euler": {heading, roll,
+ * pitch}} and a "timestamp" ("YYYY-MM-DD HH:MM:SS.mmm").
+ *
+ * Sensors are mapped to channels by location name, so recordings with a
+ * different sensor order replay in `locations` order. Lines without a
+ * parsable timestamp are spaced by default_period_ns.
+ *
+ * Reads through SensorDataset::load_jsonl(). Built with the JSON tooling,
+ * only when nlohmann_json is available.
+ *
+ * @return 0 on success, -1 if the file cannot be read or holds no frame.
+ */
+int load_imu_replay(const std::string& path, const std::vector<std::string>& locations,
+                    ImuReplay& replay, int64_t default_period_ns = 100000000);
+
+// "YYYY-MM-DD HH:MM:SS.mmm" log timestamp to ns since the epoch (read as UTC,
+// only differences matter). Built with load_imu_replay().
+bool parse_log_timestamp(const std::string& text, int64_t* ns);
+
+#endif // IMU_REPLAY_H
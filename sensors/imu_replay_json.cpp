@@ -0,0 +1,49 @@
+#include "imu_replay.h"
+#include "sensor_dataset.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+
+bool parse_log_timestamp(const std::string& text, int64_t* ns) {
+    std::tm tm = {};
+    double seconds = 0.0;
+    if (std::sscanf(text.c_str(), "%d-%d-%d %d:%d:%lf", &tm.tm_year, &tm.tm_mon, &tm.tm_mday,
+                    &tm.tm_hour, &tm.tm_min, &seconds) != 6) {
+        return false;
+    }
+    tm.tm_year -= 1900;
+    tm.tm_mon -= 1;
+    tm.tm_sec = 0;
+    *ns = static_cast<int64_t>(timegm(&tm)) * 1000000000LL + std::llround(seconds * 1e9);
+    return true;
+}
+
+int load_imu_replay(const std::string& path, const std::vector<std::string>& locations,
+                    ImuReplay& replay, int64_t default_period_ns) {
+    SensorDataset dataset;
+    if (dataset.load_jsonl(path, locations, IMU_JSON_EULER, default_period_ns) != 0) return -1;
+    const std::vector<int64_t>& timestamp_ns = dataset.timestamp_ns();
+
+    replay = ImuReplay();
+    replay.channels = dataset.channels();
+    replay.timestamp_ns.resize(dataset.frames());
+    replay.euler.resize(dataset.frames() * replay.channels);
+    for (size_t f = 0; f < dataset.frames(); f++) {
+        // Relative to the first frame, never going backwards
+        int64_t t = timestamp_ns[f] - timestamp_ns[0];
+        replay.timestamp_ns[f] = f > 0 ? std::max(t, replay.timestamp_ns[f - 1]) : 0;
+    }
+    for (size_t c = 0; c < replay.channels; c++) {
+        const float* heading = dataset.column(dataset.quantity("heading"), c);
+        const float* roll = dataset.column(dataset.quantity("roll"), c);
+        const float* pitch = dataset.column(dataset.quantity("pitch"), c);
+        for (size_t f = 0; f < dataset.frames(); f++) {
+            bno055_euler_t& raw = replay.euler[f * replay.channels + c];
+            raw.h = euler_deg_to_raw(heading[f]);
+            raw.r = euler_deg_to_raw(roll[f]);
+            raw.p = euler_deg_to_raw(pitch[f]);
+        }
+    }
+    return 0;
+}
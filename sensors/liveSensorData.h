@@ -2,11 +2,18 @@
 #define LIVE_SENSOR_DATA_H
 
 #include "bno055.h"
-#include "rpi_tca9548a.h"
+#include "imu_acquisition.h"
+#include "sensor_rig.h"
+#include "async_logger.h"
 #include <vector>
 #include <cmath>
 
 
-std::vector<double> liveSensorData(std::vector<bno055_t>& sensors, rpi_tca9548a& tca);
+// One sweep over all sensors, each I2C bus on its own thread: raw roll
+// (1/16 degree) and valid bits go into frame. Sensors under re-initialisation
+// are skipped and get a stand-in, sensors on a slower rate carry their last
+// sample between reads. The frame is handed to log as an ImuLogRecord
+// (imu_log_record.h); nothing on this path touches the file.
+void liveSensorData(SensorRig& rig, AsyncLogger& log, ImuFrame& frame);
 
 #endif // LIVE_SENSOR_DATA_H
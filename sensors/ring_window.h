@@ -0,0 +1,87 @@
+#ifndef RING_WINDOW_H
+#define RING_WINDOW_H
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * @brief The last frames of a RingWindow, [frames][Channels] contiguous.
+ *
+ * A view: it points into the ring and stays valid until Capacity more
+ * frames have been pushed.
+ */
+template <typename T, size_t Channels>
+class FrameView {
+  public:
+    FrameView() : data_(nullptr), frames_(0) {}
+    FrameView(const T* data, size_t frames) : data_(data), frames_(frames) {}
+
+    const T* data() const { return data_; }
+    size_t frames() const { return frames_; }
+    static constexpr size_t channels() { return Channels; }
+    bool empty() const { return frames_ == 0; }
+
+    const T* operator[](size_t t) const { return data_ + t * Channels; }
+    const T& operator()(size_t t, size_t channel) const { return data_[t * Channels + channel]; }
+
+  private:
+    const T* data_;
+    size_t frames_;
+};
+
+/**
+ * @brief Fixed-capacity history of the most recent frames.
+ *
+ * Storage is one inline array of 2 * Capacity frames, and every frame is
+ * written twice, at its slot and at slot + Capacity. Any run of the last N
+ * frames (N <= Capacity) then sits contiguous somewhere in the array, so
+ * last() hands out a plain [N][Channels] view without copying, whichever
+ * way the ring has wrapped. push() copies Channels values twice; nothing
+ * allocates.
+ *
+ * @tparam T        Trivially copyable sample type.
+ * @tparam Channels Samples per frame.
+ * @tparam Capacity Frames kept, the largest window last() can give.
+ */
+template <typename T, size_t Channels, size_t Capacity>
+class RingWindow {
+    static_assert(std::is_trivially_copyable<T>::value, "RingWindow holds trivially copyable samples");
+    static_assert(Channels >= 1 && Capacity >= 1, "RingWindow needs at least one channel and one frame");
+
+  public:
+    using View = FrameView<T, Channels>;
+
+    // Appends one frame (Channels values), overwriting the oldest when full
+    void push(const T* frame) {
+        const size_t slot = pushed_ % Capacity;
+        std::memcpy(&buffer_[slot * Channels], frame, Channels * sizeof(T));
+        std::memcpy(&buffer_[(slot + Capacity) * Channels], frame, Channels * sizeof(T));
+        pushed_++;
+    }
+
+    // The last frames frames, oldest first; empty if fewer have been pushed
+    View last(size_t frames) const {
+        if (frames > size()) return View();
+        const size_t start = (pushed_ - frames) % Capacity;
+        return View(&buffer_[start * Channels], frames);
+    }
+
+    // The newest frame, nullptr before the first push
+    const T* back() const { return pushed_ ? &buffer_[((pushed_ - 1) % Capacity) * Channels] : nullptr; }
+
+    size_t size() const { return pushed_ < Capacity ? pushed_ : Capacity; }
+    bool empty() const { return pushed_ == 0; }
+    bool full() const { return pushed_ >= Capacity; }
+    size_t pushed() const { return pushed_; }
+    void clear() { pushed_ = 0; }
+
+    static constexpr size_t capacity() { return Capacity; }
+    static constexpr size_t channels() { return Channels; }
+
+  private:
+    size_t pushed_ = 0;
+    T buffer_[2 * Capacity * Channels];
+};
+
+#endif // RING_WINDOW_H
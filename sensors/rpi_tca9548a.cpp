@@ -4,27 +4,96 @@ Author: Bryan Casanelli - bryancasanelli@gmail.com
 */
 
 #include "rpi_tca9548a.h"
-#include <wiringPiI2C.h>
-#include <wiringPi.h>
+#include "i2c_bus.h"
+#include "i2c_stats.h"
+#include <unistd.h>
 
-rpi_tca9548a::rpi_tca9548a(){
-  wiringPiSetup();
+// Attempts per switch before giving up on the control register read-back
+static const int SWITCH_ATTEMPTS = 3;
+
+// Channel of a single-channel mask, -1 for none or several
+static int mask_channel(uint8_t mask){
+  for (int channel = 0; channel < 8; channel++){
+    if (mask == (1 << channel)){return channel;}
+  }
+  return -1;
 }
 
+rpi_tca9548a::rpi_tca9548a()
+  : bus(nullptr), addr(0x70), active_mask(-1), settle_us(50) {}
+
 rpi_tca9548a::~rpi_tca9548a(){
   no_channel();
 }
 
 int rpi_tca9548a::init(int id){
-  this->fd = wiringPiI2CSetup(id);
-  if (this->fd == -1){return -1;} // Error
-  return 0;                       // Ok
+  return init(id, default_i2c_bus());
+}
+
+int rpi_tca9548a::init(int id, I2CBus& bus){
+  if (bus.open() != 0){return -1;} // Error
+  this->bus = &bus;
+  this->addr = static_cast<uint8_t>(id);
+  this->active_mask = -1;
+  return 0;                         // Ok
+}
+
+int rpi_tca9548a::write_mask(uint8_t mask){
+  if (this->bus == nullptr){return -1;}
+
+  I2CStats* stats = this->bus->io_stats();
+  if (this->active_mask == mask){
+    // Already selected, no transaction; another mux on the bus may have
+    // moved the stats channel since, so point it back here
+    if (stats != nullptr){stats->set_channel(mask_channel(mask));}
+    return 0;
+  }
+
+  int64_t start = I2CStats::now_ns();
+  for (int attempt = 0; attempt < SWITCH_ATTEMPTS; attempt++){
+    if (this->bus->send_byte(this->addr, mask) != BNO055_SUCCESS){continue;}
+    if (this->settle_us > 0){usleep(this->settle_us);}
+
+    // The control register reads back the enabled channel mask
+    u8 readback = 0;
+    if (this->bus->receive_byte(this->addr, &readback) == BNO055_SUCCESS && readback == mask){
+      this->active_mask = mask;
+      if (stats != nullptr){
+        stats->record(I2COp::MUX_SWITCH, mask_channel(mask), this->addr, start, true);
+        stats->set_channel(mask_channel(mask));  // following transactions go to this channel
+      }
+      return 0;
+    }
+  }
+  this->active_mask = -1;
+  if (stats != nullptr){
+    stats->record(I2COp::MUX_SWITCH, mask_channel(mask), this->addr, start, false);
+    stats->set_channel(-1);  // unknown
+  }
+  return -1;
+}
+
+int rpi_tca9548a::set_channel(uint8_t channel){
+  if (channel > 7){return -1;}
+  return write_mask(static_cast<uint8_t>(1 << channel));
+}
+
+int rpi_tca9548a::no_channel(){
+  return write_mask(0);
 }
 
-void rpi_tca9548a::set_channel(uint8_t channel){
-  wiringPiI2CWrite(this->fd,1<<channel);
+int rpi_tca9548a::visit_channels(const std::vector<uint8_t>& channels,
+                                 const std::function<void(size_t, bool)>& fn){
+  int failed = 0;
+  for (size_t i = 0; i < channels.size(); i++){
+    bool selected = set_channel(channels[i]) == 0;
+    if (!selected){failed++;}
+    fn(i, selected);
+  }
+  return failed;
 }
 
-void rpi_tca9548a::no_channel(){
-  wiringPiI2CWrite(this->fd,0);
+int rpi_tca9548a::active_channel() const{
+  if (this->active_mask <= 0){return -1;}
+  return mask_channel(static_cast<uint8_t>(this->active_mask));
 }
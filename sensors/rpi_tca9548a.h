@@ -2,16 +2,44 @@
 #define RPI_TCA9548A_H
 
 #include <stdint.h>
+#include <functional>
+#include <vector>
+
+class I2CBus;
 
 class rpi_tca9548a {
   public:
     rpi_tca9548a();
     ~rpi_tca9548a();
     int init(int id);
-    void set_channel(uint8_t channel);
-    void no_channel();
+    int init(int id, I2CBus& bus);
+
+    // Select a single channel (0-7). Skips the bus write when the channel is
+    // already active. Returns 0 on success, -1 if the control register does
+    // not read back as expected.
+    int set_channel(uint8_t channel);
+    int no_channel();
+
+    // Visit channels in order, switching only when needed. fn(index, selected)
+    // is called for every entry, with selected == false when the switch failed.
+    // Returns the number of channels that could not be selected.
+    int visit_channels(const std::vector<uint8_t>& channels,
+                       const std::function<void(size_t, bool)>& fn);
+
+    // Time allowed for the switch to settle before the read-back (default 50 us)
+    void set_settle_time_us(unsigned int us) { settle_us = us; }
+    unsigned int settle_time_us() const { return settle_us; }
+
+    int active_channel() const;  // -1 if none or unknown
+    void invalidate() { active_mask = -1; }  // force the next switch to hit the bus
+
   private:
-    int fd;
+    int write_mask(uint8_t mask);
+
+    I2CBus* bus;
+    uint8_t addr;
+    int active_mask;  // control register value last written, -1 if unknown
+    unsigned int settle_us;
 };
 
 #endif
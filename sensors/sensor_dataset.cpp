@@ -0,0 +1,144 @@
+#include "sensor_dataset.h"
+#include "exolog.h"
+#include "exolog_codec.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+void SensorWindow::copy_to(float* out) const {
+    for (size_t c = 0; c < channels_; c++) {
+        const float* column = channel(c);
+        for (size_t t = 0; t < frames_; t++) out[t * channels_ + c] = column[t];
+    }
+}
+
+void SensorDataset::reset(const std::vector<std::string>& locations, const std::vector<std::string>& quantities,
+                          size_t frames) {
+    locations_ = locations;
+    quantities_ = quantities;
+    frames_ = frames;
+    timestamp_ns_.assign(frames, 0);
+    valid_mask_.assign(frames, 0);
+    values_.assign(quantities.size() * locations.size() * frames, 0.0f);
+}
+
+int SensorDataset::quantity(const std::string& name) const {
+    auto it = std::find(quantities_.begin(), quantities_.end(), name);
+    return it == quantities_.end() ? -1 : static_cast<int>(it - quantities_.begin());
+}
+
+int SensorDataset::load_jsonl(const std::string& path, const std::vector<std::string>& locations,
+                              uint32_t quantities, int64_t default_period_ns) {
+    ImuJsonlScanner scanner(locations, IMU_JSON_TIMESTAMP | (quantities & IMU_JSON_EULER), default_period_ns);
+    ImuJsonlColumns columns;
+    if (scanner.scan_file(path, columns) != 0) return -1;
+
+    std::vector<std::string> names;
+    std::vector<const std::vector<std::vector<float>>*> sources;
+    if (quantities & IMU_JSON_HEADING) { names.push_back("heading"); sources.push_back(&columns.heading); }
+    if (quantities & IMU_JSON_ROLL)    { names.push_back("roll");    sources.push_back(&columns.roll); }
+    if (quantities & IMU_JSON_PITCH)   { names.push_back("pitch");   sources.push_back(&columns.pitch); }
+
+    reset(locations, names, columns.frames());
+    timestamp_ns_ = std::move(columns.timestamp_ns);
+    valid_mask_ = std::move(columns.valid_mask);
+    for (size_t q = 0; q < sources.size(); q++) {
+        for (size_t c = 0; c < channels(); c++) {
+            std::memcpy(column(q, c), (*sources[q])[c].data(), frames_ * sizeof(float));
+        }
+    }
+    return frames_ > 0 ? 0 : -1;
+}
+
+int SensorDataset::load_exolog(const std::string& path, const std::vector<std::string>& quantities) {
+    // Plain files are read in place, compressed ones decoded block by block
+    ExologSchema schema;
+    size_t header_size = 0;
+    if (read_exolog_header(path, schema, &header_size) != 0) {
+        std::cerr << path << " is not an .exolog file" << std::endl;
+        return -1;
+    }
+    ExologReader reader;
+    std::vector<uint8_t> decoded;
+    const uint8_t* records = nullptr;
+    size_t frames = 0;
+    if (schema.compression.empty()) {
+        if (reader.open(path) != 0) return -1;
+        records = reader.record(0);
+        frames = reader.frames();
+    } else {
+        ExologBlockReader blocks;
+        if (blocks.open(path) != 0) return -1;
+        std::vector<uint8_t> block;
+        while (blocks.next(block) > 0) decoded.insert(decoded.end(), block.begin(), block.end());
+        records = decoded.data();
+        frames = decoded.size() / schema.record_size;
+    }
+
+    const ExologField* timestamp = schema.find("timestamp_ns");
+    if (timestamp == nullptr) {
+        std::cerr << path << ": no timestamp_ns field" << std::endl;
+        return -1;
+    }
+    const ExologField* valid = schema.find("valid_mask");
+    std::vector<std::string> names;
+    std::vector<const ExologField*> fields;
+    for (const std::string& name : quantities) {
+        const ExologField* field = schema.find(name);
+        if (field != nullptr && field->count == schema.channels()) {
+            names.push_back(name);
+            fields.push_back(field);
+        }
+    }
+    if (fields.empty()) {
+        std::cerr << path << ": none of the requested quantities" << std::endl;
+        return -1;
+    }
+
+    reset(schema.locations, names, frames);
+    const size_t stride = schema.record_size;
+    for (size_t t = 0; t < frames_; t++) {
+        const uint8_t* record = records + t * stride;
+        if (timestamp->type == ExologType::I64) {
+            std::memcpy(&timestamp_ns_[t], record + timestamp->offset, sizeof(int64_t));
+        } else {
+            timestamp_ns_[t] = static_cast<int64_t>(exolog_value(*timestamp, record));
+        }
+        valid_mask_[t] = valid != nullptr ? static_cast<uint8_t>(exolog_value(*valid, record))
+                                          : static_cast<uint8_t>((1u << channels()) - 1);
+    }
+    for (size_t q = 0; q < fields.size(); q++) {
+        const ExologField& field = *fields[q];
+        for (size_t c = 0; c < channels(); c++) {
+            float* out = column(q, c);
+            for (size_t t = 0; t < frames_; t++) out[t] = static_cast<float>(exolog_value(field, records + t * stride, c));
+        }
+    }
+    return frames_ > 0 ? 0 : -1;
+}
+
+int SensorDataset::load(const std::string& path, const std::vector<std::string>& locations,
+                        const std::vector<std::string>& quantities) {
+    const std::string extension = ".exolog";
+    if (path.size() >= extension.size() &&
+        path.compare(path.size() - extension.size(), extension.size(), extension) == 0) {
+        return load_exolog(path, quantities);
+    }
+    uint32_t mask = 0;
+    for (const std::string& name : quantities) {
+        if (name == "heading") mask |= IMU_JSON_HEADING;
+        else if (name == "roll") mask |= IMU_JSON_ROLL;
+        else if (name == "pitch") mask |= IMU_JSON_PITCH;
+    }
+    return load_jsonl(path, locations, mask);
+}
+
+SensorWindow SensorDataset::window(size_t start, size_t length, size_t quantity) const {
+    if (quantity >= quantities_.size() || length == 0 || start + length > frames_) return SensorWindow();
+    return SensorWindow(column(quantity, 0) + start, timestamp_ns_.data() + start, length, channels(), frames_);
+}
+
+size_t SensorDataset::windows(size_t length, size_t step) const {
+    if (length == 0 || step == 0 || length > frames_) return 0;
+    return (frames_ - length) / step + 1;
+}
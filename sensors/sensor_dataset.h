@@ -0,0 +1,113 @@
+#ifndef SENSOR_DATASET_H
+#define SENSOR_DATASET_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "imu_jsonl_scan.h"
+
+/**
+ * @brief [frames][channels] view of a window of one quantity of a
+ * SensorDataset, straight into its columns.
+ *
+ * Each channel's samples are contiguous (channel()); copy_to() lays the
+ * window out frame major, the [1][frames][channels] order the model takes.
+ */
+class SensorWindow {
+  public:
+    SensorWindow() : base_(nullptr), timestamp_ns_(nullptr), frames_(0), channels_(0), stride_(0) {}
+    SensorWindow(const float* base, const int64_t* timestamp_ns, size_t frames, size_t channels, size_t stride)
+        : base_(base), timestamp_ns_(timestamp_ns), frames_(frames), channels_(channels), stride_(stride) {}
+
+    size_t frames() const { return frames_; }
+    size_t channels() const { return channels_; }
+    bool empty() const { return frames_ == 0; }
+
+    float operator()(size_t t, size_t channel) const { return base_[channel * stride_ + t]; }
+    const float* channel(size_t channel) const { return base_ + channel * stride_; }
+    int64_t timestamp_ns(size_t t) const { return timestamp_ns_[t]; }
+
+    // frames * channels floats, frame major
+    void copy_to(float* out) const;
+
+  private:
+    const float* base_;
+    const int64_t* timestamp_ns_;
+    size_t frames_;
+    size_t channels_;
+    size_t stride_;   // floats between channels
+};
+
+/**
+ * @brief A whole recording in memory, column by column.
+ *
+ * Holds one or more quantities (e.g. "roll", or heading/roll/pitch) per
+ * channel in degrees, a timestamp and a valid_mask per frame. Timestamps
+ * stay in the recording's clock: epoch time from JSON lines, CLOCK_MONOTONIC
+ * from the controller's .exolog (its header's realtime_offset_ns converts).
+ * All columns share one allocation, [quantity][channel][frame], so every
+ * sliding window over a quantity is a SensorWindow into it. Offline replay,
+ * model evaluation and training export all load recordings through this.
+ */
+class SensorDataset {
+  public:
+    SensorDataset() : frames_(0) {}
+
+    /**
+     * Loads an imu_data.json / joint_data.json style recording (see
+     * load_imu_replay()), sensors mapped to channels by location name.
+     *
+     * @param quantities ImuJsonField mask of the Euler angles to keep.
+     * @return 0 on success, -1 if the file cannot be read or holds no frame.
+     */
+    int load_jsonl(const std::string& path, const std::vector<std::string>& locations,
+                   uint32_t quantities = IMU_JSON_ROLL, int64_t default_period_ns = 100000000);
+
+    /**
+     * Loads an .exolog recording, plain or compressed, scaled to physical
+     * units. Quantities the file does not have are left out (see quantity()).
+     *
+     * @return 0 on success, -1 if the file cannot be read, has no
+     *         timestamp_ns field, none of the quantities or no frame.
+     */
+    int load_exolog(const std::string& path, const std::vector<std::string>& quantities = {"roll"});
+
+    // load_exolog() for .exolog files, load_jsonl() for anything else
+    int load(const std::string& path, const std::vector<std::string>& locations,
+             const std::vector<std::string>& quantities = {"roll"});
+
+    // Zeroed columns for building a dataset in place (tests, synthetic data)
+    void reset(const std::vector<std::string>& locations, const std::vector<std::string>& quantities,
+               size_t frames);
+
+    size_t frames() const { return frames_; }
+    size_t channels() const { return locations_.size(); }
+    const std::vector<std::string>& locations() const { return locations_; }
+    const std::vector<std::string>& quantities() const { return quantities_; }
+
+    // Index of a quantity by name, -1 if it was not loaded
+    int quantity(const std::string& name) const;
+
+    const float* column(size_t quantity, size_t channel) const { return values_.data() + (quantity * channels() + channel) * frames_; }
+    float* column(size_t quantity, size_t channel) { return values_.data() + (quantity * channels() + channel) * frames_; }
+    const std::vector<int64_t>& timestamp_ns() const { return timestamp_ns_; }
+    std::vector<int64_t>& timestamp_ns() { return timestamp_ns_; }
+    const std::vector<uint8_t>& valid_mask() const { return valid_mask_; }
+    std::vector<uint8_t>& valid_mask() { return valid_mask_; }
+
+    // Frames [start, start + length) of a quantity; empty if they are not all there
+    SensorWindow window(size_t start, size_t length, size_t quantity = 0) const;
+
+    // Number of full windows of length frames, starting every step frames
+    size_t windows(size_t length, size_t step = 1) const;
+
+  private:
+    std::vector<std::string> locations_;
+    std::vector<std::string> quantities_;
+    size_t frames_;
+    std::vector<int64_t> timestamp_ns_;
+    std::vector<uint8_t> valid_mask_;
+    std::vector<float> values_;  // [quantity][channel][frame]
+};
+
+#endif // SENSOR_DATASET_H
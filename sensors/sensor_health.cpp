@@ -0,0 +1,217 @@
+#include "sensor_health.h"
+#include <algorithm>
+#include "bno055_calibration.h"
+
+static const int64_t NSEC_PER_MSEC = 1000000LL;
+
+// One full turn of roll in raw 1/16 degree units
+static const int32_t ROLL_RAW_TURN = 360 * 16;
+
+SensorHealthMonitor::SensorHealthMonitor(std::vector<Bno055Device>& sensors, SensorHealthConfig config)
+    : sensors_(sensors), config_(config), channels_(sensors.size()), next_recovery_(0),
+      reinit_attempts_(0), recoveries_(0) {}
+
+void SensorHealthMonitor::report_read(size_t i, bool ok, int16_t roll, int64_t t_ns) {
+    Channel& ch = channels_[i];
+    ch.read_ok = ok;
+    ch.last_ok = false;
+    if (!ok) {
+        if (++ch.failures >= config_.failures_before_reinit) fail(ch, t_ns);
+        return;
+    }
+    ch.failures = 0;
+
+    // A sensor that reset reads exactly zero. A single zero is passed on, a
+    // run of them is replaced by the stand-in until OPR_MODE has been checked.
+    // Once the check passed the sensor is level and its zeros are passed on,
+    // OPR_MODE still checked after every run, until it reads non-zero again.
+    if (roll == 0) {
+        if (++ch.zero_reads >= config_.zero_reads_before_check) ch.check_mode = true;
+        if (!ch.zero_verified) {
+            if (ch.zero_reads > 1) ch.read_ok = false;
+            ch.last_ok = ch.read_ok;
+            return;
+        }
+    } else {
+        ch.zero_reads = 0;
+        ch.zero_verified = false;
+    }
+    ch.last_ok = true;
+
+    ch.prev_roll = ch.last_roll;
+    ch.prev_ns = ch.last_ns;
+    ch.last_roll = roll;
+    ch.last_ns = t_ns;
+    if (!ch.have_good) ch.prev_ns = t_ns;  // no slope from a single sample
+    ch.have_good = true;
+}
+
+void SensorHealthMonitor::report_skipped(size_t i) {
+    Channel& ch = channels_[i];
+    ch.read_ok = ch.last_ok;
+}
+
+void SensorHealthMonitor::mark_failed(size_t i, int64_t now_ns) {
+    Channel& ch = channels_[i];
+    fail(ch, now_ns);
+    ch.deadline_ns = now_ns;  // first attempt right away
+}
+
+void SensorHealthMonitor::fail(Channel& ch, int64_t now_ns) {
+    ch.backoff_ns = ch.backoff_ns == 0 ? config_.retry_initial_ns
+                                       : std::min(ch.backoff_ns * 2, config_.retry_max_ns);
+    ch.state = SensorState::FAILED;
+    ch.deadline_ns = now_ns + ch.backoff_ns;
+    ch.failures = 0;
+    ch.zero_reads = 0;
+    ch.zero_verified = false;
+    ch.check_mode = false;
+}
+
+int16_t SensorHealthMonitor::substitute(const Channel& ch, int64_t now_ns) const {
+    if (config_.policy == SubstitutePolicy::HOLD_LAST_GOOD || ch.last_ns <= ch.prev_ns) {
+        return ch.last_roll;
+    }
+
+    int64_t horizon = std::min(now_ns - ch.last_ns, config_.max_extrapolation_ns);
+    double slope = static_cast<double>(ch.last_roll - ch.prev_roll) / (ch.last_ns - ch.prev_ns);
+    int32_t value = ch.last_roll + static_cast<int32_t>(slope * std::max<int64_t>(horizon, 0));
+
+    // Keep it in [-180, 180) degrees
+    const int32_t half = ROLL_RAW_TURN / 2;
+    value = ((value + half) % ROLL_RAW_TURN + ROLL_RAW_TURN) % ROLL_RAW_TURN - half;
+    return static_cast<int16_t>(value);
+}
+
+void SensorHealthMonitor::isolate(size_t i) {
+    if (isolate_) isolate_(i);
+}
+
+bool SensorHealthMonitor::poll_calibration(size_t i, int64_t now_ns) {
+    Channel& ch = channels_[i];
+    if (!config_.save_calibration_while_running || !save_calibration_ || ch.calibration_saved ||
+        ch.save_tried || now_ns < ch.calibration_poll_ns) {
+        return false;
+    }
+    ch.calibration_poll_ns = now_ns + config_.calibration_poll_ns;
+
+    Bno055Device& dev = sensors_[i];
+    u8 status = 0;
+    isolate(i);
+    if (dev.read_calibration_status(&status) != BNO055_SUCCESS || status != BNO055_CALIB_STAT_FULL) {
+        return true;  // a failed read shows up in the sweep
+    }
+
+    // The profile registers are only readable in CONFIG
+    if (dev.write_operation_mode(BNO055_OPERATION_MODE_CONFIG) != BNO055_SUCCESS) {
+        fail(ch, now_ns);
+        ch.deadline_ns = now_ns;
+        return true;
+    }
+    ch.state = SensorState::SAVE_WAIT;
+    ch.deadline_ns = now_ns + BNO055_CONFIG_MODE_SWITCHING_DELAY * NSEC_PER_MSEC;
+    return true;
+}
+
+void SensorHealthMonitor::start_fusion(Channel& ch, Bno055Device& dev, int64_t now_ns) {
+    if (dev.write_operation_mode(config_.operation_mode) != BNO055_SUCCESS) {
+        fail(ch, now_ns);
+        return;
+    }
+    ch.state = SensorState::FUSION_WAIT;
+    ch.deadline_ns = now_ns + BNO055_MODE_SWITCHING_DELAY * NSEC_PER_MSEC;
+}
+
+bool SensorHealthMonitor::advance(size_t i, int64_t now_ns) {
+    Channel& ch = channels_[i];
+    Bno055Device& dev = sensors_[i];
+    u8 mode = 0;
+
+    switch (ch.state) {
+        case SensorState::HEALTHY:
+            if (!ch.check_mode) return poll_calibration(i, now_ns);
+            ch.check_mode = false;
+            isolate(i);
+            if (dev.get_operation_mode(&mode) == BNO055_SUCCESS && mode == config_.operation_mode) {
+                ch.zero_reads = 0;  // genuinely level, keep going
+                ch.zero_verified = true;
+            } else {
+                fail(ch, now_ns);
+                ch.deadline_ns = now_ns;
+            }
+            return true;
+
+        case SensorState::FAILED:
+            if (now_ns < ch.deadline_ns) return false;
+            reinit_attempts_++;
+            isolate(i);
+            if (dev.init() != BNO055_SUCCESS) {
+                fail(ch, now_ns);
+                return true;
+            }
+            // Any mode change goes through CONFIG first
+            if (dev.operation_mode() != BNO055_OPERATION_MODE_CONFIG) {
+                if (dev.write_operation_mode(BNO055_OPERATION_MODE_CONFIG) != BNO055_SUCCESS) {
+                    fail(ch, now_ns);
+                    return true;
+                }
+                ch.state = SensorState::CONFIG_WAIT;
+                ch.deadline_ns = now_ns + BNO055_CONFIG_MODE_SWITCHING_DELAY * NSEC_PER_MSEC;
+                return true;
+            }
+            [[fallthrough]];  // already in CONFIG
+
+        case SensorState::CONFIG_WAIT:
+            if (now_ns < ch.deadline_ns) return false;
+            isolate(i);
+            // The profile registers only take writes in CONFIG; a sensor
+            // without its profile still runs, it just calibrates again
+            if (restore_calibration_) restore_calibration_(i);
+            start_fusion(ch, dev, now_ns);
+            return true;
+
+        case SensorState::SAVE_WAIT:
+            if (now_ns < ch.deadline_ns) return false;
+            isolate(i);
+            ch.calibration_saved = save_calibration_(i);
+            ch.save_tried = true;  // another attempt would cost another dropout
+            start_fusion(ch, dev, now_ns);
+            return true;
+
+        case SensorState::FUSION_WAIT:
+            if (now_ns < ch.deadline_ns) return false;
+            isolate(i);
+            if (dev.get_operation_mode(&mode) != BNO055_SUCCESS || mode != config_.operation_mode) {
+                fail(ch, now_ns);
+                return true;
+            }
+            ch.state = SensorState::HEALTHY;
+            if (ch.backoff_ns > 0) recoveries_++;  // not after a calibration save, it never failed
+            ch.backoff_ns = 0;
+            return true;
+    }
+    return false;
+}
+
+void SensorHealthMonitor::step(ImuFrame& frame, int64_t now_ns) {
+    for (size_t i = 0; i < channels_.size() && i < IMU_CHANNELS; i++) {
+        Channel& ch = channels_[i];
+        bool good = ch.read_ok && ch.state == SensorState::HEALTHY;
+        ch.read_ok = false;
+        if (good || !ch.have_good) continue;
+
+        frame.roll[i] = substitute(ch, now_ns);
+        frame.sample_ns[i] = now_ns;
+        frame.valid_mask &= static_cast<uint8_t>(~(1u << i));
+        frame.substituted_mask |= static_cast<uint8_t>(1u << i);
+    }
+
+    // At most one bus action per sweep, channels take turns
+    for (size_t n = 0; n < channels_.size(); n++) {
+        size_t i = (next_recovery_ + n) % channels_.size();
+        if (advance(i, now_ns)) {
+            next_recovery_ = i + 1;
+            break;
+        }
+    }
+}
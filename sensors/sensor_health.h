@@ -0,0 +1,146 @@
+#ifndef SENSOR_HEALTH_H
+#define SENSOR_HEALTH_H
+
+#include <stdint.h>
+#include <functional>
+#include <vector>
+#include "bno055_device.h"
+#include "imu_acquisition.h"
+
+enum class SensorState {
+    HEALTHY,
+    FAILED,        // waiting for the next re-init attempt
+    CONFIG_WAIT,   // switched to CONFIG, waiting BNO055_CONFIG_MODE_SWITCHING_DELAY
+    FUSION_WAIT,   // switched to the fusion mode, waiting BNO055_MODE_SWITCHING_DELAY
+    SAVE_WAIT,     // fully calibrated, switched to CONFIG to read its profile
+};
+
+// Value reported for a channel while its sensor is not healthy
+enum class SubstitutePolicy {
+    HOLD_LAST_GOOD,
+    EXTRAPOLATE,    // continue the last good slope, then hold
+};
+
+struct SensorHealthConfig {
+    u8 operation_mode = BNO055_OPERATION_MODE_NDOF;
+    int failures_before_reinit = 3;      // consecutive failed reads
+    int zero_reads_before_check = 5;     // consecutive exact zeros before checking OPR_MODE
+    int64_t retry_initial_ns = 100000000;   // first re-init back-off
+    int64_t retry_max_ns = 2000000000;      // back-off doubles up to this
+    SubstitutePolicy policy = SubstitutePolicy::HOLD_LAST_GOOD;
+    int64_t max_extrapolation_ns = 200000000;
+    // Save a profile mid-run as soon as the sensor is fully calibrated. Costs
+    // that sensor about 640 ms of stand-ins and a fusion restart, so leave it
+    // off while torque is applied.
+    bool save_calibration_while_running = false;
+    int64_t calibration_poll_ns = 1000000000;  // CALIB_STAT check of a sensor not saved yet
+};
+
+/**
+ * @brief Detects dead sensors and brings them back without stalling the sweep.
+ *
+ * A channel is declared failed after a run of failed reads, or when it keeps
+ * reading exactly zero and OPR_MODE shows the sensor fell back to CONFIG (a
+ * BNO055 that browned out or was re-plugged comes back in CONFIG mode and
+ * outputs zeros).
+ *
+ * Recovery replaces the blocking init + set_operation_mode() with a state
+ * machine that is advanced by step() once per sweep: init() and each OPR_MODE
+ * write are a few short transactions, the 20 ms and 600 ms mode switch delays
+ * are deadlines checked on later sweeps, and at most one bus action is taken
+ * per step, so a sweep never grows by more than one short exchange. Failed
+ * attempts back off exponentially. A re-initialised sensor gets its
+ * calibration profile back in CONFIG, before the switch to the fusion mode.
+ *
+ * With save_calibration_while_running and a save hook set, a healthy
+ * sensor's CALIB_STAT is polled until it is fully calibrated; the sensor then
+ * takes one round trip through CONFIG (about 640 ms, stand-ins meanwhile) so
+ * its profile can be read and kept. That is tried once per sensor.
+ *
+ * Until a channel is healthy again its roll is filled with a stand-in (see
+ * SubstitutePolicy), flagged in ImuFrame::substituted_mask, so the model never
+ * sees the 0.0 of a failed read.
+ *
+ * Must be used from the thread that drives the sensors (the acquisition thread).
+ */
+class SensorHealthMonitor {
+  public:
+    explicit SensorHealthMonitor(std::vector<Bno055Device>& sensors,
+                                 SensorHealthConfig config = SensorHealthConfig());
+
+    using ChannelHook = std::function<void(size_t i)>;
+    // Runs before the monitor addresses sensor i, e.g. to close the other
+    // muxes on the bus so sensors sharing its address stay quiet
+    void set_isolate(ChannelHook fn) { isolate_ = std::move(fn); }
+    // Runs in CONFIG mode during recovery to write sensor i's calibration profile
+    void set_restore_calibration(ChannelHook fn) { restore_calibration_ = std::move(fn); }
+    // Runs in CONFIG mode once sensor i reached CALIB_STAT 0xFF, to read and
+    // keep its profile; true when it was saved
+    using SaveHook = std::function<bool(size_t i)>;
+    void set_save_calibration(SaveHook fn) { save_calibration_ = std::move(fn); }
+
+    // Sensor i's profile is on file already (restored at start-up or saved), no need to save it
+    void mark_calibration_saved(size_t i) { channels_[i].calibration_saved = true; }
+    bool calibration_saved(size_t i) const { return channels_[i].calibration_saved; }
+
+    // True when channel i should be read this sweep
+    bool usable(size_t i) const { return channels_[i].state == SensorState::HEALTHY; }
+
+    // Result of this sweep's read of channel i
+    void report_read(size_t i, bool ok, int16_t roll, int64_t t_ns);
+
+    // Channel i was not due this sweep (rate schedule), its last result stands
+    void report_skipped(size_t i);
+
+    // Puts a sensor straight into recovery, e.g. when the startup init failed
+    void mark_failed(size_t i, int64_t now_ns);
+
+    // Fills stand-ins for every channel without a good read this sweep and
+    // advances recovery. Call once per sweep after the reads.
+    void step(ImuFrame& frame, int64_t now_ns);
+
+    SensorState state(size_t i) const { return channels_[i].state; }
+    uint64_t reinit_attempts() const { return reinit_attempts_; }
+    uint64_t recoveries() const { return recoveries_; }
+
+  private:
+    struct Channel {
+        SensorState state = SensorState::HEALTHY;
+        int failures = 0;
+        int zero_reads = 0;
+        bool read_ok = false;       // good read this sweep
+        bool last_ok = false;       // outcome of the last read that was made
+        bool check_mode = false;    // zero run seen, confirm OPR_MODE
+        bool zero_verified = false; // OPR_MODE fine during this zero run, zeros are real
+        int64_t deadline_ns = 0;    // next attempt / end of the current wait
+        int64_t backoff_ns = 0;
+        bool calibration_saved = false;
+        bool save_tried = false;          // a failed save is not retried mid-run
+        int64_t calibration_poll_ns = 0;  // next CALIB_STAT check
+
+        bool have_good = false;
+        int16_t last_roll = 0;
+        int64_t last_ns = 0;
+        int16_t prev_roll = 0;
+        int64_t prev_ns = 0;
+    };
+
+    void fail(Channel& ch, int64_t now_ns);
+    bool advance(size_t i, int64_t now_ns);  // true when it used the bus
+    void isolate(size_t i);                  // before every bus action on sensor i
+    bool poll_calibration(size_t i, int64_t now_ns);  // HEALTHY: true when it used the bus
+    void start_fusion(Channel& ch, Bno055Device& dev, int64_t now_ns);  // from CONFIG
+    int16_t substitute(const Channel& ch, int64_t now_ns) const;
+
+    std::vector<Bno055Device>& sensors_;
+    SensorHealthConfig config_;
+    ChannelHook isolate_;
+    ChannelHook restore_calibration_;
+    SaveHook save_calibration_;
+    std::vector<Channel> channels_;
+    size_t next_recovery_;  // round robin start for recovery actions
+    uint64_t reinit_attempts_;
+    uint64_t recoveries_;
+};
+
+#endif // SENSOR_HEALTH_H
@@ -1,69 +1,101 @@
 #include "sensor_preprocessing.h"
-#include <deque>
-#include <numeric>
-#include <cmath>
+#include <algorithm>
+#include "simd_lanes.h"
 
-static void fix_flip(std::vector<float>& signal, float diff_max, int section_size) {
-    if (signal.empty()) return;
-    std::vector<float> new_data;
-    new_data.reserve(signal.size());
-    new_data.push_back(signal[0]);
+void process_sensor_data(std::vector<std::vector<float>>& data, int section_size, float diff_max) {
+    if (data.empty() || data[0].size() != 6) return;
 
-    for (size_t i = 1; i < signal.size(); ++i) {
-        int start = std::max(static_cast<int>(i) - section_size, 0);
-        float mean_recent = std::accumulate(new_data.begin() + start, new_data.end(), 0.0f) / (i - start);
-        float diff = signal[i] - mean_recent;
+    // One contiguous [timesteps][6] copy, processed in place
+    std::vector<float> frames(data.size() * 6);
+    for (size_t t = 0; t < data.size(); ++t)
+        std::copy(data[t].begin(), data[t].begin() + 6, frames.begin() + t * 6);
 
-        if (diff > diff_max)
-            new_data.push_back(signal[i] - 360.0f);
-        else if (diff < -diff_max)
-            new_data.push_back(signal[i] + 360.0f);
-        else
-            new_data.push_back(signal[i]);
-    }
+    StreamingPreprocessor preprocessor(6, section_size, diff_max);
+    preprocessor.push(frames.data(), frames.data(), data.size());
 
-    signal = std::move(new_data);
+    for (size_t t = 0; t < data.size(); ++t)
+        std::copy(frames.begin() + t * 6, frames.begin() + (t + 1) * 6, data[t].begin());
 }
 
-static void normalize(std::vector<float>& signal, int section_size) {
-    if (signal.empty()) return;
-
-    std::deque<float> window;
-    float total = 0.0f;
-    std::vector<float> normalized;
-    normalized.reserve(signal.size());
+void standardize_frames(const float* in, float* out, size_t frames, size_t channels, const float* mean,
+                        const float* scale) {
+    // The rows run on as one flat array, with mean and scale repeated until
+    // they line up with the lanes again: 24 floats, 4 frames, for 6 channels
+    size_t period = channels;
+    while (period % simd::LANES != 0) period += channels;
+    const size_t MAX_PERIOD = 64;
+    if (period > MAX_PERIOD) {
+        for (size_t t = 0; t < frames; ++t)
+            for (size_t j = 0; j < channels; ++j)
+                out[t * channels + j] = (in[t * channels + j] - mean[j]) / scale[j];
+        return;
+    }
+    float means[MAX_PERIOD], scales[MAX_PERIOD];
+    for (size_t k = 0; k < period; ++k) {
+        means[k] = mean[k % channels];
+        scales[k] = scale[k % channels];
+    }
 
-    for (size_t i = 0; i < signal.size(); ++i) {
-        if (window.size() >= section_size) {
-            total -= window.front();
-            window.pop_front();
-        }
-        window.push_back(signal[i]);
-        total += signal[i];
-        float mean = total / static_cast<float>(window.size());
-        normalized.push_back(signal[i] - mean);
+    const size_t count = frames * channels;
+    size_t k = 0;
+    for (size_t i = 0; i < count; i += simd::LANES) {
+        const size_t n = std::min(simd::LANES, count - i);
+        simd::F8 x = simd::load_n(in + i, n);
+        // Padding lanes divide 0 by 0 and are never stored
+        simd::store_n(out + i, (x - simd::load(means + k)) / simd::load(scales + k), n);
+        k += simd::LANES;
+        if (k == period) k = 0;
     }
+}
 
-    signal = std::move(normalized);
+StreamingPreprocessor::StreamingPreprocessor(size_t channels, int section_size, float diff_max)
+    : channels_(channels), lanes_((channels + simd::LANES - 1) / simd::LANES * simd::LANES),
+      section_size_(static_cast<size_t>(std::max(section_size, 1))), diff_max_(diff_max), frames_(0) {
+    reset();
 }
 
-void process_sensor_data(std::vector<std::vector<float>>& data, int section_size, float diff_max) {
-    if (data.empty() || data[0].size() != 6) return;
+void StreamingPreprocessor::reset() {
+    recent_.assign(section_size_ * lanes_, 0.0f);
+    total_.assign(lanes_, 0.0f);
+    frames_ = 0;
+}
 
-    // Transpose data to [6][timesteps]
-    std::vector<std::vector<float>> channels(6, std::vector<float>(data.size()));
-    for (size_t t = 0; t < data.size(); ++t)
-        for (size_t j = 0; j < 6; ++j)
-            channels[j][t] = data[t][j];
+void StreamingPreprocessor::push(const float* in, float* out, size_t frames) {
+    const simd::F8 turn = simd::set1(360.0f);
+    const simd::F8 upper = simd::set1(diff_max_);
+    const simd::F8 lower = simd::set1(-diff_max_);
 
-    // Process each channel
-    for (int j = 0; j < 6; ++j) {
-        fix_flip(channels[j], diff_max, section_size);
-        normalize(channels[j], section_size);
-    }
+    // Channels are independent, so each block of lanes runs through all the
+    // frames with its sums kept in registers
+    for (size_t b = 0; b < lanes_; b += simd::LANES) {
+        const size_t n = std::min(simd::LANES, channels_ - b);
+        simd::F8 total = simd::load(&total_[b]);
+        size_t slot = frames_ % section_size_;
 
-    // Transpose back to [timesteps][6]
-    for (size_t t = 0; t < data.size(); ++t)
-        for (size_t j = 0; j < 6; ++j)
-            data[t][j] = channels[j][t];
+        for (size_t t = 0; t < frames; ++t) {
+            const size_t i = frames_ + t;
+            const size_t at = t * channels_ + b;
+            simd::F8 value = simd::load_n(in + at, n);
+
+            // fix_flip against the mean of the previous min(i, section_size) samples
+            if (i > 0) {
+                simd::F8 mean_recent = total / simd::set1(static_cast<float>(std::min(i, section_size_)));
+                simd::F8 diff = value - mean_recent;
+                value = simd::select(diff > upper, value - turn, simd::select(diff < lower, value + turn, value));
+            }
+
+            // Both running sums drop the oldest sample and take this one, in that order
+            float* oldest = &recent_[slot * lanes_ + b];
+            if (i >= section_size_) total = total - simd::load(oldest);
+            simd::store(oldest, value);
+            total = total + value;
+            if (++slot == section_size_) slot = 0;
+
+            // normalize against the mean including this sample
+            simd::F8 mean = total / simd::set1(static_cast<float>(std::min(i + 1, section_size_)));
+            simd::store_n(out + at, value - mean, n);
+        }
+        simd::store(&total_[b], total);
+    }
+    frames_ += frames;
 }
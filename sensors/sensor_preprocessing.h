@@ -1,6 +1,57 @@
 #pragma once
+#include <stddef.h>
 #include <vector>
 
 // Input: 2D vector of sensor data with shape [timesteps][6]
 // Output: processed in-place
+//
+// Per channel, fix_flip undoes 360 degree wraps against the mean of the
+// previous section_size (>= 1) unwrapped samples, then normalize subtracts
+// the mean of the last section_size unwrapped samples. Both keep running
+// sums, so a row only depends on the rows before it. Runs as one
+// StreamingPreprocessor pass over the rows.
 void process_sensor_data(std::vector<std::vector<float>>& data, int section_size = 100, float diff_max = 200.0f);
+
+/**
+ * @brief (x - mean) / scale per channel, the model's input standardization.
+ *
+ * in and out are [frames][channels] interleaved and may be the same buffer.
+ * Vectorized across channels (simd_lanes.h); each value is the float the
+ * scalar expression gives.
+ */
+void standardize_frames(const float* in, float* out, size_t frames, size_t channels, const float* mean,
+                        const float* scale);
+
+/**
+ * @brief process_sensor_data() one frame at a time.
+ *
+ * Keeps the running sums and the last section_size unwrapped samples per
+ * channel, so each frame costs O(1) per channel. The output for every frame
+ * is bit for bit the row process_sensor_data() gives over all frames pushed
+ * since the last reset().
+ *
+ * Channels are processed eight at a time in the interleaved layout, with
+ * AVX, SSE2 or NEON where available (simd_lanes.h).
+ */
+class StreamingPreprocessor {
+  public:
+    explicit StreamingPreprocessor(size_t channels = 6, int section_size = 100, float diff_max = 200.0f);
+
+    // Processes the next frame (channels values); in and out may be the same
+    void push(const float* in, float* out) { push(in, out, 1); }
+    // Processes frames consecutive [frames][channels] rows; in and out may be the same
+    void push(const float* in, float* out, size_t frames);
+    void reset();
+
+    size_t channels() const { return channels_; }
+    size_t frames() const { return frames_; }
+
+  private:
+    size_t channels_;
+    size_t lanes_;               // channels rounded up to whole blocks of lanes
+    size_t section_size_;
+    float diff_max_;
+    size_t frames_;
+    std::vector<float> recent_;  // [section_size][lanes] last unwrapped samples, a ring
+    std::vector<float> total_;   // [lanes] their running sums
+};
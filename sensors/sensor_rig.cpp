@@ -0,0 +1,402 @@
+#include "sensor_rig.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace {
+
+// Stands in for an adapter the factory could not provide, every transfer fails
+class MissingI2CBus : public I2CBus {
+  public:
+    int open() override { return -1; }
+    bool is_open() const override { return false; }
+    s8 read(u8, u8, u8*, u8) override { return BNO055_ERROR; }
+    s8 write(u8, u8, const u8*, u8) override { return BNO055_ERROR; }
+    s8 send_byte(u8, u8) override { return BNO055_ERROR; }
+    s8 receive_byte(u8, u8*) override { return BNO055_ERROR; }
+};
+
+MissingI2CBus missing_bus;
+
+}  // namespace
+
+SensorRig::SensorRig(const SensorTopology& topology, uint32_t quantities, SensorHealthConfig health)
+    : topology_(topology), plan_(bno055_plan_read(quantities)), health_config_(health),
+      calibration_(nullptr), sensor_count_(0), restored_(0), generation_(0), pending_(0), stopping_(false) {
+    build([this](const std::string& device) -> I2CBus* {
+        owned_buses_.emplace_back(new I2CDevBus(device));
+        return owned_buses_.back().get();
+    });
+}
+
+SensorRig::SensorRig(const SensorTopology& topology, BusFactory factory, uint32_t quantities,
+                     SensorHealthConfig health)
+    : topology_(topology), plan_(bno055_plan_read(quantities)), health_config_(health),
+      calibration_(nullptr), sensor_count_(0), restored_(0), generation_(0), pending_(0), stopping_(false) {
+    build(factory);
+}
+
+SensorRig::~SensorRig() {
+    stop_workers();
+}
+
+void SensorRig::build(const BusFactory& factory) {
+    if (topology_.size() > IMU_CHANNELS) {
+        std::cerr << "Sensor topology has " << topology_.size() << " sensors, a frame has only "
+                  << IMU_CHANNELS << " channels" << std::endl;
+        return;
+    }
+    for (size_t ch = 0; ch < topology_.size(); ch++) {
+        const SensorPlacement& p = topology_[ch];
+
+        BusGroup* group = nullptr;
+        for (auto& g : groups_) {
+            if (g->device == p.bus) group = g.get();
+        }
+        if (group == nullptr) {
+            groups_.emplace_back(new BusGroup());
+            group = groups_.back().get();
+            group->device = p.bus;
+            group->bus = factory(p.bus);
+            if (group->bus == nullptr) {
+                std::cerr << "No I2C bus " << p.bus << ", its sensors stay offline" << std::endl;
+                group->bus = &missing_bus;
+            }
+        }
+
+        int mux = -1;
+        if (p.mux_addr >= 0) {
+            for (size_t m = 0; m < group->mux_addrs.size(); m++) {
+                if (group->mux_addrs[m] == p.mux_addr) mux = static_cast<int>(m);
+            }
+            if (mux < 0) {
+                group->muxes.emplace_back(new rpi_tca9548a());
+                group->mux_addrs.push_back(p.mux_addr);
+                mux = static_cast<int>(group->muxes.size() - 1);
+            }
+        }
+
+        group->sensor_mux.push_back(mux);
+        group->sensors.emplace_back(*group->bus, p.dev_addr,
+                                    mux >= 0 ? group->muxes[mux].get() : nullptr, p.channel);
+        group->frame_channel.push_back(ch);
+
+        // Stagger sensors with the same divisor over the sweeps
+        int divisor = std::max(p.divisor, 1);
+        int same = static_cast<int>(std::count(group->divisor.begin(), group->divisor.end(), divisor));
+        group->divisor.push_back(divisor);
+        group->phase.push_back(same % divisor);
+        sensor_count_++;
+    }
+
+    // The sensor vectors are final now, the monitors keep references into them
+    for (auto& g : groups_) {
+        BusGroup* group = g.get();
+        g->health.reset(new SensorHealthMonitor(g->sensors, health_config_));
+        g->health->set_isolate([this, group](size_t k) { isolate(*group, k); });
+        g->health->set_restore_calibration([this, group](size_t k) { restore_calibration(*group, k); });
+    }
+}
+
+int SensorRig::init() {
+    if (topology_.size() > IMU_CHANNELS) return -1;  // reported by build()
+
+    for (auto& g : groups_) {
+        BusGroup& group = *g;
+        if (group.bus->open() != 0) {
+            std::cerr << "Failed to open I2C bus " << group.device << std::endl;
+        }
+        for (size_t m = 0; m < group.muxes.size(); m++) {
+            if (group.muxes[m]->init(group.mux_addrs[m], *group.bus) != 0) {
+                std::cerr << "Failed to initialize mux 0x" << std::hex << group.mux_addrs[m]
+                          << std::dec << " on " << group.device << std::endl;
+            }
+        }
+        group.starting.assign(group.sensors.size(), true);
+        group.probed.assign(group.sensors.size(), false);
+        if (calibration_ != nullptr) {
+            BusGroup* owner = &group;
+            group.health->set_save_calibration([this, owner](size_t k) { return save_profile(*owner, k); });
+        }
+    }
+
+    // Each stage touches every sensor before anything waits, so the whole
+    // rig pays for one CONFIG switch and one fusion switch instead of one of
+    // each per sensor
+    probe_all();
+
+    bool leaving_fusion = false;
+    for_each_starting("switch to CONFIG", [&](BusGroup&, size_t, Bno055Device& imu) {
+        if (imu.operation_mode() == BNO055_OPERATION_MODE_CONFIG) return true;
+        leaving_fusion = true;
+        return imu.write_operation_mode(BNO055_OPERATION_MODE_CONFIG) == BNO055_SUCCESS;
+    });
+    if (leaving_fusion) delay_ms(BNO055_CONFIG_MODE_SWITCHING_DELAY);
+
+    for_each_starting("restore calibration of", [&](BusGroup& group, size_t k, Bno055Device&) {
+        if (!restore_calibration(group, k)) return true;
+        restored_++;
+        group.health->mark_calibration_saved(k);
+        return true;
+    });
+
+    u8 mode = health_config_.operation_mode;
+    for_each_starting("set operation mode of", [&](BusGroup&, size_t, Bno055Device& imu) {
+        return imu.write_operation_mode(mode) == BNO055_SUCCESS;
+    });
+    if (mode != BNO055_OPERATION_MODE_CONFIG) delay_ms(BNO055_MODE_SWITCHING_DELAY);
+
+    int ready = 0;
+    for_each_starting("confirm operation mode of", [&](BusGroup&, size_t, Bno055Device& imu) {
+        u8 current = 0;
+        if (imu.get_operation_mode(&current) != BNO055_SUCCESS || current != mode) return false;
+        ready++;
+        return true;
+    });
+
+    // The first bus is swept by the caller, every other one by its own thread
+    for (size_t i = 1; i < groups_.size(); i++) {
+        if (!groups_[i]->worker.joinable()) {
+            groups_[i]->worker = std::thread(&SensorRig::worker, this, groups_[i].get());
+        }
+    }
+    return ready;
+}
+
+void SensorRig::probe_all() {
+    // A sensor still booting (or resetting) NACKs; it is tried again after
+    // the others rather than holding them up, until the window closes
+    int64_t deadline = monotonic_ns() + PROBE_WINDOW_MS * 1000000LL;
+    bool pending = true;
+    while (pending) {
+        pending = false;
+        for (auto& g : groups_) {
+            BusGroup& group = *g;
+            for (size_t k = 0; k < group.sensors.size(); k++) {
+                if (!group.starting[k] || group.probed[k]) continue;
+                isolate(group, k);
+                group.probed[k] = group.sensors[k].init() == BNO055_SUCCESS;
+                if (!group.probed[k]) pending = true;
+            }
+        }
+        if (!pending || monotonic_ns() >= deadline) break;
+        delay_ms(PROBE_RETRY_MS);
+    }
+
+    for_each_starting("probe", [&](BusGroup& group, size_t k, Bno055Device&) {
+        return group.probed[k];
+    });
+}
+
+void SensorRig::for_each_starting(const char* stage,
+                                  const std::function<bool(BusGroup&, size_t, Bno055Device&)>& fn) {
+    for (auto& g : groups_) {
+        BusGroup& group = *g;
+        for (size_t k = 0; k < group.sensors.size(); k++) {
+            if (!group.starting[k]) continue;
+            Bno055Device& imu = group.sensors[k];
+            isolate(group, k);
+            if (fn(group, k, imu)) continue;
+
+            std::cerr << "Failed to " << stage << " sensor 0x" << std::hex << static_cast<int>(imu.dev_addr())
+                      << std::dec << " on " << group.device << " channel " << imu.channel()
+                      << ", retrying in the background" << std::endl;
+            group.starting[k] = false;
+            group.health->mark_failed(k, monotonic_ns());
+        }
+    }
+}
+
+void SensorRig::delay_ms(int ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+bool SensorRig::restore_calibration(BusGroup& group, size_t k) {
+    Bno055CalibrationProfile profile;
+    const SensorPlacement& placement = topology_[group.frame_channel[k]];
+    if (calibration_ == nullptr || calibration_->load(placement, profile) != 0) return false;
+
+    // A sensor without its profile still works, it just needs calibrating again
+    if (group.sensors[k].write_calibration_profile(profile) != BNO055_SUCCESS) {
+        std::cerr << "Failed to restore calibration from " << calibration_->path_for(placement) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool SensorRig::save_profile(BusGroup& group, size_t k) {
+    Bno055CalibrationProfile profile;
+    const SensorPlacement& placement = topology_[group.frame_channel[k]];
+    if (group.sensors[k].read_calibration_profile(&profile) != BNO055_SUCCESS ||
+        calibration_->save(placement, profile) != 0) {
+        std::cerr << "Failed to save calibration of sensor " << group.frame_channel[k] << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void SensorRig::isolate(BusGroup& group, size_t k) {
+    if (group.muxes.size() < 2 && group.sensor_mux[k] >= 0) return;
+    for (size_t m = 0; m < group.muxes.size(); m++) {
+        if (static_cast<int>(m) != group.sensor_mux[k]) group.muxes[m]->no_channel();
+    }
+}
+
+void SensorRig::sweep_group(BusGroup& group) {
+    // roll and sample_ns of sensors that are not due stay from the last sweep
+    ImuFrame& out = group.partial;
+    uint8_t last_valid = out.valid_mask;
+    out.valid_mask = 0;
+    out.substituted_mask = 0;
+    out.fresh_mask = 0;
+    uint64_t tick = group.tick++;
+
+    for (size_t k = 0; k < group.sensors.size(); k++) {
+        if (!group.health->usable(k)) continue;
+
+        uint8_t bit = static_cast<uint8_t>(1u << k);
+        bool due = tick % group.divisor[k] == static_cast<uint64_t>(group.phase[k]);
+        if (!due && (last_valid & bit)) {
+            out.valid_mask |= bit;
+            group.health->report_skipped(k);
+            continue;
+        }
+        isolate(group, k);
+
+        Bno055Sample sample;
+        int64_t read_start = monotonic_ns();
+        bool ok = group.sensors[k].read(plan_, &sample) == BNO055_SUCCESS;
+        int64_t t = read_start + (monotonic_ns() - read_start) / 2;
+
+        if (ok) {
+            out.roll[k] = sample.euler[1];
+            out.sample_ns[k] = t;
+            out.valid_mask |= bit;
+            out.fresh_mask |= bit;
+        } else if (group.sensor_mux[k] >= 0) {
+            // The mux may have reset with the sensor, re-write it next time
+            group.muxes[group.sensor_mux[k]]->invalidate();
+        }
+        group.health->report_read(k, ok, ok ? sample.euler[1] : 0, t);
+    }
+    group.health->step(out, monotonic_ns());
+}
+
+void SensorRig::worker(BusGroup* group) {
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        start_cv_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+        if (stopping_) return;
+        seen = generation_;
+
+        lock.unlock();
+        sweep_group(*group);
+        lock.lock();
+
+        if (--pending_ == 0) done_cv_.notify_one();
+    }
+}
+
+void SensorRig::sweep(ImuFrame& frame) {
+    if (groups_.empty()) return;
+
+    if (groups_.size() > 1) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_ = groups_.size() - 1;
+        generation_++;
+    }
+    start_cv_.notify_all();
+    sweep_group(*groups_[0]);
+
+    if (groups_.size() > 1) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_cv_.wait(lock, [&] { return pending_ == 0; });
+    }
+
+    // Merge into topology order
+    frame.valid_mask = 0;
+    frame.substituted_mask = 0;
+    frame.fresh_mask = 0;
+    for (auto& g : groups_) {
+        const ImuFrame& partial = g->partial;
+        for (size_t k = 0; k < g->sensors.size(); k++) {
+            size_t ch = g->frame_channel[k];
+            frame.roll[ch] = partial.roll[k];
+            frame.sample_ns[ch] = partial.sample_ns[k];
+            if (partial.valid_mask & (1u << k)) frame.valid_mask |= static_cast<uint8_t>(1u << ch);
+            if (partial.substituted_mask & (1u << k)) frame.substituted_mask |= static_cast<uint8_t>(1u << ch);
+            if (partial.fresh_mask & (1u << k)) frame.fresh_mask |= static_cast<uint8_t>(1u << ch);
+        }
+    }
+}
+
+void SensorRig::close_muxes() {
+    for (auto& g : groups_) {
+        for (auto& mux : g->muxes) mux->no_channel();
+    }
+}
+
+bool SensorRig::locate(size_t channel, BusGroup** group, size_t* k) {
+    for (auto& g : groups_) {
+        for (size_t i = 0; i < g->frame_channel.size(); i++) {
+            if (g->frame_channel[i] != channel) continue;
+            *group = g.get();
+            *k = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+s8 SensorRig::read_calibration_status(size_t channel, u8* status) {
+    BusGroup* group = nullptr;
+    size_t k = 0;
+    if (!locate(channel, &group, &k) || !group->health->usable(k)) return BNO055_ERROR;
+    isolate(*group, k);
+    return group->sensors[k].read_calibration_status(status);
+}
+
+int SensorRig::save_calibration() {
+    if (calibration_ == nullptr) return 0;
+
+    int saved = 0;
+    for (size_t ch = 0; ch < topology_.size(); ch++) {
+        BusGroup* group = nullptr;
+        size_t k = 0;
+        u8 status = 0;
+        // Restored at start-up or saved already: its file is current, skip the CONFIG round trip
+        if (!locate(ch, &group, &k) || group->health->calibration_saved(k)) continue;
+        if (read_calibration_status(ch, &status) != BNO055_SUCCESS || status != BNO055_CALIB_STAT_FULL) {
+            continue;
+        }
+
+        if (!save_profile(*group, k)) continue;
+        group->health->mark_calibration_saved(k);
+        saved++;
+    }
+    return saved;
+}
+
+void SensorRig::stop_workers() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    start_cv_.notify_all();
+    for (auto& g : groups_) {
+        if (g->worker.joinable()) g->worker.join();
+    }
+}
+
+uint64_t SensorRig::reinit_attempts() const {
+    uint64_t total = 0;
+    for (const auto& g : groups_) total += g->health->reinit_attempts();
+    return total;
+}
+
+uint64_t SensorRig::recoveries() const {
+    uint64_t total = 0;
+    for (const auto& g : groups_) total += g->health->recoveries();
+    return total;
+}
@@ -0,0 +1,165 @@
+#ifndef SENSOR_RIG_H
+#define SENSOR_RIG_H
+
+#include <stdint.h>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "bno055_calibration.h"
+#include "bno055_device.h"
+#include "bno055_read_plan.h"
+#include "i2c_bus.h"
+#include "i2c_dev_bus.h"
+#include "imu_acquisition.h"
+#include "rpi_tca9548a.h"
+#include "sensor_health.h"
+#include "sensor_topology.h"
+
+/**
+ * @brief Every sensor of a SensorTopology, grouped per I2C adapter, swept with
+ * one thread per adapter.
+ *
+ * Sensors on different adapters are independent buses, so they are read
+ * concurrently and a sweep takes as long as the slowest bus instead of the
+ * sum of all of them. The calling thread sweeps the first bus itself, each
+ * further bus has a worker thread that is released at the start of a sweep;
+ * the partial frames are merged into frame channel order once all buses are
+ * done.
+ *
+ * A sensor with a rate divisor n is read on every n-th sweep only, the sweeps
+ * in between carry its last sample (valid, not fresh, with its own
+ * sample_ns). Sensors sharing a divisor on a bus get staggered phases so the
+ * saved bus time is spread evenly over the sweeps. A sensor whose last read
+ * did not give a good value is read on the next sweep regardless.
+ *
+ * Every bus has its own multiplexers and SensorHealthMonitor, so sensors are
+ * only ever touched by the thread that owns their bus. When several muxes
+ * share an adapter, the others are closed before a sensor is addressed, by
+ * the sweep and by recovery alike, so that sensors with the same address
+ * never answer together. A recovered sensor gets its stored profile back.
+ */
+class SensorRig {
+  public:
+    // Returns the bus for an adapter name, nullptr if it does not exist.
+    // The bus has to outlive the rig.
+    using BusFactory = std::function<I2CBus*(const std::string& device)>;
+
+    // Opens every adapter named in the topology through i2c-dev
+    explicit SensorRig(const SensorTopology& topology,
+                       uint32_t quantities = BNO055_Q_EULER_ROLL,
+                       SensorHealthConfig health = SensorHealthConfig());
+    SensorRig(const SensorTopology& topology, BusFactory factory,
+              uint32_t quantities = BNO055_Q_EULER_ROLL,
+              SensorHealthConfig health = SensorHealthConfig());
+    ~SensorRig();
+
+    SensorRig(const SensorRig&) = delete;
+    SensorRig& operator=(const SensorRig&) = delete;
+
+    // Profiles restored by init() and written by save_calibration() (or by the
+    // sweeps with SensorHealthConfig::save_calibration_while_running); call before init()
+    void set_calibration_store(const CalibrationStore* store) { calibration_ = store; }
+
+    /**
+     * Opens the buses and muxes, initialises every sensor, restores its
+     * calibration profile when the store has one and switches it to the
+     * health config's operation mode. Sensors that fail are left to their
+     * bus' health monitor. Starts the per-bus worker threads.
+     *
+     * Sensors are started in stages across the whole rig: chip-id probes in
+     * rounds over all channels, then every CONFIG switch, every profile,
+     * every fusion mode write, and only then one shared mode switching delay.
+     * Start-up takes about one BNO055_MODE_SWITCHING_DELAY however many
+     * sensors there are.
+     *
+     * @return Number of sensors that came up, -1 when the topology has more
+     *         sensors than a frame has channels (none are built then).
+     */
+    int init();
+
+    // One sweep over every sensor that is due, buses in parallel. Fills roll,
+    // sample_ns, valid_mask, substituted_mask and fresh_mask in topology order.
+    void sweep(ImuFrame& frame);
+
+    // Opens no channel on any mux (shutdown)
+    void close_muxes();
+
+    // Between sweeps only: CALIB_STAT of the sensor filling frame channel
+    s8 read_calibration_status(size_t channel, u8* status);
+
+    /**
+     * Saves the profile of every fully calibrated sensor to the store,
+     * skipping the ones whose profile was restored at start-up or saved
+     * already. Each one saved is switched to CONFIG and back, so only call
+     * with sweeps stopped.
+     *
+     * @return Number of profiles saved.
+     */
+    int save_calibration();
+
+    size_t restored_profiles() const { return restored_; }  // by init(); recoveries restore too
+
+    size_t sensor_count() const { return sensor_count_; }  // sensors built, one per frame channel
+    size_t bus_count() const { return groups_.size(); }
+    const SensorPlacement& placement(size_t channel) const { return topology_[channel]; }
+
+    // Summed over buses; only stable once sweeps have stopped
+    uint64_t reinit_attempts() const;
+    uint64_t recoveries() const;
+
+  private:
+    static constexpr int PROBE_WINDOW_MS = 100;  // how long a NACKing sensor is retried at start-up
+    static constexpr int PROBE_RETRY_MS = 5;
+
+    struct BusGroup {
+        std::string device;
+        I2CBus* bus = nullptr;
+        std::vector<std::unique_ptr<rpi_tca9548a>> muxes;
+        std::vector<int> mux_addrs;         // address of muxes[m], set up in init()
+        std::vector<int> sensor_mux;        // index into muxes, -1 when directly attached
+        std::vector<Bno055Device> sensors;
+        std::vector<size_t> frame_channel;  // sensors[k] fills frame channel frame_channel[k]
+        std::vector<int> divisor;           // sensors[k] is read when tick % divisor[k] == phase[k]
+        std::vector<int> phase;
+        uint64_t tick = 0;
+        std::vector<bool> starting;         // still on its way up in init()
+        std::vector<bool> probed;           // answered the chip-id probe in init()
+        std::unique_ptr<SensorHealthMonitor> health;
+        ImuFrame partial;                   // local sensor order, kept between sweeps
+        std::thread worker;
+    };
+
+    void build(const BusFactory& factory);
+    bool locate(size_t channel, BusGroup** group, size_t* k);
+    void probe_all();
+    // Runs fn on every sensor still starting; a false return hands it to the health monitor
+    void for_each_starting(const char* stage, const std::function<bool(BusGroup&, size_t, Bno055Device&)>& fn);
+    static void delay_ms(int ms);
+    bool restore_calibration(BusGroup& group, size_t k);  // in CONFIG, before the fusion mode
+    bool save_profile(BusGroup& group, size_t k);         // switches to CONFIG and back unless in it
+    void isolate(BusGroup& group, size_t k);  // closes the muxes not in front of sensor k
+    void sweep_group(BusGroup& group);
+    void worker(BusGroup* group);
+    void stop_workers();
+
+    SensorTopology topology_;
+    Bno055ReadPlan plan_;
+    SensorHealthConfig health_config_;
+    const CalibrationStore* calibration_;
+    size_t sensor_count_;
+    size_t restored_;
+    std::vector<std::unique_ptr<I2CDevBus>> owned_buses_;  // declared before groups_, outlives them
+    std::vector<std::unique_ptr<BusGroup>> groups_;
+
+    std::mutex mutex_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+    uint64_t generation_;
+    size_t pending_;
+    bool stopping_;
+};
+
+#endif // SENSOR_RIG_H
@@ -0,0 +1,80 @@
+#include "sensor_topology.h"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include "imu_acquisition.h"
+
+static const int DEFAULT_MUX_ADDR = 0x70;
+static const size_t DEFAULT_SENSOR_COUNT = 6;
+
+SensorTopology default_topology() {
+    SensorTopology topology;
+    for (size_t i = 0; i < DEFAULT_SENSOR_COUNT; i++) {
+        topology.push_back({"/dev/i2c-1", DEFAULT_MUX_ADDR, static_cast<int>(i), BNO055_I2C_ADDR2});
+    }
+    return topology;
+}
+
+// "-" maps to -1, anything else is an integer in any C base
+static bool parse_field(const std::string& field, int* value) {
+    if (field == "-") {
+        *value = -1;
+        return true;
+    }
+    try {
+        size_t used = 0;
+        *value = std::stoi(field, &used, 0);
+        return used == field.size();
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+int parse_topology(const std::string& text, SensorTopology& topology) {
+    topology.clear();
+    std::istringstream lines(text);
+    std::string line;
+    int line_no = 0;
+
+    while (std::getline(lines, line)) {
+        line_no++;
+        size_t hash = line.find('#');
+        if (hash != std::string::npos) line.erase(hash);
+
+        std::istringstream fields(line);
+        std::string bus, mux, channel, addr;
+        if (!(fields >> bus)) continue;  // blank or comment only
+
+        SensorPlacement placement;
+        int dev_addr = 0;
+        std::string every, extra;
+        bool ok = static_cast<bool>(fields >> mux >> channel >> addr);
+        if (ok && (fields >> every)) ok = !(fields >> extra) && parse_field(every, &placement.divisor);
+        if (!ok || !parse_field(mux, &placement.mux_addr) || !parse_field(channel, &placement.channel) ||
+            !parse_field(addr, &dev_addr) || dev_addr < 0 || dev_addr > 0x7F || placement.divisor < 1 ||
+            (placement.mux_addr >= 0 && (placement.channel < 0 || placement.channel > 7))) {
+            std::cerr << "Bad sensor topology line " << line_no << ": " << line << std::endl;
+            return -1;
+        }
+        if (topology.size() == IMU_CHANNELS) {
+            std::cerr << "Sensor topology line " << line_no << ": a frame has only " << IMU_CHANNELS
+                      << " channels" << std::endl;
+            return -1;
+        }
+        placement.bus = bus;
+        placement.dev_addr = static_cast<u8>(dev_addr);
+        topology.push_back(placement);
+    }
+    return 0;
+}
+
+int load_topology(const std::string& path, SensorTopology& topology) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open " << path << std::endl;
+        return -1;
+    }
+    std::stringstream text;
+    text << file.rdbuf();
+    return parse_topology(text.str(), topology);
+}
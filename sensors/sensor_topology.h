@@ -0,0 +1,47 @@
+#ifndef SENSOR_TOPOLOGY_H
+#define SENSOR_TOPOLOGY_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "bno055.h"
+
+/**
+ * @brief Where one sensor is wired: adapter, multiplexer, mux channel and
+ * address. The position in a SensorTopology is the frame channel the sensor
+ * fills (sensorLocations order).
+ */
+struct SensorPlacement {
+    std::string bus;    // adapter, e.g. "/dev/i2c-1"
+    int mux_addr;       // TCA9548A address, -1 when the sensor is directly on the bus
+    int channel;        // mux channel 0-7, ignored without a mux
+    u8 dev_addr;        // BNO055 address (0x28 / 0x29)
+    int divisor = 1;    // read every divisor-th sweep, the value is carried in between
+};
+
+using SensorTopology = std::vector<SensorPlacement>;
+
+// The suit as wired today: six sensors on /dev/i2c-1 behind one TCA9548A at 0x70
+SensorTopology default_topology();
+
+/**
+ * Parses a topology config, one sensor per line in frame channel order:
+ *
+ *   # bus        mux    channel  address  [every]
+ *   /dev/i2c-1   0x70   0        0x29
+ *   /dev/i2c-1   0x70   2        0x29     3
+ *   /dev/i2c-3   -      -        0x28
+ *
+ * Numbers take any C base prefix, "-" means no multiplexer. The optional
+ * last column is the rate divisor (default 1, every sweep). Blank lines and
+ * # comments are ignored.
+ *
+ * @return 0 on success, -1 on a malformed line or more sensors than a frame
+ *         has channels (IMU_CHANNELS), reported on stderr.
+ */
+int parse_topology(const std::string& text, SensorTopology& topology);
+
+// Reads and parses a topology file, -1 if it cannot be read or parsed
+int load_topology(const std::string& path, SensorTopology& topology);
+
+#endif // SENSOR_TOPOLOGY_H
@@ -0,0 +1,281 @@
+#include "sim_i2c_bus.h"
+#include <cmath>
+#include <cstring>
+#include <time.h>
+
+// Power-on values of the page 0 id block (datasheet section 4.3)
+static const u8 SIM_ID_BLOCK[] = {0xA0, 0xFB, 0x32, 0x0F, 0x11, 0x03, 0x15};
+static const u8 SIM_UNIT_SEL_DEFAULT = 0x80;
+static const u8 SIM_SYS_STATUS_FUSION = 0x05;
+static const u8 SIM_CALIB_PROFILE_ADDR = BNO055_ACCEL_OFFSET_X_LSB_ADDR;
+static const u8 SIM_CALIB_PROFILE_LEN = BNO055_MAG_RADIUS_MSB_ADDR - BNO055_ACCEL_OFFSET_X_LSB_ADDR + 1;
+
+// Page 0 registers that are read-only: ids and the whole data/status block
+static bool read_only(u8 reg) {
+    return reg < BNO055_PAGE_ID_ADDR ||
+           (reg >= BNO055_ACCEL_DATA_X_LSB_ADDR && reg <= BNO055_SYS_ERR_ADDR);
+}
+
+static int64_t monotonic_now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+// Sleeps most of the way and spins the rest, the scheduler wake-up slack
+// would otherwise be larger than a single byte time
+static void block_until(int64_t deadline_ns) {
+    const int64_t SPIN_NS = 80000;
+    int64_t now = monotonic_now_ns();
+    if (deadline_ns - now > SPIN_NS) {
+        int64_t wake = deadline_ns - SPIN_NS;
+        struct timespec ts;
+        ts.tv_sec = wake / 1000000000LL;
+        ts.tv_nsec = wake % 1000000000LL;
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr);
+    }
+    while (monotonic_now_ns() < deadline_ns) {}
+}
+
+SimulatedI2CBus::SimulatedI2CBus(SimBusTiming timing, bool realtime, u8 mux_addr)
+    : timing_(timing), realtime_(realtime), mux_addr_(mux_addr), mux_mask_(0),
+      start_ns_(monotonic_now_ns()), virtual_ns_(0), calibration_ns_(0), io_stats_("sim") {}
+
+void SimulatedI2CBus::set_calibration_time_ns(int64_t ns) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    calibration_ns_ = ns;
+}
+
+void SimulatedI2CBus::calibrated_profile(int channel, u8 dev_addr, u8* profile) {
+    // Arbitrary but fixed per sensor and never all zero
+    for (int i = 0; i < SIM_CALIB_PROFILE_LEN; i++) {
+        profile[i] = static_cast<u8>(0x11 + 37 * i + 13 * (channel + 1) + dev_addr);
+    }
+}
+
+void SimulatedI2CBus::set_replay(ImuReplay replay) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    replay_ = std::move(replay);
+}
+
+void SimulatedI2CBus::add_bno055(int channel, u8 dev_addr, size_t replay_channel) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Device dev;
+    dev.channel = channel;
+    dev.addr = dev_addr;
+    dev.replay_channel = replay_channel;
+    dev.present = true;
+    power_on(dev);
+    devices_.push_back(dev);
+}
+
+void SimulatedI2CBus::set_present(int channel, u8 dev_addr, bool present) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (Device& dev : devices_) {
+        if (dev.channel != channel || dev.addr != dev_addr) continue;
+        if (present && !dev.present) power_on(dev);
+        dev.present = present;
+    }
+}
+
+void SimulatedI2CBus::advance_ns(int64_t ns) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    virtual_ns_ += ns;
+}
+
+int64_t SimulatedI2CBus::now_ns() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return clock_ns();
+}
+
+int64_t SimulatedI2CBus::clock_ns() const {
+    return realtime_ ? monotonic_now_ns() - start_ns_ : virtual_ns_;
+}
+
+void SimulatedI2CBus::power_on(Device& dev) {
+    std::memset(dev.regs, 0, sizeof(dev.regs));
+    std::memcpy(dev.regs[BNO055_PAGE_ZERO], SIM_ID_BLOCK, sizeof(SIM_ID_BLOCK));
+    dev.regs[BNO055_PAGE_ZERO][BNO055_UNIT_SEL_ADDR] = SIM_UNIT_SEL_DEFAULT;
+    dev.regs[BNO055_PAGE_ONE][BNO055_PAGE_ID_ADDR] = BNO055_PAGE_ZERO;
+    dev.page = BNO055_PAGE_ZERO;
+    dev.fusion_since_ns = -1;
+    dev.restored = false;
+}
+
+SimulatedI2CBus::Device* SimulatedI2CBus::find_device(u8 addr) {
+    Device* found = nullptr;
+    for (Device& dev : devices_) {
+        if (!dev.present || dev.addr != addr) continue;
+        if (dev.channel >= 0 && !(mux_mask_ & (1 << dev.channel))) continue;
+        if (found != nullptr) return nullptr;  // two sensors answering at once
+        found = &dev;
+    }
+    return found;
+}
+
+void SimulatedI2CBus::refresh_data(Device& dev) {
+    u8* regs = dev.regs[BNO055_PAGE_ZERO];
+    u8 mode = regs[BNO055_OPR_MODE_ADDR] & BNO055_OPERATION_MODE_MSK;
+    bool fusion = mode >= BNO055_OPERATION_MODE_IMUPLUS;
+    regs[BNO055_SYS_STAT_ADDR] = fusion ? SIM_SYS_STATUS_FUSION : 0;
+    refresh_calibration(dev, fusion);
+
+    bno055_euler_t e = {0, 0, 0};
+    if (fusion && replay_.frames() > 0 && dev.replay_channel < replay_.channels) {
+        e = replay_.at(replay_.frame_at(clock_ns()), dev.replay_channel);
+    }
+
+    s16 hrp[3] = {e.h, e.r, e.p};
+    bool radians = regs[BNO055_UNIT_SEL_ADDR] & BNO055_EULER_UNIT_MSK;
+    for (int i = 0; i < 3; i++) {
+        s16 v = hrp[i];
+        if (radians) {
+            v = static_cast<s16>(std::lround(v / BNO055_EULER_DIV_DEG * M_PI / 180.0 *
+                                             BNO055_EULER_DIV_RAD));
+        }
+        regs[BNO055_EULER_H_LSB_ADDR + 2 * i] = static_cast<u8>(v & 0xFF);
+        regs[BNO055_EULER_H_LSB_ADDR + 2 * i + 1] = static_cast<u8>((v >> 8) & 0xFF);
+    }
+}
+
+void SimulatedI2CBus::refresh_calibration(Device& dev, bool fusion) {
+    u8* regs = dev.regs[BNO055_PAGE_ZERO];
+    if (!fusion) {
+        regs[BNO055_CALIB_STAT_ADDR] = 0;
+        return;
+    }
+
+    int64_t elapsed = clock_ns() - dev.fusion_since_ns;
+    if (dev.restored || elapsed >= calibration_ns_) {
+        regs[BNO055_CALIB_STAT_ADDR] = 0xFF;
+        calibrated_profile(dev.channel, dev.addr, &regs[SIM_CALIB_PROFILE_ADDR]);
+        return;
+    }
+
+    // Every subsystem climbs through the levels, system comes last
+    u8 level = static_cast<u8>(3 * elapsed / calibration_ns_);
+    regs[BNO055_CALIB_STAT_ADDR] = static_cast<u8>((level << 4) | (level << 2) | level);
+}
+
+void SimulatedI2CBus::write_register(Device& dev, u8 reg, u8 value) {
+    if (reg == BNO055_PAGE_ID_ADDR) {
+        dev.page = value & BNO055_PAGE_ONE;
+        dev.regs[BNO055_PAGE_ZERO][reg] = dev.page;
+        dev.regs[BNO055_PAGE_ONE][reg] = dev.page;
+        return;
+    }
+
+    u8* regs = dev.regs[dev.page];
+    if (dev.page == BNO055_PAGE_ZERO) {
+        if (reg == BNO055_OPR_MODE_ADDR) {
+            u8 mode = value & BNO055_OPERATION_MODE_MSK;
+            bool was_fusing = dev.fusion_since_ns >= 0;
+            if (mode < BNO055_OPERATION_MODE_IMUPLUS) {
+                if (was_fusing) refresh_calibration(dev, true);  // keeps what it has found
+                dev.fusion_since_ns = -1;
+            } else if (!was_fusing) {
+                // Entering fusion: a profile written in CONFIG is picked up now
+                u8 own[SIM_CALIB_PROFILE_LEN];
+                calibrated_profile(dev.channel, dev.addr, own);
+                dev.restored = std::memcmp(&regs[SIM_CALIB_PROFILE_ADDR], own, sizeof(own)) == 0;
+                dev.fusion_since_ns = clock_ns();
+            }
+            regs[reg] = mode;
+            return;
+        }
+        if (reg == BNO055_SYS_TRIGGER_ADDR) {
+            if (value & BNO055_SYS_RST_MSK) power_on(dev);
+            return;
+        }
+        if (read_only(reg)) return;
+    }
+
+    // Everything else only takes a write in CONFIG mode
+    u8 mode = dev.regs[BNO055_PAGE_ZERO][BNO055_OPR_MODE_ADDR] & BNO055_OPERATION_MODE_MSK;
+    if (mode == BNO055_OPERATION_MODE_CONFIG) regs[reg] = value;
+}
+
+s8 SimulatedI2CBus::finish(int64_t wire_bytes, bool ok) {
+    int64_t cost = timing_.transaction_ns + wire_bytes * timing_.byte_ns;
+    stats_.transactions++;
+    stats_.bytes += static_cast<uint64_t>(wire_bytes);
+    stats_.busy_ns += cost;
+    if (!ok) stats_.nacks++;
+
+    if (realtime_) {
+        if (cost > 0) block_until(monotonic_now_ns() + cost);
+    } else {
+        virtual_ns_ += cost;
+    }
+    return ok ? BNO055_SUCCESS : BNO055_ERROR;
+}
+
+s8 SimulatedI2CBus::read(u8 dev_addr, u8 reg_addr, u8* reg_data, u8 cnt) {
+    int64_t start = I2CStats::now_ns();
+    s8 result = transfer_read(dev_addr, reg_addr, reg_data, cnt);
+    io_stats_.record(I2COp::READ, dev_addr, start, result == BNO055_SUCCESS);
+    return result;
+}
+
+s8 SimulatedI2CBus::write(u8 dev_addr, u8 reg_addr, const u8* reg_data, u8 cnt) {
+    int64_t start = I2CStats::now_ns();
+    s8 result = transfer_write(dev_addr, reg_addr, reg_data, cnt);
+    io_stats_.record(I2COp::WRITE, dev_addr, start, result == BNO055_SUCCESS);
+    return result;
+}
+
+s8 SimulatedI2CBus::transfer_read(u8 dev_addr, u8 reg_addr, u8* reg_data, u8 cnt) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Device* dev = find_device(dev_addr);
+    if (dev == nullptr) return finish(1, false);
+    if (reg_addr + cnt > 0x80) return finish(2, false);
+
+    if (dev->page == BNO055_PAGE_ZERO && reg_addr <= BNO055_SYS_STAT_ADDR &&
+        reg_addr + cnt > BNO055_EULER_H_LSB_ADDR) {
+        refresh_data(*dev);
+    }
+    std::memcpy(reg_data, &dev->regs[dev->page][reg_addr], cnt);
+
+    // Address + register, repeated start, address + cnt data bytes
+    return finish(3 + cnt, true);
+}
+
+s8 SimulatedI2CBus::transfer_write(u8 dev_addr, u8 reg_addr, const u8* reg_data, u8 cnt) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Device* dev = find_device(dev_addr);
+    if (dev == nullptr) return finish(1, false);
+    if (reg_addr + cnt > 0x80) return finish(2, false);
+
+    for (int i = 0; i < cnt; i++) write_register(*dev, static_cast<u8>(reg_addr + i), reg_data[i]);
+    return finish(2 + cnt, true);
+}
+
+s8 SimulatedI2CBus::send_byte(u8 dev_addr, u8 value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (dev_addr != mux_addr_) return finish(1, false);
+    mux_mask_ = value;
+    stats_.mux_writes++;
+    return finish(2, true);
+}
+
+s8 SimulatedI2CBus::receive_byte(u8 dev_addr, u8* value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (dev_addr != mux_addr_) return finish(1, false);
+    *value = mux_mask_;
+    return finish(2, true);
+}
+
+SimulatedI2CBus::Stats SimulatedI2CBus::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void SimulatedI2CBus::reset_stats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_ = Stats();
+}
+
+u8 SimulatedI2CBus::mux_mask() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return mux_mask_;
+}
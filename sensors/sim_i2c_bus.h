@@ -0,0 +1,142 @@
+#ifndef SIM_I2C_BUS_H
+#define SIM_I2C_BUS_H
+
+#include <stdint.h>
+#include <mutex>
+#include <vector>
+#include "i2c_bus.h"
+#include "i2c_stats.h"
+#include "imu_replay.h"
+
+/**
+ * @brief Cost model for one simulated bus transaction.
+ *
+ * A transaction costs transaction_ns (driver round trip, start/stop) plus
+ * byte_ns for every byte clocked on the wire, address bytes included.
+ */
+struct SimBusTiming {
+    int64_t transaction_ns = 0;
+    int64_t byte_ns = 0;
+
+    static SimBusTiming none() { return SimBusTiming(); }
+
+    // 9 clocks per byte (8 data + ACK) at the given SCL rate, plus a fixed
+    // per-transaction overhead (i2c-dev ioctl on a Pi is roughly 60 us)
+    static SimBusTiming at_clock(uint32_t scl_hz, int64_t overhead_ns = 60000) {
+        SimBusTiming timing;
+        timing.transaction_ns = overhead_ns;
+        timing.byte_ns = 9000000000LL / scl_hz;
+        return timing;
+    }
+};
+
+/**
+ * @brief Software I2C bus with a TCA9548A and BNO055 sensors behind it.
+ *
+ * Models what the driver code relies on: the multiplexer control register
+ * (write/read-back of the channel mask), address decoding through the enabled
+ * channels (NACK when nothing answers, error on an address collision), and
+ * per-sensor BNO055 register maps with both pages, page switching,
+ * auto-increment, the chip/revision ids, OPR_MODE, UNIT_SEL and the
+ * CONFIG-only write protection. The Euler registers serve the frame of an
+ * ImuReplay that is current at the simulated time.
+ *
+ * Calibration is modelled too: every sensor has its own offset/radius
+ * profile, which it finds after calibration_ns in a fusion mode (CALIB_STAT
+ * climbs to 0xFF and the profile appears in 0x55-0x6A). A sensor whose
+ * offset registers were written with its own profile in CONFIG mode reports
+ * fully calibrated as soon as it fuses. Power-on clears the offsets.
+ *
+ * With a virtual clock (the default) transactions only advance simulated
+ * time, which keeps tests fast and deterministic. With a realtime clock each
+ * transaction blocks the caller for its modelled cost and the replay follows
+ * CLOCK_MONOTONIC, so acquisition code can be timed as on the target.
+ *
+ * Thread safe; transactions are serialised like on a real bus.
+ */
+class SimulatedI2CBus : public I2CBus {
+  public:
+    static constexpr u8 DEFAULT_MUX_ADDR = 0x70;
+
+    struct Stats {
+        uint64_t transactions = 0;
+        uint64_t bytes = 0;        // bytes on the wire, address bytes included
+        uint64_t nacks = 0;        // transactions nobody (or more than one device) answered
+        uint64_t mux_writes = 0;   // control register writes
+        int64_t busy_ns = 0;       // modelled bus time
+    };
+
+    explicit SimulatedI2CBus(SimBusTiming timing = SimBusTiming::none(), bool realtime = false,
+                             u8 mux_addr = DEFAULT_MUX_ADDR);
+
+    // Frames served by every attached sensor, channel i of the replay going
+    // to the sensor attached with replay_channel == i
+    void set_replay(ImuReplay replay);
+
+    // Attaches a BNO055 behind mux channel (0-7), or directly on the bus with -1
+    void add_bno055(int channel, u8 dev_addr, size_t replay_channel);
+
+    // Disconnects/reconnects a sensor; a reconnected sensor comes back in its
+    // power-on state (CONFIG mode, page 0, default units)
+    void set_present(int channel, u8 dev_addr, bool present);
+
+    // Time an uncalibrated sensor needs in a fusion mode before it is fully
+    // calibrated (the user moving the limb around), 0 = calibrated at once
+    void set_calibration_time_ns(int64_t ns);
+
+    // The profile the sensor at channel/address converges to
+    static void calibrated_profile(int channel, u8 dev_addr, u8* profile);
+
+    // Virtual clock only: lets time pass without bus traffic
+    void advance_ns(int64_t ns);
+    int64_t now_ns() const;  // simulated time since construction
+
+    s8 read(u8 dev_addr, u8 reg_addr, u8* reg_data, u8 cnt) override;
+    s8 write(u8 dev_addr, u8 reg_addr, const u8* reg_data, u8 cnt) override;
+    s8 send_byte(u8 dev_addr, u8 value) override;
+    s8 receive_byte(u8 dev_addr, u8* value) override;
+
+    I2CStats* io_stats() override { return &io_stats_; }
+
+    Stats stats() const;
+    void reset_stats();
+    u8 mux_mask() const;
+
+  private:
+    struct Device {
+        int channel;
+        u8 addr;
+        size_t replay_channel;
+        bool present;
+        u8 page;
+        u8 regs[2][0x80];
+        int64_t fusion_since_ns;  // when the current fusion mode was entered, -1 in CONFIG
+        bool restored;            // own profile written before entering fusion
+    };
+
+    s8 transfer_read(u8 dev_addr, u8 reg_addr, u8* reg_data, u8 cnt);
+    s8 transfer_write(u8 dev_addr, u8 reg_addr, const u8* reg_data, u8 cnt);
+    void power_on(Device& dev);
+    Device* find_device(u8 addr);  // nullptr on NACK or collision
+    void refresh_data(Device& dev);
+    void refresh_calibration(Device& dev, bool fusion);
+    void write_register(Device& dev, u8 reg, u8 value);
+    s8 finish(int64_t wire_bytes, bool ok);
+    int64_t clock_ns() const;
+
+    SimBusTiming timing_;
+    bool realtime_;
+    u8 mux_addr_;
+    u8 mux_mask_;
+    int64_t start_ns_;     // CLOCK_MONOTONIC at construction
+    int64_t virtual_ns_;   // virtual clock
+    int64_t calibration_ns_;
+
+    ImuReplay replay_;
+    std::vector<Device> devices_;
+    Stats stats_;
+    I2CStats io_stats_;    // host time per call, i.e. the modelled cost with a realtime clock
+    mutable std::mutex mutex_;
+};
+
+#endif // SIM_I2C_BUS_H
@@ -0,0 +1,169 @@
+#ifndef SIMD_LANES_H
+#define SIMD_LANES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Define EXO_SIMD_SCALAR to build the plain loops on any target
+#if defined(EXO_SIMD_SCALAR)
+#elif defined(__AVX__)
+#include <immintrin.h>
+#define EXO_SIMD_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define EXO_SIMD_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+// 32-bit NEON has no vector divide, so armv7 builds take the scalar lanes
+#include <arm_neon.h>
+#define EXO_SIMD_NEON 1
+#endif
+
+/**
+ * @brief Eight float lanes, one per IMU channel (six used, two padding).
+ *
+ * One 256-bit register with AVX, two 128-bit halves with SSE2 or aarch64
+ * NEON, a plain array otherwise. Every operation is a single IEEE add, sub,
+ * mul, div or compare per lane, so each lane gives exactly the float the
+ * scalar expression gives; kernels built on it stay bit for bit equal to
+ * their scalar versions.
+ */
+namespace simd {
+
+constexpr size_t LANES = 8;
+
+// load_n(p, n) reads the first n (1..LANES) floats at p, the other lanes
+// zero; store_n(p, a, n) writes only the first n lanes. Neither touches
+// memory past p + n.
+
+#if defined(EXO_SIMD_AVX)
+constexpr const char* ISA = "avx";
+
+struct F8 { __m256 v; };
+struct M8 { __m256 v; };
+
+inline F8 load(const float* p) { return {_mm256_loadu_ps(p)}; }
+inline void store(float* p, F8 a) { _mm256_storeu_ps(p, a.v); }
+inline F8 set1(float x) { return {_mm256_set1_ps(x)}; }
+inline F8 operator+(F8 a, F8 b) { return {_mm256_add_ps(a.v, b.v)}; }
+inline F8 operator-(F8 a, F8 b) { return {_mm256_sub_ps(a.v, b.v)}; }
+inline F8 operator*(F8 a, F8 b) { return {_mm256_mul_ps(a.v, b.v)}; }
+inline F8 operator/(F8 a, F8 b) { return {_mm256_div_ps(a.v, b.v)}; }
+inline M8 operator>(F8 a, F8 b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ)}; }
+inline M8 operator<(F8 a, F8 b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)}; }
+inline F8 select(M8 m, F8 a, F8 b) { return {_mm256_blendv_ps(b.v, a.v, m.v)}; }
+
+// The first n lanes; the mask comes from a sliding window over eight ones and eight zeros
+inline __m256i first_n(size_t n) {
+    static const int32_t ones_then_zeros[16] = {-1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0, 0, 0, 0};
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ones_then_zeros + LANES - n));
+}
+inline F8 load_n(const float* p, size_t n) { return {_mm256_maskload_ps(p, first_n(n))}; }
+inline void store_n(float* p, F8 a, size_t n) { _mm256_maskstore_ps(p, first_n(n), a.v); }
+
+#elif defined(EXO_SIMD_SSE2)
+constexpr const char* ISA = "sse2";
+
+struct F8 { __m128 lo, hi; };
+struct M8 { __m128 lo, hi; };
+
+inline F8 load(const float* p) { return {_mm_loadu_ps(p), _mm_loadu_ps(p + 4)}; }
+inline void store(float* p, F8 a) { _mm_storeu_ps(p, a.lo); _mm_storeu_ps(p + 4, a.hi); }
+inline F8 set1(float x) { return {_mm_set1_ps(x), _mm_set1_ps(x)}; }
+inline F8 operator+(F8 a, F8 b) { return {_mm_add_ps(a.lo, b.lo), _mm_add_ps(a.hi, b.hi)}; }
+inline F8 operator-(F8 a, F8 b) { return {_mm_sub_ps(a.lo, b.lo), _mm_sub_ps(a.hi, b.hi)}; }
+inline F8 operator*(F8 a, F8 b) { return {_mm_mul_ps(a.lo, b.lo), _mm_mul_ps(a.hi, b.hi)}; }
+inline F8 operator/(F8 a, F8 b) { return {_mm_div_ps(a.lo, b.lo), _mm_div_ps(a.hi, b.hi)}; }
+inline M8 operator>(F8 a, F8 b) { return {_mm_cmpgt_ps(a.lo, b.lo), _mm_cmpgt_ps(a.hi, b.hi)}; }
+inline M8 operator<(F8 a, F8 b) { return {_mm_cmplt_ps(a.lo, b.lo), _mm_cmplt_ps(a.hi, b.hi)}; }
+inline __m128 select4(__m128 m, __m128 a, __m128 b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+inline F8 select(M8 m, F8 a, F8 b) { return {select4(m.lo, a.lo, b.lo), select4(m.hi, a.hi, b.hi)}; }
+
+// Six lanes, the IMU frame, is one 4-float and one 2-float move
+inline F8 load_n(const float* p, size_t n) {
+    if (n == LANES) return load(p);
+    if (n == 6) return {_mm_loadu_ps(p), _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(p + 4)))};
+    float lanes[LANES] = {};
+    std::memcpy(lanes, p, n * sizeof(float));
+    return load(lanes);
+}
+inline void store_n(float* p, F8 a, size_t n) {
+    if (n == LANES) return store(p, a);
+    if (n == 6) {
+        _mm_storeu_ps(p, a.lo);
+        _mm_store_sd(reinterpret_cast<double*>(p + 4), _mm_castps_pd(a.hi));
+        return;
+    }
+    float lanes[LANES];
+    store(lanes, a);
+    std::memcpy(p, lanes, n * sizeof(float));
+}
+
+#elif defined(EXO_SIMD_NEON)
+constexpr const char* ISA = "neon";
+
+struct F8 { float32x4_t lo, hi; };
+struct M8 { uint32x4_t lo, hi; };
+
+inline F8 load(const float* p) { return {vld1q_f32(p), vld1q_f32(p + 4)}; }
+inline void store(float* p, F8 a) { vst1q_f32(p, a.lo); vst1q_f32(p + 4, a.hi); }
+inline F8 set1(float x) { return {vdupq_n_f32(x), vdupq_n_f32(x)}; }
+inline F8 operator+(F8 a, F8 b) { return {vaddq_f32(a.lo, b.lo), vaddq_f32(a.hi, b.hi)}; }
+inline F8 operator-(F8 a, F8 b) { return {vsubq_f32(a.lo, b.lo), vsubq_f32(a.hi, b.hi)}; }
+inline F8 operator*(F8 a, F8 b) { return {vmulq_f32(a.lo, b.lo), vmulq_f32(a.hi, b.hi)}; }
+inline F8 operator/(F8 a, F8 b) { return {vdivq_f32(a.lo, b.lo), vdivq_f32(a.hi, b.hi)}; }
+inline M8 operator>(F8 a, F8 b) { return {vcgtq_f32(a.lo, b.lo), vcgtq_f32(a.hi, b.hi)}; }
+inline M8 operator<(F8 a, F8 b) { return {vcltq_f32(a.lo, b.lo), vcltq_f32(a.hi, b.hi)}; }
+inline F8 select(M8 m, F8 a, F8 b) { return {vbslq_f32(m.lo, a.lo, b.lo), vbslq_f32(m.hi, a.hi, b.hi)}; }
+
+// Six lanes, the IMU frame, is one 4-float and one 2-float move
+inline F8 load_n(const float* p, size_t n) {
+    if (n == LANES) return load(p);
+    if (n == 6) return {vld1q_f32(p), vcombine_f32(vld1_f32(p + 4), vdup_n_f32(0.0f))};
+    float lanes[LANES] = {};
+    std::memcpy(lanes, p, n * sizeof(float));
+    return load(lanes);
+}
+inline void store_n(float* p, F8 a, size_t n) {
+    if (n == LANES) return store(p, a);
+    if (n == 6) {
+        vst1q_f32(p, a.lo);
+        vst1_f32(p + 4, vget_low_f32(a.hi));
+        return;
+    }
+    float lanes[LANES];
+    store(lanes, a);
+    std::memcpy(p, lanes, n * sizeof(float));
+}
+
+#else
+constexpr const char* ISA = "scalar";
+
+struct F8 { float v[LANES]; };
+struct M8 { bool v[LANES]; };
+
+inline F8 load(const float* p) { F8 r; std::memcpy(r.v, p, sizeof(r.v)); return r; }
+inline void store(float* p, F8 a) { std::memcpy(p, a.v, sizeof(a.v)); }
+inline F8 set1(float x) { F8 r; for (size_t i = 0; i < LANES; i++) r.v[i] = x; return r; }
+#define EXO_SIMD_LANEWISE(RESULT, OP)                                                                  \
+    inline RESULT operator OP(F8 a, F8 b) {                                                            \
+        RESULT r;                                                                                      \
+        for (size_t i = 0; i < LANES; i++) r.v[i] = a.v[i] OP b.v[i];                                  \
+        return r;                                                                                      \
+    }
+EXO_SIMD_LANEWISE(F8, +)
+EXO_SIMD_LANEWISE(F8, -)
+EXO_SIMD_LANEWISE(F8, *)
+EXO_SIMD_LANEWISE(F8, /)
+EXO_SIMD_LANEWISE(M8, >)
+EXO_SIMD_LANEWISE(M8, <)
+#undef EXO_SIMD_LANEWISE
+inline F8 select(M8 m, F8 a, F8 b) { F8 r; for (size_t i = 0; i < LANES; i++) r.v[i] = m.v[i] ? a.v[i] : b.v[i]; return r; }
+
+inline F8 load_n(const float* p, size_t n) { F8 r = {}; std::memcpy(r.v, p, n * sizeof(float)); return r; }
+inline void store_n(float* p, F8 a, size_t n) { std::memcpy(p, a.v, n * sizeof(float)); }
+#endif
+
+}  // namespace simd
+
+#endif  // SIMD_LANES_H
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include "async_logger.h"
+#include "imu_log_record.h"
+
+static std::vector<char> read_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+static ImuFrame make_frame(uint64_t sequence) {
+    ImuFrame frame{};
+    frame.sequence = sequence;
+    frame.timestamp_ns = 1000000000LL + static_cast<int64_t>(sequence) * 10000000LL;
+    for (size_t i = 0; i < IMU_CHANNELS; i++) {
+        frame.roll[i] = static_cast<int16_t>(sequence * 16 + i);
+        frame.sample_ns[i] = frame.timestamp_ns + static_cast<int64_t>(i) * 1000;
+    }
+    frame.valid_mask = 0x3F;
+    frame.fresh_mask = static_cast<uint8_t>(sequence % 3 == 0 ? 0x3F : 0x33);
+    return frame;
+}
+
+TEST(AsyncLoggerTest, RecordsLandInOrderAfterTheHeader) {
+    std::string path = ::testing::TempDir() + "async_logger_order.bin";
+    AsyncLogger::Config config;
+    config.capacity = 64;
+    config.batch_bytes = 16 * sizeof(ImuLogRecord);
+    config.max_delay = std::chrono::milliseconds(5);
+    AsyncLogger log(sizeof(ImuLogRecord), config);
+
+    std::string header = exolog_header(imu_log_schema({"a", "b", "c", "d", "e", "f"}, 10000000));
+    ASSERT_EQ(log.open(path, header.data(), header.size()), 0);
+
+    // More records than the ring holds, at a pace the writer keeps up with
+    const uint64_t count = 500;
+    for (uint64_t seq = 0; seq < count; seq++) {
+        while (!log.push_record(imu_log_record(make_frame(seq)))) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    log.close();
+    EXPECT_EQ(log.written(), count);
+    EXPECT_EQ(log.write_errors(), 0u);
+
+    std::vector<char> bytes = read_file(path);
+    ASSERT_EQ(bytes.size(), header.size() + count * sizeof(ImuLogRecord));
+    EXPECT_EQ(std::string(bytes.data(), header.size()), header);
+
+    for (uint64_t seq = 0; seq < count; seq++) {
+        ImuLogRecord record;
+        std::memcpy(&record, bytes.data() + header.size() + seq * sizeof(ImuLogRecord), sizeof(record));
+        ImuFrame frame = make_frame(seq);
+        ASSERT_EQ(record.sequence, seq);
+        EXPECT_EQ(record.timestamp_ns, frame.timestamp_ns);
+        EXPECT_EQ(record.roll[5], frame.roll[5]);
+        EXPECT_EQ(record.sample_ns[2], frame.sample_ns[2]);
+        EXPECT_EQ(record.fresh_mask, frame.fresh_mask);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(AsyncLoggerTest, FullRingDropsInsteadOfBlocking) {
+    std::string path = ::testing::TempDir() + "async_logger_drop.bin";
+    AsyncLogger::Config config;
+    config.capacity = 8;
+    config.batch_bytes = 1 << 20;                 // never reached...
+    config.max_delay = std::chrono::seconds(60);  // ...so nothing is written before close()
+    AsyncLogger log(sizeof(ImuLogRecord), config);
+    ASSERT_EQ(log.open(path), 0);
+
+    int accepted = 0;
+    for (uint64_t seq = 0; seq < 20; seq++) accepted += log.push_record(imu_log_record(make_frame(seq)));
+    EXPECT_EQ(accepted, 8);
+    EXPECT_EQ(log.dropped(), 12u);
+    EXPECT_EQ(log.pushed(), 20u);
+
+    // close() still writes what was accepted
+    log.close();
+    EXPECT_EQ(log.written(), 8u);
+    EXPECT_EQ(read_file(path).size(), 8 * sizeof(ImuLogRecord));
+    std::remove(path.c_str());
+}
+
+TEST(AsyncLoggerTest, RejectsWrongRecordsAndClosedFiles) {
+    AsyncLogger log(sizeof(ImuLogRecord));
+    EXPECT_FALSE(log.push_record(imu_log_record(make_frame(1))));  // not open
+    EXPECT_EQ(log.dropped(), 1u);
+
+    std::string path = ::testing::TempDir() + "async_logger_size.bin";
+    ASSERT_EQ(log.open(path), 0);
+    EXPECT_FALSE(log.push_record(make_frame(1)));  // an ImuFrame is not a log record
+    EXPECT_TRUE(log.push_record(imu_log_record(make_frame(1))));
+    log.close();
+    EXPECT_EQ(log.written(), 1u);
+    std::remove(path.c_str());
+
+    EXPECT_EQ(log.open("/nonexistent-dir/log.bin"), -1);
+}
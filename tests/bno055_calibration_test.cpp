@@ -0,0 +1,185 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <thread>
+#include "bno055_calibration.h"
+#include "bno055_device.h"
+#include "rpi_tca9548a.h"
+#include "sensor_rig.h"
+#include "sim_i2c_bus.h"
+
+static const u8 IMU_ADDR = BNO055_I2C_ADDR2;
+static const int64_t CALIBRATION_NS = 10000000000LL;
+
+static bool same(const Bno055CalibrationProfile& a, const u8* b) {
+    return std::memcmp(a.data, b, BNO055_CALIB_PROFILE_LEN) == 0;
+}
+
+TEST(Bno055CalibrationTest, ProfileFileRoundTrip) {
+    Bno055CalibrationProfile profile;
+    for (int i = 0; i < BNO055_CALIB_PROFILE_LEN; i++) profile.data[i] = static_cast<u8>(0xF0 - 7 * i);
+
+    std::string path = ::testing::TempDir() + "roundtrip.cal";
+    ASSERT_EQ(save_calibration_profile(path, profile), 0);
+
+    Bno055CalibrationProfile loaded;
+    ASSERT_EQ(load_calibration_profile(path, loaded), 0);
+    EXPECT_TRUE(same(loaded, profile.data));
+
+    // Short or garbled files are rejected, a missing one too
+    std::ofstream(path) << "00 11 22\n";
+    EXPECT_EQ(load_calibration_profile(path, loaded), -1);
+    std::ofstream(path) << "zz\n";
+    EXPECT_EQ(load_calibration_profile(path, loaded), -1);
+    std::remove(path.c_str());
+    EXPECT_EQ(load_calibration_profile(path, loaded), -1);
+}
+
+TEST(Bno055CalibrationTest, StoreNamesFilesAfterTheWiring) {
+    CalibrationStore store("/var/lib/exo");
+    EXPECT_EQ(store.path_for({"/dev/i2c-1", 0x70, 3, 0x29}), "/var/lib/exo/bno055_i2c-1_mux70_ch3_addr29.cal");
+    EXPECT_EQ(store.path_for({"/dev/i2c-3", -1, -1, 0x28}), "/var/lib/exo/bno055_i2c-3_addr28.cal");
+}
+
+TEST(Bno055CalibrationTest, RestoredProfileIsCalibratedAtOnce) {
+    SimulatedI2CBus bus;
+    bus.set_calibration_time_ns(CALIBRATION_NS);
+    bus.add_bno055(0, IMU_ADDR, 0);
+    rpi_tca9548a tca;
+    ASSERT_EQ(tca.init(0x70, bus), 0);
+    Bno055Device imu(bus, IMU_ADDR, &tca, 0);
+
+    // Cold: only calibrated after the motion
+    u8 status = 0;
+    ASSERT_EQ(imu.init(), BNO055_SUCCESS);
+    ASSERT_EQ(imu.set_operation_mode(BNO055_OPERATION_MODE_NDOF), BNO055_SUCCESS);
+    ASSERT_EQ(imu.read_calibration_status(&status), BNO055_SUCCESS);
+    EXPECT_NE(status, BNO055_CALIB_STAT_FULL);
+    bus.advance_ns(CALIBRATION_NS);
+    ASSERT_EQ(imu.read_calibration_status(&status), BNO055_SUCCESS);
+    EXPECT_EQ(status, BNO055_CALIB_STAT_FULL);
+
+    Bno055CalibrationProfile profile;
+    u8 expected[BNO055_CALIB_PROFILE_LEN];
+    SimulatedI2CBus::calibrated_profile(0, IMU_ADDR, expected);
+    ASSERT_EQ(imu.read_calibration_profile(&profile), BNO055_SUCCESS);
+    EXPECT_TRUE(same(profile, expected));
+    EXPECT_EQ(imu.operation_mode(), BNO055_OPERATION_MODE_NDOF);  // switched back
+
+    // A power cycle loses it, writing it back in CONFIG restores it
+    bus.set_present(0, IMU_ADDR, false);
+    bus.set_present(0, IMU_ADDR, true);
+    ASSERT_EQ(imu.init(), BNO055_SUCCESS);
+    ASSERT_EQ(imu.write_calibration_profile(profile), BNO055_SUCCESS);
+    ASSERT_EQ(imu.set_operation_mode(BNO055_OPERATION_MODE_NDOF), BNO055_SUCCESS);
+    ASSERT_EQ(imu.read_calibration_status(&status), BNO055_SUCCESS);
+    EXPECT_EQ(status, BNO055_CALIB_STAT_FULL);
+}
+
+TEST(Bno055CalibrationTest, RigSavesAndRestoresProfiles) {
+    SensorTopology topology = {{"sim", 0x70, 0, IMU_ADDR}, {"sim", 0x70, 1, IMU_ADDR}};
+    CalibrationStore store(::testing::TempDir());
+    for (const auto& p : topology) std::remove(store.path_for(p).c_str());
+
+    {
+        SimulatedI2CBus bus;
+        bus.set_calibration_time_ns(CALIBRATION_NS);
+        bus.add_bno055(0, IMU_ADDR, 0);
+        bus.add_bno055(1, IMU_ADDR, 1);
+        SensorRig rig(topology, [&bus](const std::string&) -> I2CBus* { return &bus; });
+        rig.set_calibration_store(&store);
+        ASSERT_EQ(rig.init(), 2);
+        EXPECT_EQ(rig.restored_profiles(), 0u);
+
+        EXPECT_EQ(rig.save_calibration(), 0);  // nothing calibrated yet
+        bus.advance_ns(CALIBRATION_NS);
+        EXPECT_EQ(rig.save_calibration(), 2);
+        EXPECT_EQ(rig.save_calibration(), 0);  // on file already
+    }
+
+    // Next boot
+    SimulatedI2CBus bus;
+    bus.set_calibration_time_ns(CALIBRATION_NS);
+    bus.add_bno055(0, IMU_ADDR, 0);
+    bus.add_bno055(1, IMU_ADDR, 1);
+    SensorRig rig(topology, [&bus](const std::string&) -> I2CBus* { return &bus; });
+    rig.set_calibration_store(&store);
+    ASSERT_EQ(rig.init(), 2);
+    EXPECT_EQ(rig.restored_profiles(), 2u);
+    for (size_t ch = 0; ch < 2; ch++) {
+        u8 status = 0;
+        ASSERT_EQ(rig.read_calibration_status(ch, &status), BNO055_SUCCESS);
+        EXPECT_EQ(status, BNO055_CALIB_STAT_FULL);
+    }
+    EXPECT_EQ(rig.save_calibration(), 0);  // restored, no CONFIG round trip
+}
+
+TEST(Bno055CalibrationTest, RigDoesNotSaveWhileSweepingByDefault) {
+    SensorTopology topology = {{"sim", 0x70, 0, IMU_ADDR}};
+    CalibrationStore store(::testing::TempDir());
+    std::remove(store.path_for(topology[0]).c_str());
+
+    SimulatedI2CBus bus;
+    bus.set_calibration_time_ns(CALIBRATION_NS);
+    bus.add_bno055(0, IMU_ADDR, 0);
+    SensorHealthConfig health;
+    health.calibration_poll_ns = 0;
+    SensorRig rig(topology, [&bus](const std::string&) -> I2CBus* { return &bus; }, BNO055_Q_EULER_ROLL,
+                  health);
+    rig.set_calibration_store(&store);
+    ASSERT_EQ(rig.init(), 1);
+
+    // Fully calibrated, but the sweeps never leave the fusion mode for it
+    bus.advance_ns(CALIBRATION_NS);
+    ImuFrame frame{};
+    Bno055CalibrationProfile profile;
+    for (int k = 0; k < 20; k++) {
+        rig.sweep(frame);
+        EXPECT_EQ(frame.substituted_mask, 0u);
+    }
+    EXPECT_EQ(store.load(topology[0], profile), -1);
+    EXPECT_EQ(rig.save_calibration(), 1);
+}
+
+TEST(Bno055CalibrationTest, RigSavesProfilesOnceCalibratedWhileSweeping) {
+    SensorTopology topology = {{"sim", 0x70, 0, IMU_ADDR}, {"sim", 0x70, 1, IMU_ADDR}};
+    CalibrationStore store(::testing::TempDir());
+    for (const auto& p : topology) std::remove(store.path_for(p).c_str());
+
+    SimulatedI2CBus bus;
+    bus.set_calibration_time_ns(CALIBRATION_NS);
+    bus.add_bno055(0, IMU_ADDR, 0);
+    bus.add_bno055(1, IMU_ADDR, 1);
+    SensorHealthConfig health;
+    health.save_calibration_while_running = true;
+    health.calibration_poll_ns = 0;
+    SensorRig rig(topology, [&bus](const std::string&) -> I2CBus* { return &bus; }, BNO055_Q_EULER_ROLL,
+                  health);
+    rig.set_calibration_store(&store);
+    ASSERT_EQ(rig.init(), 2);
+
+    ImuFrame frame{};
+    Bno055CalibrationProfile profile;
+    for (int k = 0; k < 10; k++) rig.sweep(frame);
+    EXPECT_EQ(store.load(topology[0], profile), -1);  // not calibrated yet
+
+    // Each sensor sits out one CONFIG round trip to have its profile read
+    bus.advance_ns(CALIBRATION_NS);
+    auto give_up = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+    while (std::chrono::steady_clock::now() < give_up &&
+           (store.load(topology[0], profile) != 0 || store.load(topology[1], profile) != 0 ||
+            frame.valid_mask != 0x03)) {
+        rig.sweep(frame);
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    for (size_t ch = 0; ch < 2; ch++) {
+        ASSERT_EQ(store.load(topology[ch], profile), 0);
+        u8 own[BNO055_CALIB_PROFILE_LEN];
+        SimulatedI2CBus::calibrated_profile(static_cast<int>(ch), IMU_ADDR, own);
+        EXPECT_TRUE(same(profile, own));
+    }
+    EXPECT_EQ(frame.valid_mask, 0x03);
+    EXPECT_EQ(rig.recoveries(), 0u);
+}
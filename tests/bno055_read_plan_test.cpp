@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+#include "bno055_read_plan.h"
+
+TEST(Bno055ReadPlanTest, RollOnlyIsTwoBytes) {
+    Bno055ReadPlan plan = bno055_plan_read(BNO055_Q_EULER_ROLL);
+    EXPECT_EQ(plan.start_reg, BNO055_EULER_R_LSB_ADDR);
+    EXPECT_EQ(plan.length, 2);
+}
+
+TEST(Bno055ReadPlanTest, SpanCoversFirstToLastQuantity) {
+    Bno055ReadPlan plan = bno055_plan_read(BNO055_Q_GYRO | BNO055_Q_EULER_ROLL);
+    EXPECT_EQ(plan.start_reg, BNO055_GYRO_DATA_X_LSB_ADDR);
+    EXPECT_EQ(plan.length, BNO055_EULER_R_MSB_ADDR - BNO055_GYRO_DATA_X_LSB_ADDR + 1);
+
+    Bno055ReadPlan all = bno055_plan_read(BNO055_Q_ALL);
+    EXPECT_EQ(all.start_reg, BNO055_ACCEL_DATA_X_LSB_ADDR);
+    EXPECT_EQ(all.length, BNO055_CALIB_STAT_ADDR - BNO055_ACCEL_DATA_X_LSB_ADDR + 1);
+}
+
+TEST(Bno055ReadPlanTest, EmptyRequestReadsNothing) {
+    Bno055ReadPlan plan = bno055_plan_read(0);
+    EXPECT_EQ(plan.length, 0);
+}
+
+TEST(Bno055ReadPlanTest, DecodesFieldsAtTheirOffsets) {
+    Bno055ReadPlan plan = bno055_plan_read(BNO055_Q_EULER | BNO055_Q_QUATERNION);
+    ASSERT_EQ(plan.start_reg, BNO055_EULER_H_LSB_ADDR);
+    ASSERT_EQ(plan.length, 14);
+
+    // heading 360.0, roll -45.5, pitch 10.0 (1/16 degree), quaternion w = 1.0
+    u8 data[14] = {0x80, 0x16, 0x28, 0xFD, 0xA0, 0x00,
+                   0x00, 0x40, 0x01, 0x00, 0xFF, 0xFF, 0x00, 0x00};
+    Bno055Sample sample = {};
+    bno055_decode_sample(plan, data, &sample);
+
+    EXPECT_EQ(sample.quantities, plan.quantities);
+    EXPECT_EQ(sample.euler[0], 360 * 16);
+    EXPECT_EQ(sample.euler[1], -728);
+    EXPECT_EQ(sample.euler[2], 160);
+    EXPECT_EQ(sample.quaternion[0], 16384);
+    EXPECT_EQ(sample.quaternion[1], 1);
+    EXPECT_EQ(sample.quaternion[2], -1);
+    EXPECT_EQ(sample.quaternion[3], 0);
+}
@@ -0,0 +1,210 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <random>
+#include <thread>
+#include "async_logger.h"
+#include "exolog_codec.h"
+#include "imu_log_record.h"
+#include "sensor_dataset.h"
+
+static const std::vector<std::string> LOCATIONS = {"Left Hip", "Left Knee", "Left Ankle",
+                                                   "Right Ankle", "Right Knee", "Right Hip"};
+
+struct MixedRecord {
+    int64_t t;
+    uint64_t counter;
+    double gain;
+    float angle[3];
+    int32_t position;
+    uint16_t raw;
+    int16_t roll[3];
+    int8_t offset;
+    uint8_t mask;
+};
+
+static ExologSchema mixed_schema() {
+    ExologSchema schema;
+    schema.locations = {"Left Hip", "Right Knee", "Right Hip"};
+    schema.append("timestamp_ns", ExologType::I64, 1, 1.0, "ns");
+    schema.append("counter", ExologType::U64, 1);
+    schema.append("gain", ExologType::F64, 1);
+    schema.append("angle", ExologType::F32, 3, 1.0, "deg");
+    schema.append("position", ExologType::I32, 1);
+    schema.append("raw", ExologType::U16, 1);
+    schema.append("roll", ExologType::I16, 3, 1.0 / 16.0, "deg");
+    schema.append("offset", ExologType::I8, 1);
+    schema.append("valid_mask", ExologType::U8, 1);
+    return schema;
+}
+
+static std::vector<MixedRecord> mixed_records(size_t count) {
+    std::mt19937_64 rng(11);
+    std::vector<MixedRecord> records(count);
+    for (size_t i = 0; i < count; i++) {
+        MixedRecord& r = records[i];
+        std::memset(&r, 0, sizeof(r));  // padding compares equal after the round trip
+        r.t = 1700000000000000000LL + static_cast<int64_t>(i) * 10000000LL + static_cast<int64_t>(rng() % 2000);
+        r.counter = i % 5 == 4 ? std::numeric_limits<uint64_t>::max() - i : i;  // wraps both ways
+        r.gain = std::sin(i * 0.1) * 1e6;
+        for (int c = 0; c < 3; c++) {
+            r.angle[c] = static_cast<float>(std::sin(i * 0.05 + c) * 40.0);
+            r.roll[c] = static_cast<int16_t>(r.angle[c] * 16.0f);
+        }
+        r.roll[2] = i % 7 == 0 ? std::numeric_limits<int16_t>::min() : std::numeric_limits<int16_t>::max();
+        r.position = static_cast<int32_t>(rng());
+        r.raw = static_cast<uint16_t>(i % 2 ? 0 : 65535);
+        r.offset = static_cast<int8_t>(i % 3 ? -128 : 127);
+        r.mask = static_cast<uint8_t>(rng());
+    }
+    return records;
+}
+
+static std::vector<char> read_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+TEST(ExologCodecTest, Crc32MatchesTheStandard) {
+    EXPECT_EQ(exolog_crc32("123456789", 9), 0xCBF43926u);
+    EXPECT_EQ(exolog_crc32("56789", 5, exolog_crc32("1234", 4)), 0xCBF43926u);
+}
+
+TEST(ExologCodecTest, BlocksRoundTripEveryType) {
+    ExologSchema schema = mixed_schema();
+    ASSERT_EQ(schema.record_size, sizeof(MixedRecord));
+    std::vector<MixedRecord> records = mixed_records(1000);
+
+    ExologBlockEncoder encoder(schema);
+    ExologBlockDecoder decoder(schema);
+    for (size_t count : {0, 1, 7, 1000}) {
+        std::vector<uint8_t> block;
+        encoder.encode(records.data(), count, block);
+        block.push_back(0xAA);  // whatever follows is not part of the block
+
+        std::vector<uint8_t> decoded;
+        EXPECT_EQ(decoder.decode(block.data(), block.size(), decoded), static_cast<long>(block.size() - 1));
+        ASSERT_EQ(decoded.size(), count * sizeof(MixedRecord));
+        EXPECT_EQ(std::memcmp(decoded.data(), records.data(), decoded.size()), 0) << count << " records";
+
+        // Cut short, or damaged
+        EXPECT_EQ(decoder.decode(block.data(), block.size() - 2, decoded), 0);
+        if (count == 0) continue;
+        block[block.size() / 2] ^= 0x10;
+        EXPECT_EQ(decoder.decode(block.data(), block.size(), decoded), -1);
+        EXPECT_EQ(decoded.size(), count * sizeof(MixedRecord));  // nothing appended on failure
+    }
+}
+
+TEST(ExologCodecTest, LoggerWritesBlocksTheReaderStreams) {
+    std::string path = ::testing::TempDir() + "codec_logger.exolog";
+    ExologSchema schema = imu_log_schema(LOCATIONS, 10000000);
+    schema.compression = EXOLOG_DELTA_VARINT;
+    auto encoder = std::make_shared<ExologBlockEncoder>(schema);
+
+    AsyncLogger::Config config;
+    config.capacity = 64;
+    config.batch_bytes = 16 * sizeof(ImuLogRecord);
+    config.max_delay = std::chrono::milliseconds(5);
+    config.encoder = [encoder](const uint8_t* records, size_t count, std::vector<uint8_t>& out) {
+        encoder->encode(records, count, out);
+    };
+    AsyncLogger log(sizeof(ImuLogRecord), config);
+    std::string header = exolog_header(schema);
+    ASSERT_EQ(log.open(path, header.data(), header.size()), 0);
+
+    const uint64_t count = 600;
+    for (uint64_t seq = 0; seq < count; seq++) {
+        ImuFrame frame{};
+        frame.sequence = seq;
+        frame.timestamp_ns = 5000000000LL + static_cast<int64_t>(seq) * 10000000LL;
+        for (size_t c = 0; c < IMU_CHANNELS; c++) {
+            frame.sample_ns[c] = frame.timestamp_ns + 1200000LL * static_cast<int64_t>(c) + seq % 13;
+            frame.roll[c] = static_cast<int16_t>(std::sin(seq * 0.06 + c) * 30.0 * 16.0);
+        }
+        frame.valid_mask = 0x3f;
+        while (!log.push_record(imu_log_record(frame))) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    log.close();
+    ASSERT_EQ(log.written(), count);
+    EXPECT_LT(log.bytes_written() * 3, count * sizeof(ImuLogRecord));
+    EXPECT_EQ(read_file(path).size(), header.size() + log.bytes_written());
+
+    // Plain readers refuse it, the block reader and datasets take it
+    ExologReader plain;
+    EXPECT_EQ(plain.open(path), -1);
+
+    ExologBlockReader reader;
+    ASSERT_EQ(reader.open(path), 0);
+    EXPECT_EQ(reader.schema().locations, LOCATIONS);
+    std::vector<uint8_t> records;
+    uint64_t seq = 0;
+    while (size_t n = reader.next(records)) {
+        for (size_t r = 0; r < n; r++, seq++) {
+            ImuLogRecord record;
+            std::memcpy(&record, &records[r * sizeof(record)], sizeof(record));
+            ASSERT_EQ(record.sequence, seq);
+            ASSERT_EQ(record.sample_ns[3], 5000000000LL + static_cast<int64_t>(seq) * 10000000LL + 3600000 + seq % 13);
+        }
+    }
+    EXPECT_EQ(seq, count);
+    EXPECT_EQ(reader.bad_blocks(), 0u);
+
+    SensorDataset dataset;
+    ASSERT_EQ(dataset.load_exolog(path), 0);
+    ASSERT_EQ(dataset.frames(), count);
+    EXPECT_EQ(dataset.timestamp_ns()[10], 5100000000LL);
+    EXPECT_EQ(dataset.window(100, 30)(5, 2), static_cast<int16_t>(std::sin(105 * 0.06 + 2) * 30.0 * 16.0) / 16.0f);
+    std::remove(path.c_str());
+}
+
+TEST(ExologCodecTest, ReaderSkipsDamagedBlocksAndStopsAtATornOne) {
+    ExologSchema schema = mixed_schema();
+    schema.compression = EXOLOG_DELTA_VARINT;
+    std::vector<MixedRecord> records = mixed_records(400);
+
+    std::string file = exolog_header(schema);
+    std::vector<size_t> block_start;
+    ExologBlockEncoder encoder(schema);
+    for (size_t i = 0; i < 4; i++) {
+        std::vector<uint8_t> block;
+        encoder.encode(&records[i * 100], 100, block);
+        block_start.push_back(file.size());
+        file.append(block.begin(), block.end());
+    }
+    file[block_start[1] + 40] ^= 0x01;  // damage the second block
+    file.resize(file.size() - 5);  // and tear the last
+
+    std::string path = ::testing::TempDir() + "codec_damaged.exolog";
+    std::ofstream(path, std::ios::binary) << file;
+
+    ExologBlockReader reader;
+    ASSERT_EQ(reader.open(path), 0);
+    std::vector<uint8_t> block;
+    ASSERT_EQ(reader.next(block), 100u);
+    EXPECT_EQ(std::memcmp(block.data(), &records[0], block.size()), 0);
+    ASSERT_EQ(reader.next(block), 100u);
+    EXPECT_EQ(std::memcmp(block.data(), &records[200], block.size()), 0);
+    EXPECT_EQ(reader.next(block), 0u);
+    EXPECT_EQ(reader.bad_blocks(), 1u);
+
+    // Round trip through a plain file
+    std::string plain = ::testing::TempDir() + "codec_plain.exolog";
+    std::string again = ::testing::TempDir() + "codec_again.exolog";
+    EXPECT_EQ(exolog_decompress(path, plain), 200);
+    EXPECT_EQ(exolog_compress(plain, again, 64), 200);
+    EXPECT_EQ(exolog_decompress(again, plain), 200);
+    ExologReader decoded;
+    ASSERT_EQ(decoded.open(plain), 0);
+    EXPECT_TRUE(decoded.schema().compression.empty());
+    ASSERT_EQ(decoded.frames(), 200u);
+    EXPECT_EQ(std::memcmp(decoded.record(100), &records[200], 100 * sizeof(MixedRecord)), 0);
+    std::remove(path.c_str());
+    std::remove(plain.c_str());
+    std::remove(again.c_str());
+}
@@ -0,0 +1,214 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include "async_logger.h"
+#include "exolog.h"
+#include "imu_log_record.h"
+#include "imu_replay.h"
+
+static const std::vector<std::string> LOCATIONS = {"Left Hip", "Left Knee", "Left Ankle",
+                                                   "Right Ankle", "Right Knee", "Right Hip"};
+
+struct TestRecord {
+    int64_t t;
+    float angle[3];
+    uint8_t mask;
+};
+
+static ExologSchema test_schema() {
+    ExologSchema schema;
+    schema.period_ns = 10000000;
+    schema.locations = {"Left Hip", "Right Knee", "Right Hip"};
+    schema.append("timestamp_ns", ExologType::I64, 1, 1.0, "ns");
+    schema.append("angle", ExologType::F32, 3, 1.0, "deg");
+    schema.append("valid_mask", ExologType::U8, 1);
+    return schema;
+}
+
+TEST(ExologTest, HeaderDescribesTheRecord) {
+    ExologSchema schema = test_schema();
+    EXPECT_EQ(schema.record_size, sizeof(TestRecord));  // same padding as the struct
+    EXPECT_EQ(schema.find("angle")->offset, offsetof(TestRecord, angle));
+    EXPECT_EQ(schema.find("valid_mask")->offset, offsetof(TestRecord, mask));
+
+    std::string header = exolog_header(schema);
+    EXPECT_EQ(header.size() % 8, 0u);
+
+    ExologSchema parsed;
+    size_t header_size = 0;
+    ASSERT_EQ(parse_exolog_header(header.data(), header.size(), parsed, &header_size), 0);
+    EXPECT_EQ(header_size, header.size());
+    EXPECT_EQ(parsed.period_ns, schema.period_ns);
+    EXPECT_EQ(parsed.locations, schema.locations);
+    EXPECT_EQ(parsed.record_size, schema.record_size);
+    ASSERT_EQ(parsed.fields.size(), 3u);
+    EXPECT_EQ(parsed.fields[1].name, "angle");
+    EXPECT_EQ(parsed.fields[1].type, ExologType::F32);
+    EXPECT_EQ(parsed.fields[1].count, 3u);
+    EXPECT_EQ(parsed.fields[1].unit, "deg");
+    EXPECT_EQ(parsed.fields[2].unit, "");
+    EXPECT_EQ(parsed.realtime_offset_ns, 0);
+
+    schema.realtime_offset_ns = 1746885801000000000LL;
+    header = exolog_header(schema);
+    ASSERT_EQ(parse_exolog_header(header.data(), header.size(), parsed, &header_size), 0);
+    EXPECT_EQ(parsed.realtime_offset_ns, schema.realtime_offset_ns);
+
+    // Not an .exolog header, or cut short
+    EXPECT_EQ(parse_exolog_header("{\"sensors\": []}", 15, parsed, &header_size), -1);
+    EXPECT_EQ(parse_exolog_header(header.data(), header.size() - 8, parsed, &header_size), -1);
+}
+
+TEST(ExologTest, ReaderMapsFieldsAsFrameByChannelSpans) {
+    std::string path = ::testing::TempDir() + "spans.exolog";
+    ExologWriter writer;
+    ASSERT_EQ(writer.open(path, test_schema()), 0);
+    for (int t = 0; t < 100; t++) {
+        TestRecord r{};
+        r.t = 1000 + t * 10000000LL;
+        for (int c = 0; c < 3; c++) r.angle[c] = t + 0.25f * c;
+        r.mask = static_cast<uint8_t>(t % 8);
+        ASSERT_EQ(writer.write(&r), 0);
+    }
+    ASSERT_EQ(writer.close(), 0);
+
+    // A crash mid-record leaves a partial one at the end
+    std::ofstream(path, std::ios::app | std::ios::binary) << "partial";
+
+    ExologReader reader;
+    ASSERT_EQ(reader.open(path), 0);
+    EXPECT_EQ(reader.frames(), 100u);
+    EXPECT_EQ(reader.schema().channels(), 3u);
+
+    ExologSpan<float> angle = reader.field<float>("angle");
+    ASSERT_EQ(angle.rows(), 100u);
+    ASSERT_EQ(angle.cols(), 3u);
+    EXPECT_FLOAT_EQ(angle(42, 2), 42.5f);
+    EXPECT_FLOAT_EQ(angle.row(99)[1], 99.25f);
+    EXPECT_EQ(reader.field<int64_t>("timestamp_ns")(3, 0), 1000 + 30000000LL);
+    EXPECT_EQ(reader.field<uint8_t>("valid_mask")(13, 0), 5u);
+
+    // Wrong type or unknown field: nothing to view
+    EXPECT_TRUE(reader.field<double>("angle").empty());
+    EXPECT_TRUE(reader.field<float>("pitch").empty());
+    EXPECT_DOUBLE_EQ(reader.value(*reader.schema().find("angle"), 10, 1), 10.25);
+
+    reader.close();
+    std::remove(path.c_str());
+    EXPECT_EQ(reader.open(path), -1);
+}
+
+TEST(ExologTest, ControllerLogIsAnExolog) {
+    std::string path = ::testing::TempDir() + "controller.exolog";
+    std::string header = exolog_header(imu_log_schema(LOCATIONS, 100000000));
+    {
+        AsyncLogger log(sizeof(ImuLogRecord));
+        ASSERT_EQ(log.open(path, header.data(), header.size()), 0);
+        for (uint64_t seq = 0; seq < 50; seq++) {
+            ImuFrame frame{};
+            frame.sequence = seq;
+            frame.timestamp_ns = static_cast<int64_t>(seq) * 100000000;
+            for (size_t c = 0; c < IMU_CHANNELS; c++) {
+                frame.roll[c] = static_cast<int16_t>(16 * c - 8 * static_cast<int>(seq));
+            }
+            frame.valid_mask = 0x3F;
+            ASSERT_TRUE(log.push_record(imu_log_record(frame)));
+        }
+    }
+
+    ExologReader reader;
+    ASSERT_EQ(reader.open(path), 0);
+    EXPECT_EQ(reader.frames(), 50u);
+    EXPECT_EQ(reader.schema().locations, LOCATIONS);
+    ExologSpan<int16_t> roll = reader.field<int16_t>("roll");
+    ASSERT_EQ(roll.cols(), IMU_CHANNELS);
+    EXPECT_EQ(roll(10, 3), 16 * 3 - 80);
+    EXPECT_DOUBLE_EQ(reader.value(*reader.schema().find("roll"), 10, 3), -2.0);  // degrees
+    EXPECT_EQ(reader.field<uint64_t>("sequence")(49, 0), 49u);
+    std::remove(path.c_str());
+}
+
+#ifdef EXO_HAVE_IMU_REPLAY_JSON
+
+TEST(ExologTest, ConvertsJsonLinesBothWays) {
+    std::string json_path = ::testing::TempDir() + "recording.json";
+    std::string exolog_path = ::testing::TempDir() + "recording.exolog";
+    std::string back_path = ::testing::TempDir() + "recording_back.json";
+    {
+        // Recorded sensor order differs from sensorLocations, the second line misses a sensor
+        std::ofstream out(json_path);
+        out << R"({"sensors": [{"euler": {"heading": 1.5, "pitch": -2.0, "roll": 6.8218}, "location": "Left Knee"},)"
+            << R"( {"euler": {"heading": 0.0, "pitch": 0.0, "roll": -14.25}, "location": "Right Hip"}],)"
+            << R"( "timestamp": "2025-05-10 14:03:21.120"})" << "\n";
+        out << R"({"sensors": [{"euler": {"heading": 2.0, "pitch": 1.0, "roll": 7.0}, "location": "Left Knee"}],)"
+            << R"( "timestamp": "2025-05-10 14:03:21.220"})" << "\n";
+    }
+    ASSERT_EQ(jsonl_to_exolog(json_path, exolog_path, LOCATIONS), 2);
+
+    {
+        ExologReader reader;
+        ASSERT_EQ(reader.open(exolog_path), 0);
+        EXPECT_EQ(reader.frames(), 2u);
+        ExologSpan<float> roll = reader.field<float>("roll");
+        EXPECT_FLOAT_EQ(roll(0, 1), 6.8218f);   // Left Knee
+        EXPECT_FLOAT_EQ(roll(0, 5), -14.25f);   // Right Hip
+        EXPECT_FLOAT_EQ(reader.field<float>("pitch")(1, 1), 1.0f);
+        EXPECT_EQ(reader.field<uint8_t>("valid_mask")(0, 0), 0x22);
+        EXPECT_EQ(reader.field<uint8_t>("valid_mask")(1, 0), 0x02);
+        ExologSpan<int64_t> t = reader.field<int64_t>("timestamp_ns");
+        EXPECT_EQ(t(1, 0) - t(0, 0), 100000000);
+    }
+
+    // Back to JSON lines, readable by the existing loaders
+    ASSERT_EQ(exolog_to_jsonl(exolog_path, back_path), 2);
+    std::ifstream back(back_path);
+    std::string line;
+    std::getline(back, line);
+    EXPECT_NE(line.find("\"timestamp\":\"2025-05-10 14:03:21.120\""), std::string::npos);
+    EXPECT_EQ(line.find("Left Hip"), std::string::npos);  // not in the recording
+
+    ImuReplay original, converted;
+    ASSERT_EQ(load_imu_replay(json_path, LOCATIONS, original), 0);
+    ASSERT_EQ(load_imu_replay(back_path, LOCATIONS, converted), 0);
+    EXPECT_EQ(converted.timestamp_ns, original.timestamp_ns);
+    for (size_t f = 0; f < original.frames(); f++) {
+        for (size_t c = 0; c < LOCATIONS.size(); c++) {
+            EXPECT_EQ(converted.at(f, c).r, original.at(f, c).r);
+            EXPECT_EQ(converted.at(f, c).p, original.at(f, c).p);
+        }
+    }
+
+    // JSON input is not mistaken for an .exolog
+    EXPECT_EQ(exolog_to_jsonl(json_path, back_path), -1);
+    std::remove(json_path.c_str());
+    std::remove(exolog_path.c_str());
+    std::remove(back_path.c_str());
+}
+
+TEST(ExologTest, ControllerLogConvertsToEpochTimestamps) {
+    std::string exolog_path = ::testing::TempDir() + "monotonic.exolog";
+    std::string json_path = ::testing::TempDir() + "monotonic.json";
+    ExologSchema schema = imu_log_schema(LOCATIONS, 100000000);
+    EXPECT_NE(schema.realtime_offset_ns, 0);
+
+    // Five seconds after boot, the clock read 2025-05-10 14:03:21 at boot
+    schema.realtime_offset_ns = 1746885801000000000LL;
+    ExologWriter writer;
+    ASSERT_EQ(writer.open(exolog_path, schema), 0);
+    ImuFrame frame{};
+    frame.timestamp_ns = 5000000000LL;
+    frame.valid_mask = 0x01;
+    ImuLogRecord record = imu_log_record(frame);
+    ASSERT_EQ(writer.write(&record), 0);
+    ASSERT_EQ(writer.close(), 0);
+
+    ASSERT_EQ(exolog_to_jsonl(exolog_path, json_path), 1);
+    std::ifstream back(json_path);
+    std::string line;
+    std::getline(back, line);
+    EXPECT_NE(line.find("\"timestamp\":\"2025-05-10 14:03:26.000\""), std::string::npos) << line;
+    std::remove(exolog_path.c_str());
+    std::remove(json_path.c_str());
+}
+
+#endif  // EXO_HAVE_IMU_REPLAY_JSON
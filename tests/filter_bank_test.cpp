@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "filter_bank.h"
+
+static FilterBank::Config lowpass_and_notch(double sample_rate_hz) {
+    FilterBank::Config config;
+    config.sample_rate_hz = sample_rate_hz;
+    config.stages = {{FilterBank::Type::LOWPASS, 8.0, 0.0}, {FilterBank::Type::NOTCH, 25.0, 0.0}};
+    return config;
+}
+
+// Channel c carries a sine at frequency_hz with its own phase and offset
+static std::vector<float> sines(size_t channels, size_t frames, double frequency_hz, double sample_rate_hz) {
+    std::vector<float> signal(channels * frames);
+    for (size_t t = 0; t < frames; t++) {
+        for (size_t c = 0; c < channels; c++) {
+            signal[t * channels + c] = static_cast<float>(
+                10.0 * std::sin(2.0 * M_PI * frequency_hz * t / sample_rate_hz + c * 0.7));
+        }
+    }
+    return signal;
+}
+
+TEST(FilterBankTest, DesignedSectionsMeetTheirSpec) {
+    BiquadCoefficients lowpass = design_lowpass(5.0, 100.0);
+    EXPECT_NEAR(biquad_magnitude(lowpass, 0.0, 100.0), 1.0, 1e-5);
+    EXPECT_NEAR(biquad_magnitude(lowpass, 5.0, 100.0), std::sqrt(0.5), 1e-4);  // -3 dB
+    EXPECT_LT(biquad_magnitude(lowpass, 20.0, 100.0), 0.07);                  // 12 dB/octave
+    EXPECT_LT(biquad_magnitude(lowpass, 49.9, 100.0), 1e-3);
+
+    BiquadCoefficients notch = design_notch(50.0, 200.0, 5.0);
+    EXPECT_LT(biquad_magnitude(notch, 50.0, 200.0), 1e-5);
+    EXPECT_NEAR(biquad_magnitude(notch, 0.0, 200.0), 1.0, 1e-5);
+    EXPECT_GT(biquad_magnitude(notch, 30.0, 200.0), 0.9);
+    // -3 dB about center / q wide, well below Nyquist
+    BiquadCoefficients narrow = design_notch(5.0, 200.0, 5.0);
+    const double half = std::sqrt(1.0 + 1.0 / 100.0), offset = 1.0 / 10.0;  // edges f0 (sqrt(1 + 1/4q^2) -+ 1/2q)
+    EXPECT_NEAR(biquad_magnitude(narrow, 5.0 * (half - offset), 200.0), std::sqrt(0.5), 0.01);
+    EXPECT_NEAR(biquad_magnitude(narrow, 5.0 * (half + offset), 200.0), std::sqrt(0.5), 0.01);
+}
+
+TEST(FilterBankTest, MeasuredResponseMatchesTheDesign) {
+    const double rate = 100.0;
+    const size_t channels = 6, frames = 4000, settled = 3000;
+    FilterBank bank;
+    ASSERT_EQ(bank.configure(channels, lowpass_and_notch(rate)), 0);
+    ASSERT_EQ(bank.stages(), 2u);
+
+    for (double frequency : {0.5, 2.0, 8.0, 15.0, 25.0, 40.0}) {
+        std::vector<float> signal = sines(channels, frames, frequency, rate);
+        bank.reset();
+        bank.process(signal.data(), signal.data(), frames);
+
+        for (size_t c = 0; c < channels; c++) {
+            double power = 0.0;
+            for (size_t t = settled; t < frames; t++) power += signal[t * channels + c] * signal[t * channels + c];
+            double amplitude = std::sqrt(2.0 * power / (frames - settled)) / 10.0;
+            EXPECT_NEAR(amplitude, bank.magnitude(frequency), 0.01) << frequency << " Hz, channel " << c;
+        }
+    }
+    EXPECT_NEAR(bank.magnitude(8.0), std::sqrt(0.5) * biquad_magnitude(bank.coefficients(1), 8.0, rate), 1e-4);
+    EXPECT_LT(bank.magnitude(25.0), 1e-4);
+}
+
+// The transposed direct form II recurrence, one channel at a time in double
+TEST(FilterBankTest, MatchesTheScalarRecurrenceInAnyChunking) {
+    const double rate = 60.0;
+    for (size_t channels : {1, 6, 11}) {
+        FilterBank bank;
+        ASSERT_EQ(bank.configure(channels, lowpass_and_notch(rate)), 0);
+        std::vector<float> signal = sines(channels, 500, 3.0, rate);
+        for (size_t i = 0; i < signal.size(); i += 7) signal[i] += 4.0f;  // something off the sine
+
+        std::vector<double> expected(signal.begin(), signal.end());
+        for (size_t s = 0; s < bank.stages(); s++) {
+            const BiquadCoefficients& k = bank.coefficients(s);
+            for (size_t c = 0; c < channels; c++) {
+                double z1 = 0.0, z2 = 0.0;
+                for (size_t t = 0; t < 500; t++) {
+                    double x = expected[t * channels + c];
+                    double y = k.b0 * x + z1;
+                    z1 = k.b1 * x - k.a1 * y + z2;
+                    z2 = k.b2 * x - k.a2 * y;
+                    expected[t * channels + c] = y;
+                }
+            }
+        }
+
+        // Per control tick, and in uneven blocks, into a separate buffer
+        std::vector<float> ticked(signal.size()), blocks(signal.size());
+        for (size_t t = 0; t < 500; t++) bank.process(&signal[t * channels], &ticked[t * channels]);
+        bank.reset();
+        for (size_t t = 0; t < 500; t += 33) {
+            size_t n = std::min<size_t>(33, 500 - t);
+            bank.process(&signal[t * channels], &blocks[t * channels], n);
+        }
+        for (size_t i = 0; i < signal.size(); i++) {
+            ASSERT_NEAR(ticked[i], expected[i], 1e-3) << channels << " channels, value " << i;
+            ASSERT_EQ(blocks[i], ticked[i]) << channels << " channels, value " << i;
+        }
+    }
+}
+
+TEST(FilterBankTest, PrimedBankHoldsAConstantInput) {
+    FilterBank bank;
+    ASSERT_EQ(bank.configure(6, lowpass_and_notch(100.0)), 0);
+    const float frame[6] = {-170.0f, -3.5f, 0.0f, 12.25f, 90.0f, 179.0f};
+    bank.prime(frame);
+    for (int t = 0; t < 50; t++) {
+        float out[6];
+        bank.process(frame, out);
+        for (size_t c = 0; c < 6; c++) ASSERT_NEAR(out[c], frame[c], 1e-3) << t;
+    }
+
+    // Unprimed it starts from zero
+    bank.reset();
+    float out[6];
+    bank.process(frame, out);
+    EXPECT_LT(std::fabs(out[5]), 20.0f);
+}
+
+TEST(FilterBankTest, RejectsFrequenciesOutsideTheBand) {
+    FilterBank bank;
+    FilterBank::Config config;
+    config.sample_rate_hz = 10.0;
+    for (double frequency : {0.0, -1.0, 5.0, 7.0}) {
+        config.stages = {{FilterBank::Type::LOWPASS, 1.0, 0.0}, {FilterBank::Type::NOTCH, frequency, 0.0}};
+        EXPECT_EQ(bank.configure(6, config), -1) << frequency;
+        EXPECT_EQ(bank.stages(), 0u);
+    }
+
+    config.stages.assign(FilterBank::MAX_STAGES + 1, {FilterBank::Type::LOWPASS, 1.0, 0.0});
+    EXPECT_EQ(bank.configure(6, config), -1);
+
+    // Without sections it passes samples through
+    config.stages.clear();
+    ASSERT_EQ(bank.configure(6, config), 0);
+    float frame[6] = {1, 2, 3, 4, 5, 6}, out[6];
+    bank.process(frame, out);
+    EXPECT_EQ(std::vector<float>(out, out + 6), std::vector<float>(frame, frame + 6));
+    EXPECT_EQ(bank.magnitude(3.0), 1.0);
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include "frame_aligner.h"
+
+static const int64_t MS = 1000000;
+
+// Every channel sees the same ramp of 0.1 degree per ms, but channel i is
+// read 15 ms * i + 5 ms after the sweep starts, like behind the mux
+static float ramp_deg(int64_t t_ns) {
+    return static_cast<float>(t_ns / MS) * 0.1f;
+}
+
+static ImuFrame skewed_sweep(uint64_t sequence, int64_t start_ns) {
+    ImuFrame frame{};
+    frame.sequence = sequence;
+    frame.timestamp_ns = start_ns;
+    for (size_t i = 0; i < IMU_CHANNELS; i++) {
+        frame.sample_ns[i] = start_ns + static_cast<int64_t>(15 * i + 5) * MS;
+        frame.roll[i] = static_cast<int16_t>(ramp_deg(frame.sample_ns[i]) * ROLL_LSB_PER_DEG);
+        frame.valid_mask |= 1u << i;
+    }
+    return frame;
+}
+
+TEST(FrameAlignerTest, FirstSweepPassesThrough) {
+    FrameAligner aligner;
+    AlignedFrame out;
+    ImuFrame frame = skewed_sweep(0, 1000 * MS);
+    aligner.align(frame, out);
+
+    EXPECT_EQ(out.time_ns, frame.timestamp_ns);
+    EXPECT_EQ(out.valid_mask, 0x3F);
+    for (size_t i = 0; i < IMU_CHANNELS; i++) EXPECT_FLOAT_EQ(out.roll[i], roll_deg(frame, i));
+}
+
+TEST(FrameAlignerTest, RemovesMuxSkewFromARamp) {
+    FrameAligner aligner;
+    AlignedFrame out;
+
+    for (uint64_t k = 0; k < 10; k++) {
+        int64_t start = (100 + 100 * static_cast<int64_t>(k)) * MS;
+        aligner.align(skewed_sweep(k, start), out);
+        if (k == 0) continue;
+
+        // Unaligned, the last channel would read 8 degrees ahead of the first
+        for (size_t i = 0; i < IMU_CHANNELS; i++) {
+            EXPECT_NEAR(out.roll[i], ramp_deg(start), 1.0f / ROLL_LSB_PER_DEG) << "channel " << i;
+        }
+    }
+}
+
+TEST(FrameAlignerTest, FailedChannelHoldsLastGoodValue) {
+    FrameAligner aligner;
+    AlignedFrame out;
+    aligner.align(skewed_sweep(0, 1000 * MS), out);
+    float held = out.roll[2];
+
+    ImuFrame frame = skewed_sweep(1, 1100 * MS);
+    frame.valid_mask &= ~(1u << 2);
+    aligner.align(frame, out);
+    EXPECT_FALSE(out.valid_mask & (1u << 2));
+    EXPECT_FLOAT_EQ(out.roll[2], held);
+
+    // Recovery interpolates from the last good sample across the gap
+    aligner.align(skewed_sweep(2, 1200 * MS), out);
+    EXPECT_TRUE(out.valid_mask & (1u << 2));
+    EXPECT_NEAR(out.roll[2], ramp_deg(1200 * MS), 1.0f / ROLL_LSB_PER_DEG);
+}
+
+TEST(FrameAlignerTest, CarriedChannelKeepsItsValueAndAge) {
+    FrameAligner aligner;
+    AlignedFrame out;
+    aligner.align(skewed_sweep(0, 100 * MS), out);
+    aligner.align(skewed_sweep(1, 200 * MS), out);
+    float carried = roll_deg(skewed_sweep(1, 200 * MS), 2);
+
+    // Channel 2 is not due: same sample as last sweep, still valid
+    ImuFrame frame = skewed_sweep(2, 300 * MS);
+    ImuFrame previous = skewed_sweep(1, 200 * MS);
+    frame.roll[2] = previous.roll[2];
+    frame.sample_ns[2] = previous.sample_ns[2];
+    aligner.align(frame, out);
+
+    EXPECT_TRUE(out.valid_mask & (1u << 2));
+    EXPECT_FLOAT_EQ(out.roll[2], carried);
+    EXPECT_EQ(out.age_ns[2], 300 * MS - previous.sample_ns[2]);
+    EXPECT_EQ(out.age_ns[1], 0);  // interpolated to the sweep start
+
+    // Its next read interpolates from the carried sample
+    aligner.align(skewed_sweep(3, 400 * MS), out);
+    EXPECT_NEAR(out.roll[2], ramp_deg(400 * MS), 1.0f / ROLL_LSB_PER_DEG);
+    EXPECT_EQ(out.age_ns[2], 0);
+}
+
+TEST(FrameAlignerTest, InterpolatesAcrossTheWrap) {
+    EXPECT_FLOAT_EQ(interpolate_angle_deg(170.0f, -170.0f, 0.5f), -180.0f);
+    EXPECT_FLOAT_EQ(interpolate_angle_deg(170.0f, -170.0f, 0.25f), 175.0f);
+    EXPECT_FLOAT_EQ(interpolate_angle_deg(-10.0f, 30.0f, 0.25f), 0.0f);
+}
@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+#include <type_traits>
+#include <utility>
+#include "frame_types.h"
+#include "ring_window.h"
+
+// Frames are plain inline arrays: no heap, copied with memcpy
+static_assert(sizeof(RollFrame) == 6 * sizeof(float), "RollFrame is six floats");
+static_assert(sizeof(TorqueCommand) == 4 * sizeof(int16_t), "TorqueCommand is four int16_t");
+static_assert(std::is_trivially_copyable<JointAngles>::value, "JointAngles copies as bytes");
+static_assert(JointAngles::size() == 6 && TorqueCommand::size() == 4, "channel counts come from the enums");
+
+template <typename Frame, typename Index, typename = void>
+struct indexable_by : std::false_type {};
+template <typename Frame, typename Index>
+struct indexable_by<Frame, Index, decltype(void(std::declval<Frame&>()[std::declval<Index>()]))> : std::true_type {};
+
+static_assert(indexable_by<JointAngles, Joint>::value, "joints index joint frames");
+static_assert(!indexable_by<JointAngles, MotorChannel>::value, "motor channels do not index joint frames");
+static_assert(!indexable_by<JointAngles, size_t>::value, "nor do bare numbers");
+
+TEST(FrameTypesTest, NamedChannelsKeepTheControllerIndices) {
+    JointAngles angles;
+    for (size_t i = 0; i < angles.size(); ++i) angles.values[i] = static_cast<float>(i);
+    // clean_angles[0] lk, [3] rh, [4] rk, [5] lh before the names
+    EXPECT_EQ(angles[Joint::LEFT_KNEE], 0.0f);
+    EXPECT_EQ(angles[Joint::RIGHT_HIP], 3.0f);
+    EXPECT_EQ(angles[Joint::RIGHT_KNEE], 4.0f);
+    EXPECT_EQ(angles[Joint::LEFT_HIP], 5.0f);
+
+    TorqueCommand torque;
+    EXPECT_EQ(torque, TorqueCommand());  // zero initialized
+    torque[MotorChannel::LEFT_HIP] = -120;
+    EXPECT_EQ(torque.values[2], -120);
+    int sum = 0;
+    for (int16_t t : torque) sum += t;
+    EXPECT_EQ(sum, -120);
+}
+
+TEST(FrameTypesTest, RollFramesGoThroughARingWindow) {
+    RingWindow<float, RollFrame::SIZE, 4> history;
+    for (int f = 0; f < 6; ++f) {
+        RollFrame roll;
+        roll[ImuChannel::RIGHT_HIP] = static_cast<float>(f);
+        history.push(roll.data());
+    }
+    EXPECT_EQ(history.last(4)(0, static_cast<size_t>(ImuChannel::RIGHT_HIP)), 2.0f);
+    EXPECT_EQ(history.last(4)(3, static_cast<size_t>(ImuChannel::RIGHT_HIP)), 5.0f);
+}
@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include <csignal>
+#include <sstream>
+#include "bno055_device.h"
+#include "i2c_stats.h"
+#include "rpi_tca9548a.h"
+#include "sim_i2c_bus.h"
+
+static const u8 IMU_ADDR = BNO055_I2C_ADDR2;
+static const u8 MUX_ADDR = 0x70;
+
+TEST(I2CStatsTest, HistogramBucketsArePowersOfTwoMicroseconds) {
+    LatencyHistogram h;
+    h.record(500, true);       // < 1 us
+    h.record(3000, true);      // [2, 4) us
+    h.record(3500, false);
+    h.record(900000, true);    // [512, 1024) us
+
+    EXPECT_EQ(h.count.load(), 4u);
+    EXPECT_EQ(h.errors.load(), 1u);
+    EXPECT_EQ(h.max_ns.load(), 900000u);
+    EXPECT_EQ(h.buckets[0].load(), 1u);
+    EXPECT_EQ(h.buckets[2].load(), 2u);
+    EXPECT_EQ(h.buckets[10].load(), 1u);
+    EXPECT_EQ(h.quantile_us(0.5), 4u);
+    EXPECT_EQ(h.quantile_us(0.99), 1024u);
+
+    h.reset();
+    EXPECT_EQ(h.count.load(), 0u);
+    EXPECT_EQ(h.quantile_us(0.5), 0u);
+}
+
+TEST(I2CStatsTest, RecordsPerChannelAndOperation) {
+    if (!I2CStats::enabled) GTEST_SKIP() << "built without EXO_I2C_STATS";
+
+    SimulatedI2CBus bus;
+    bus.add_bno055(2, IMU_ADDR, 0);
+    rpi_tca9548a tca;
+    ASSERT_EQ(tca.init(MUX_ADDR, bus), 0);
+    Bno055Device imu(bus, IMU_ADDR, &tca, 2);
+    ASSERT_EQ(imu.init(), BNO055_SUCCESS);
+
+    I2CStats* stats = bus.io_stats();
+    stats->reset();
+    bno055_euler_t euler;
+    for (int i = 0; i < 10; i++) ASSERT_EQ(imu.read_euler_raw(&euler), BNO055_SUCCESS);
+
+    const LatencyHistogram* reads = stats->histogram(2, IMU_ADDR, I2COp::READ);
+    ASSERT_NE(reads, nullptr);
+    EXPECT_GE(reads->count.load(), 10u);
+    EXPECT_EQ(reads->errors.load(), 0u);
+    EXPECT_EQ(stats->histogram(3, IMU_ADDR, I2COp::READ), nullptr);
+
+    // A sensor that is gone shows up as errors on its own channel
+    bus.set_present(2, IMU_ADDR, false);
+    EXPECT_NE(imu.read_euler_raw(&euler), BNO055_SUCCESS);
+    EXPECT_EQ(reads->errors.load(), 1u);
+
+    // Mux switches are counted against the mux address and the new channel
+    Bno055Device other(bus, IMU_ADDR, &tca, 5);
+    other.init();
+    const LatencyHistogram* mux = stats->histogram(5, MUX_ADDR, I2COp::MUX_SWITCH);
+    ASSERT_NE(mux, nullptr);
+    EXPECT_EQ(mux->count.load(), 1u);
+    ASSERT_NE(stats->histogram(5, IMU_ADDR, I2COp::WRITE), nullptr);
+    EXPECT_EQ(stats->histogram(5, IMU_ADDR, I2COp::WRITE)->errors.load(), 1u);  // nobody there
+
+    std::ostringstream report;
+    stats->dump(report);
+    EXPECT_NE(report.str().find("I2C sim"), std::string::npos);
+    EXPECT_NE(report.str().find("ch2 0x29 read "), std::string::npos);
+    EXPECT_NE(report.str().find("ch5 0x70 mux "), std::string::npos);
+}
+
+TEST(I2CStatsTest, ReselectingTheOpenChannelRestoresIt) {
+    if (!I2CStats::enabled) GTEST_SKIP() << "built without EXO_I2C_STATS";
+
+    SimulatedI2CBus bus;
+    bus.add_bno055(2, IMU_ADDR, 0);
+    rpi_tca9548a tca;
+    ASSERT_EQ(tca.init(MUX_ADDR, bus), 0);
+    tca.set_settle_time_us(0);
+    ASSERT_EQ(tca.set_channel(2), 0);
+
+    // Another mux on the bus switched in between; this one is still on 2
+    I2CStats* stats = bus.io_stats();
+    stats->set_channel(5);
+    const uint64_t mux_writes = bus.stats().mux_writes;
+    ASSERT_EQ(tca.set_channel(2), 0);
+    EXPECT_EQ(bus.stats().mux_writes, mux_writes);
+
+    u8 id = 0;
+    ASSERT_EQ(bus.read(IMU_ADDR, BNO055_CHIP_ID_ADDR, &id, 1), BNO055_SUCCESS);
+    ASSERT_NE(stats->histogram(2, IMU_ADDR, I2COp::READ), nullptr);
+    EXPECT_EQ(stats->histogram(5, IMU_ADDR, I2COp::READ), nullptr);
+}
+
+TEST(I2CStatsTest, SigusrRequestsADump) {
+    SimulatedI2CBus bus;
+    u8 data = 0;
+    bus.read(IMU_ADDR, 0, &data, 1);  // something to report
+
+    i2c_stats_install_signal();
+    std::ostringstream out;
+    EXPECT_FALSE(i2c_stats_poll(out));
+    std::raise(SIGUSR1);
+    EXPECT_TRUE(i2c_stats_poll(out));
+    EXPECT_FALSE(i2c_stats_poll(out));
+    if (I2CStats::enabled) {
+        EXPECT_NE(out.str().find("I2C sim"), std::string::npos);
+    }
+}
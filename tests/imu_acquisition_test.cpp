@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+#include "imu_acquisition.h"
+
+TEST(ImuAcquisitionTest, PublishesTimestampedFrames) {
+    int sweeps = 0;
+    ImuAcquisition acquisition(
+        [&](ImuFrame& frame) {
+            for (size_t i = 0; i < IMU_CHANNELS; ++i) frame.roll[i] = static_cast<int16_t>(sweeps * 16);
+            frame.valid_mask = 0x3F;
+            ++sweeps;
+        },
+        std::chrono::milliseconds(2));
+
+    ASSERT_TRUE(acquisition.start());
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    acquisition.stop();
+
+    ImuFrame frame;
+    uint64_t expected_sequence = 0;
+    int64_t last_timestamp = 0;
+    while (acquisition.pop(frame)) {
+        EXPECT_EQ(frame.sequence, expected_sequence);
+        EXPECT_EQ(roll_deg(frame, 0), static_cast<float>(expected_sequence));
+        EXPECT_EQ(frame.valid_mask, 0x3F);
+        EXPECT_GT(frame.timestamp_ns, last_timestamp);
+        last_timestamp = frame.timestamp_ns;
+        ++expected_sequence;
+    }
+    EXPECT_GT(expected_sequence, 5u);
+    EXPECT_EQ(acquisition.frames_published(), expected_sequence);
+    EXPECT_EQ(acquisition.dropped_frames(), 0u);
+}
+
+TEST(ImuAcquisitionTest, CountsDroppedFramesWhenNotDrained) {
+    ImuAcquisition acquisition([](ImuFrame&) {}, std::chrono::microseconds(100));
+
+    ASSERT_TRUE(acquisition.start());
+    while (acquisition.frames_published() + acquisition.dropped_frames() < ImuAcquisition::RING_CAPACITY + 10) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    acquisition.stop();
+
+    EXPECT_EQ(acquisition.frames_published(), ImuAcquisition::RING_CAPACITY);
+    EXPECT_GE(acquisition.dropped_frames(), 10u);
+}
+
+TEST(ImuAcquisitionTest, CountsOverrunsForSlowSweeps) {
+    ImuAcquisition acquisition(
+        [](ImuFrame&) { std::this_thread::sleep_for(std::chrono::milliseconds(3)); },
+        std::chrono::milliseconds(1));
+
+    ASSERT_TRUE(acquisition.start());
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    acquisition.stop();
+
+    EXPECT_GT(acquisition.overruns(), 0u);
+}
@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <random>
+#include "imu_jsonl_scan.h"
+
+#ifdef EXO_HAVE_IMU_REPLAY_JSON
+#include <nlohmann/json.hpp>
+#endif
+
+static const std::vector<std::string> LOCATIONS = {"Left Hip", "Left Knee", "Left Ankle",
+                                                   "Right Ankle", "Right Knee", "Right Hip"};
+
+static bool scan(const std::string& text, ImuJsonLine& line, uint32_t fields = IMU_JSON_ALL) {
+    return scan_imu_json_line(text.data(), text.data() + text.size(), fields, line);
+}
+
+static int64_t utc_ns(int year, int month, int day, int hour, int minute, int second, int64_t ns) {
+    std::tm tm = {};
+    tm.tm_year = year - 1900;
+    tm.tm_mon = month - 1;
+    tm.tm_mday = day;
+    tm.tm_hour = hour;
+    tm.tm_min = minute;
+    tm.tm_sec = second;
+    return static_cast<int64_t>(timegm(&tm)) * 1000000000LL + ns;
+}
+
+TEST(ImuJsonlScanTest, PullsFieldsOutOfARecordedLine) {
+    ImuJsonLine line;
+    ASSERT_TRUE(scan(R"({"sensors": [{"euler": {"heading": 21.968124999999986, "pitch": -7.41062500000001, )"
+                     R"("roll": 6.821874999999999}, "location": "Left Knee"}, {"euler": {"heading": 4.4, )"
+                     R"("pitch": -4.1, "roll": -1.8125}, "location": "Left Ankle"}], )"
+                     R"("timestamp": "2025-05-10 14:03:21.120"})", line));
+    ASSERT_EQ(line.sensors, 2u);
+    EXPECT_TRUE(line.is_location(0, "Left Knee"));
+    EXPECT_TRUE(line.is_location(1, "Left Ankle"));
+    EXPECT_FALSE(line.is_location(1, "Left Ankl"));
+    EXPECT_EQ(line.sensor[0].roll, static_cast<float>(6.821874999999999));
+    EXPECT_EQ(line.sensor[0].heading, static_cast<float>(21.968124999999986));
+    EXPECT_EQ(line.sensor[0].pitch, static_cast<float>(-7.41062500000001));
+    EXPECT_EQ(line.sensor[1].roll, -1.8125f);
+    ASSERT_TRUE(line.has_timestamp);
+    EXPECT_EQ(line.timestamp_ns, utc_ns(2025, 5, 10, 14, 3, 21, 120000000));
+
+    // Only what was asked for
+    ASSERT_TRUE(scan(R"({"sensors": [{"euler": {"heading": 1.5, "roll": 2.5}, "location": "Left Hip"}], )"
+                     R"("timestamp": "2025-05-10 14:03:21.120"})", line, IMU_JSON_ROLL));
+    EXPECT_EQ(line.sensor[0].roll, 2.5f);
+    EXPECT_EQ(line.sensor[0].heading, 0.0f);
+    EXPECT_FALSE(line.has_timestamp);
+}
+
+TEST(ImuJsonlScanTest, SkipsWhatItDoesNotKnow) {
+    ImuJsonLine line;
+    ASSERT_TRUE(scan(R"(  { "meta" : {"note": "a \"quoted\" } and ] in a string", "list": [1, [2, {"x": null}], true]},)"
+                     "\n"
+                     R"( "sensors":[ {"location":"Right Hip" , "calib": [3,3,3,3], "euler":{"roll":-1.5e1,"extra":{"deep":[false]}}},)"
+                     R"( {"location": "Right Knee"} ] } )", line));
+    ASSERT_EQ(line.sensors, 2u);
+    EXPECT_TRUE(line.is_location(0, "Right Hip"));
+    EXPECT_TRUE(line.sensor[0].has_euler);
+    EXPECT_EQ(line.sensor[0].roll, -15.0f);
+    EXPECT_FALSE(line.sensor[1].has_euler);
+    EXPECT_FALSE(line.has_timestamp);
+
+    // Not sensor lines, or broken ones
+    EXPECT_FALSE(scan("", line));
+    EXPECT_FALSE(scan("[1, 2]", line));
+    EXPECT_FALSE(scan(R"({"timestamp": "2025-05-10 14:03:21.120"})", line));
+    EXPECT_FALSE(scan(R"({"sensors": [{"euler": {"roll": 1.0}, "location": "Left Hip"})", line));  // cut short
+    EXPECT_FALSE(scan(R"({"sensors": [{"euler": {"roll": "x"}}]})", line));
+    EXPECT_FALSE(scan(R"({"sensors": [{"location": "Left Hip)", line));
+}
+
+TEST(ImuJsonlScanTest, NumbersMatchStrtod) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> angle(-180.0, 180.0);
+    char text[128];
+    ImuJsonLine line;
+    for (int i = 0; i < 2000; i++) {
+        double v = angle(rng);
+        const char* format = i % 3 == 0 ? "%.17g" : i % 3 == 1 ? "%.16g" : "%.4f";
+        char number[40];
+        std::snprintf(number, sizeof(number), format, v);
+        std::snprintf(text, sizeof(text), R"({"sensors": [{"euler": {"roll": %s}, "location": "a"}]})", number);
+        ASSERT_TRUE(scan(text, line));
+        ASSERT_EQ(line.sensor[0].roll, static_cast<float>(std::strtod(number, nullptr))) << number;
+    }
+}
+
+TEST(ImuJsonlScanTest, ColumnsFollowTheLocations) {
+    std::string text =
+        R"({"sensors": [{"euler": {"roll": 1.0, "pitch": 9.0}, "location": "Right Hip"}, )"
+        R"({"euler": {"roll": 2.0}, "location": "Left Hip"}, {"euler": {"roll": 3.0}, "location": "Spine"}], )"
+        R"("timestamp": "2025-05-10 14:03:21.100"})" "\n"
+        "\n"
+        "not json\n"
+        R"({"sensors": [{"euler": {"roll": 4.0}, "location": "Left Knee"}]})" "\n"
+        R"({"sensors": [], "timestamp": "2025-05-10 14:03:22.5"})";
+
+    ImuJsonlScanner scanner(LOCATIONS, IMU_JSON_TIMESTAMP | IMU_JSON_ROLL, 50000000);
+    ImuJsonlColumns columns;
+    scanner.prepare(columns, 8);
+    EXPECT_EQ(scanner.scan(text.data(), text.size(), columns), 3u);
+    ASSERT_EQ(columns.frames(), 3u);
+    EXPECT_TRUE(columns.heading.empty());
+    EXPECT_TRUE(columns.pitch.empty());
+    ASSERT_EQ(columns.roll.size(), LOCATIONS.size());
+
+    EXPECT_EQ(columns.valid_mask[0], 0x21);  // Left Hip and Right Hip, Spine is not a channel
+    EXPECT_EQ(columns.roll[0][0], 2.0f);
+    EXPECT_EQ(columns.roll[5][0], 1.0f);
+    EXPECT_EQ(columns.valid_mask[1], 0x02);
+    EXPECT_EQ(columns.roll[1][1], 4.0f);
+    EXPECT_EQ(columns.roll[0][1], 0.0f);
+    EXPECT_EQ(columns.valid_mask[2], 0x00);
+
+    int64_t t0 = utc_ns(2025, 5, 10, 14, 3, 21, 100000000);
+    EXPECT_EQ(columns.timestamp_ns[0], t0);
+    EXPECT_EQ(columns.timestamp_ns[1], t0 + 50000000);  // no timestamp: one default period on
+    EXPECT_EQ(columns.timestamp_ns[2], utc_ns(2025, 5, 10, 14, 3, 22, 500000000));
+}
+
+#ifdef EXO_HAVE_IMU_REPLAY_JSON
+
+TEST(ImuJsonlScanTest, FileScanMatchesTheJsonDom) {
+    std::string path = ::testing::TempDir() + "scan_vs_dom.json";
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> angle(-90.0, 90.0);
+    {
+        std::ofstream out(path);
+        for (int f = 0; f < 500; f++) {
+            nlohmann::json entry;
+            entry["timestamp"] = "2025-05-10 14:03:" + std::to_string(10 + f / 10) + "." + std::to_string(f % 10) + "00";
+            entry["sensors"] = nlohmann::json::array();
+            for (size_t c = 0; c < LOCATIONS.size(); c++) {
+                if ((f + c) % 11 == 0) continue;  // a sensor missing now and then
+                entry["sensors"].push_back({{"location", LOCATIONS[(c + f) % LOCATIONS.size()]},
+                                            {"euler", {{"heading", angle(rng)}, {"roll", angle(rng)}, {"pitch", angle(rng)}}}});
+            }
+            out << entry.dump() << "\n";
+        }
+    }
+
+    ImuJsonlColumns columns;
+    ASSERT_EQ(ImuJsonlScanner(LOCATIONS).scan_file(path, columns), 0);
+    ASSERT_EQ(columns.frames(), 500u);
+
+    std::ifstream in(path);
+    std::string text;
+    for (size_t f = 0; std::getline(in, text); f++) {
+        nlohmann::json entry = nlohmann::json::parse(text);
+        uint8_t valid = 0;
+        for (const auto& sensor : entry["sensors"]) {
+            size_t c = std::find(LOCATIONS.begin(), LOCATIONS.end(), sensor["location"]) - LOCATIONS.begin();
+            valid |= static_cast<uint8_t>(1u << c);
+            ASSERT_EQ(columns.roll[c][f], sensor["euler"]["roll"].get<float>());
+            ASSERT_EQ(columns.heading[c][f], sensor["euler"]["heading"].get<float>());
+            ASSERT_EQ(columns.pitch[c][f], sensor["euler"]["pitch"].get<float>());
+        }
+        EXPECT_EQ(columns.valid_mask[f], valid);
+    }
+    EXPECT_EQ(columns.timestamp_ns[499] - columns.timestamp_ns[0], 49900000000LL);
+    std::remove(path.c_str());
+}
+
+#endif  // EXO_HAVE_IMU_REPLAY_JSON
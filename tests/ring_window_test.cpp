@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+#include <deque>
+#include <vector>
+#include "ring_window.h"
+
+TEST(RingWindowTest, LastFramesAreContiguousWhereverTheRingWrapped) {
+    RingWindow<float, 6, 30> ring;
+    std::deque<std::vector<float>> expected;
+
+    for (int f = 0; f < 200; ++f) {
+        float frame[6];
+        for (int c = 0; c < 6; ++c) frame[c] = f * 10.0f + c;
+        ring.push(frame);
+        expected.emplace_back(frame, frame + 6);
+        if (expected.size() > 30) expected.pop_front();
+
+        ASSERT_EQ(ring.size(), expected.size());
+        EXPECT_EQ(ring.full(), f >= 29);
+        EXPECT_EQ(ring.back()[5], frame[5]);
+        for (size_t n = 1; n <= ring.size(); ++n) {
+            RingWindow<float, 6, 30>::View view = ring.last(n);
+            ASSERT_EQ(view.frames(), n);
+            for (size_t t = 0; t < n; ++t) {
+                const std::vector<float>& row = expected[expected.size() - n + t];
+                // One flat [n][6] array, indexed without any wrap
+                for (size_t c = 0; c < 6; ++c) ASSERT_EQ(view.data()[t * 6 + c], row[c]) << f << " " << n << " " << t;
+                EXPECT_EQ(view(t, 2), row[2]);
+                EXPECT_EQ(view[t][4], row[4]);
+            }
+        }
+    }
+}
+
+TEST(RingWindowTest, EmptyViewUntilEnoughFrames) {
+    RingWindow<int, 2, 4> ring;
+    EXPECT_TRUE(ring.empty());
+    EXPECT_EQ(ring.back(), nullptr);
+    EXPECT_TRUE(ring.last(1).empty());
+
+    int frame[2] = {1, 2};
+    ring.push(frame);
+    EXPECT_EQ(ring.last(1).frames(), 1u);
+    EXPECT_TRUE(ring.last(2).empty());
+    EXPECT_TRUE(ring.last(5).empty());  // more than it can ever hold
+
+    ring.clear();
+    EXPECT_TRUE(ring.empty());
+    EXPECT_TRUE(ring.last(1).empty());
+}
+
+TEST(RingWindowTest, SingleFrameCapacity) {
+    RingWindow<double, 3, 1> ring;
+    for (int f = 0; f < 5; ++f) {
+        double frame[3] = {double(f), f + 0.5, f + 0.25};
+        ring.push(frame);
+        ASSERT_EQ(ring.last(1)(0, 1), f + 0.5);
+        EXPECT_EQ(ring.pushed(), static_cast<size_t>(f + 1));
+    }
+}
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include "exolog.h"
+#include "sensor_dataset.h"
+
+static const std::vector<std::string> LOCATIONS = {"Left Hip", "Left Knee", "Left Ankle",
+                                                   "Right Ankle", "Right Knee", "Right Hip"};
+
+static float roll_at(size_t frame, size_t channel) {
+    return frame * 0.25f - channel * 10.0f;
+}
+
+TEST(SensorDatasetTest, WindowsLookIntoTheColumns) {
+    SensorDataset dataset;
+    dataset.reset(LOCATIONS, {"roll"}, 100);
+    for (size_t c = 0; c < LOCATIONS.size(); c++) {
+        for (size_t t = 0; t < 100; t++) dataset.column(0, c)[t] = roll_at(t, c);
+    }
+    for (size_t t = 0; t < 100; t++) dataset.timestamp_ns()[t] = t * 10000000LL;
+
+    SensorWindow window = dataset.window(40, 30);
+    ASSERT_EQ(window.frames(), 30u);
+    ASSERT_EQ(window.channels(), 6u);
+    EXPECT_EQ(window(0, 0), roll_at(40, 0));
+    EXPECT_EQ(window(29, 5), roll_at(69, 5));
+    EXPECT_EQ(window.channel(3), dataset.column(0, 3) + 40);  // no copy
+    EXPECT_EQ(window.timestamp_ns(1), 410000000LL);
+
+    float rows[30 * 6];
+    window.copy_to(rows);
+    for (size_t t = 0; t < 30; t++) {
+        for (size_t c = 0; c < 6; c++) ASSERT_EQ(rows[t * 6 + c], roll_at(40 + t, c));
+    }
+
+    EXPECT_EQ(dataset.window(70, 30).frames(), 30u);
+    EXPECT_TRUE(dataset.window(71, 30).empty());
+    EXPECT_TRUE(dataset.window(0, 30, 1).empty());  // only one quantity
+    EXPECT_EQ(dataset.windows(30), 71u);
+    EXPECT_EQ(dataset.windows(30, 10), 8u);
+    EXPECT_EQ(dataset.windows(101), 0u);
+    EXPECT_EQ(dataset.quantity("roll"), 0);
+    EXPECT_EQ(dataset.quantity("pitch"), -1);
+}
+
+TEST(SensorDatasetTest, LoadsJsonLines) {
+    std::string path = ::testing::TempDir() + "dataset.json";
+    {
+        std::ofstream out(path);
+        for (size_t t = 0; t < 40; t++) {
+            out << "{\"sensors\": [";
+            for (size_t c = LOCATIONS.size(); c-- > 0;) {  // recorded in reverse order
+                out << "{\"euler\": {\"heading\": " << c << ", \"roll\": " << roll_at(t, c) << ", \"pitch\": 1.5}, "
+                    << "\"location\": \"" << LOCATIONS[c] << "\"}" << (c ? ", " : "");
+            }
+            out << "], \"timestamp\": \"2025-05-10 14:03:" << 10 + t / 10 << "." << t % 10 << "00\"}\n";
+        }
+    }
+
+    SensorDataset dataset;
+    ASSERT_EQ(dataset.load_jsonl(path, LOCATIONS, IMU_JSON_ROLL | IMU_JSON_PITCH), 0);
+    ASSERT_EQ(dataset.frames(), 40u);
+    EXPECT_EQ(dataset.quantities(), (std::vector<std::string>{"roll", "pitch"}));
+    EXPECT_EQ(dataset.timestamp_ns()[39] - dataset.timestamp_ns()[0], 3900000000LL);
+    EXPECT_EQ(dataset.valid_mask()[7], 0x3f);
+    EXPECT_EQ(dataset.window(5, 30, 0)(2, 4), roll_at(7, 4));
+    EXPECT_EQ(dataset.window(5, 30, 1)(2, 4), 1.5f);
+
+    SensorDataset by_extension;
+    ASSERT_EQ(by_extension.load(path, LOCATIONS), 0);
+    EXPECT_EQ(by_extension.quantities(), std::vector<std::string>{"roll"});
+    EXPECT_EQ(std::memcmp(by_extension.column(0, 0), dataset.column(0, 0), 40 * 6 * sizeof(float)), 0);
+
+    EXPECT_EQ(dataset.load_jsonl(::testing::TempDir() + "missing.json", LOCATIONS), -1);
+    std::remove(path.c_str());
+}
+
+TEST(SensorDatasetTest, LoadsExologScaled) {
+    ExologSchema schema;
+    schema.period_ns = 10000000;
+    schema.locations = LOCATIONS;
+    schema.append("timestamp_ns", ExologType::I64, 1, 1.0, "ns");
+    schema.append("roll", ExologType::I16, 6, 1.0 / 16.0, "deg");
+    schema.append("valid_mask", ExologType::U8, 1);
+
+    std::string path = ::testing::TempDir() + "dataset.exolog";
+    {
+        ExologWriter writer;
+        ASSERT_EQ(writer.open(path, schema), 0);
+        std::vector<uint8_t> record(schema.record_size);
+        for (size_t t = 0; t < 50; t++) {
+            int64_t ns = 5000000000LL + t * 10000000LL;
+            std::memcpy(&record[schema.find("timestamp_ns")->offset], &ns, sizeof(ns));
+            for (size_t c = 0; c < 6; c++) {
+                int16_t raw = static_cast<int16_t>(roll_at(t, c) * 16.0f);
+                std::memcpy(&record[schema.find("roll")->offset + c * 2], &raw, sizeof(raw));
+            }
+            record[schema.find("valid_mask")->offset] = static_cast<uint8_t>(t % 2 ? 0x3f : 0x1f);
+            ASSERT_EQ(writer.write(record.data()), 0);
+        }
+    }
+
+    SensorDataset dataset;
+    ASSERT_EQ(dataset.load(path, {}, {"heading", "roll"}), 0);  // no heading in this file
+    ASSERT_EQ(dataset.frames(), 50u);
+    EXPECT_EQ(dataset.locations(), LOCATIONS);
+    EXPECT_EQ(dataset.quantities(), std::vector<std::string>{"roll"});
+    EXPECT_EQ(dataset.timestamp_ns()[3], 5030000000LL);
+    EXPECT_EQ(dataset.valid_mask()[4], 0x1f);
+    SensorWindow window = dataset.window(20, 30);
+    for (size_t t = 0; t < 30; t++) {
+        for (size_t c = 0; c < 6; c++) ASSERT_EQ(window(t, c), roll_at(20 + t, c));
+    }
+
+    EXPECT_EQ(dataset.load_exolog(path, {"pitch"}), -1);
+    std::remove(path.c_str());
+}
@@ -0,0 +1,202 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include "bno055_device.h"
+#include "rpi_tca9548a.h"
+#include "sensor_health.h"
+#include "sim_i2c_bus.h"
+
+static const u8 IMU_ADDR = BNO055_I2C_ADDR2;
+static const int64_t SWEEP_NS = 10000000;
+
+// Two sensors behind the mux on a virtual clock, swept like liveSensorData
+class SensorHealthTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        // Replay channels 1 and 2 never sit exactly on zero at a sweep
+        bus.set_replay(make_synthetic_replay(3, 100, SWEEP_NS));
+        bus.add_bno055(0, IMU_ADDR, 1);
+        bus.add_bno055(1, IMU_ADDR, 2);
+        ASSERT_EQ(tca.init(0x70, bus), 0);
+        tca.set_settle_time_us(0);
+
+        for (int ch = 0; ch < 2; ch++) {
+            sensors.emplace_back(bus, IMU_ADDR, &tca, ch);
+            u8 mode = BNO055_OPERATION_MODE_NDOF;
+            ASSERT_EQ(sensors.back().init(), BNO055_SUCCESS);
+            ASSERT_EQ(sensors.back().write_register(BNO055_PAGE_ZERO, BNO055_OPR_MODE_ADDR, &mode, 1),
+                      BNO055_SUCCESS);
+        }
+    }
+
+    ImuFrame sweep(SensorHealthMonitor& health) {
+        static const Bno055ReadPlan roll_plan = bno055_plan_read(BNO055_Q_EULER_ROLL);
+        ImuFrame frame{};
+        for (size_t i = 0; i < sensors.size(); i++) {
+            if (!health.usable(i)) continue;
+            Bno055Sample sample;
+            bool ok = sensors[i].read(roll_plan, &sample) == BNO055_SUCCESS;
+            if (!ok) tca.invalidate();
+            if (ok) {
+                frame.roll[i] = sample.euler[1];
+                frame.sample_ns[i] = bus.now_ns();
+                frame.valid_mask |= 1u << i;
+            }
+            health.report_read(i, ok, ok ? sample.euler[1] : 0, bus.now_ns());
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        health.step(frame, bus.now_ns());
+        auto took = std::chrono::steady_clock::now() - start;
+        EXPECT_LT(took, std::chrono::milliseconds(20)) << "step() must not wait out mode switches";
+
+        bus.advance_ns(SWEEP_NS);
+        return frame;
+    }
+
+    SimulatedI2CBus bus;
+    rpi_tca9548a tca;
+    std::vector<Bno055Device> sensors;
+};
+
+TEST_F(SensorHealthTest, DisconnectedSensorIsHeldAndRecovered) {
+    SensorHealthMonitor health(sensors);
+    ImuFrame frame;
+    for (int k = 0; k < 5; k++) frame = sweep(health);
+    ASSERT_EQ(frame.valid_mask, 0x03);
+    int16_t last_good = frame.roll[1];
+
+    bus.set_present(1, IMU_ADDR, false);
+    for (int k = 0; k < 5; k++) {
+        frame = sweep(health);
+        EXPECT_FALSE(frame.valid_mask & 0x02);
+        EXPECT_TRUE(frame.substituted_mask & 0x02);
+        EXPECT_EQ(frame.roll[1], last_good);
+        EXPECT_TRUE(frame.valid_mask & 0x01);  // the other sensor is unaffected
+    }
+    EXPECT_EQ(health.state(1), SensorState::FAILED);
+
+    // Back on the bus it powers up in CONFIG and has to sit out the 600 ms switch
+    bus.set_present(1, IMU_ADDR, true);
+    int sweeps = 0;
+    while (health.state(1) != SensorState::HEALTHY && sweeps < 200) {
+        frame = sweep(health);
+        sweeps++;
+    }
+    ASSERT_EQ(health.state(1), SensorState::HEALTHY);
+    EXPECT_GE(sweeps * SWEEP_NS, BNO055_MODE_SWITCHING_DELAY * 1000000LL);
+    EXPECT_EQ(health.recoveries(), 1u);
+
+    frame = sweep(health);
+    EXPECT_EQ(frame.valid_mask, 0x03);
+    EXPECT_EQ(frame.substituted_mask, 0);
+    EXPECT_EQ(sensors[1].operation_mode(), BNO055_OPERATION_MODE_NDOF);
+}
+
+TEST_F(SensorHealthTest, ResetSensorReadingZerosIsReinitialised) {
+    SensorHealthMonitor health(sensors);
+    for (int k = 0; k < 5; k++) sweep(health);
+
+    // Brown-out: still answers, but back in CONFIG mode with zero output
+    u8 reset = BNO055_SYS_RST_MSK;
+    ASSERT_EQ(sensors[0].write_register(BNO055_PAGE_ZERO, BNO055_SYS_TRIGGER_ADDR, &reset, 1),
+              BNO055_SUCCESS);
+
+    ImuFrame frame = sweep(health);
+    EXPECT_EQ(frame.roll[0], 0);  // a single zero is believed
+    frame = sweep(health);
+    EXPECT_TRUE(frame.substituted_mask & 0x01);
+    EXPECT_NE(frame.roll[0], 0);
+
+    int sweeps = 0;
+    while (health.state(0) == SensorState::HEALTHY && sweeps < 20) {
+        sweep(health);
+        sweeps++;
+    }
+    EXPECT_NE(health.state(0), SensorState::HEALTHY);
+
+    while (health.state(0) != SensorState::HEALTHY && sweeps < 200) {
+        sweep(health);
+        sweeps++;
+    }
+    EXPECT_EQ(health.state(0), SensorState::HEALTHY);
+    EXPECT_EQ(sweep(health).valid_mask, 0x03);
+}
+
+TEST_F(SensorHealthTest, LevelSensorKeepsItsZeros) {
+    // Sensor 0 comes to lie level, exactly zero roll, still in the fusion mode
+    ImuReplay replay = make_synthetic_replay(3, 100, SWEEP_NS);
+    for (size_t f = 10; f < replay.frames(); f++) replay.euler[f * replay.channels + 1].r = 0;
+    bus.set_replay(replay);
+
+    SensorHealthMonitor health(sensors);
+    ImuFrame frame;
+    for (int k = 0; k < 10; k++) frame = sweep(health);
+    ASSERT_NE(frame.roll[0], 0);
+
+    int substituted = 0;
+    for (int k = 0; k < 85; k++) {
+        frame = sweep(health);
+        if (frame.substituted_mask & 0x01) substituted++;
+    }
+    // Only the run before the first OPR_MODE check is held
+    EXPECT_LT(substituted, SensorHealthConfig().zero_reads_before_check);
+    EXPECT_EQ(health.state(0), SensorState::HEALTHY);
+    EXPECT_EQ(frame.substituted_mask, 0u);
+    EXPECT_EQ(frame.roll[0], 0);
+    EXPECT_EQ(health.reinit_attempts(), 0u);
+}
+
+TEST_F(SensorHealthTest, StartupFailureIsRetriedInTheBackground) {
+    SensorHealthMonitor health(sensors);
+    health.mark_failed(1, bus.now_ns());
+    EXPECT_FALSE(health.usable(1));
+
+    int sweeps = 0;
+    while (health.state(1) != SensorState::HEALTHY && sweeps < 200) {
+        sweep(health);
+        sweeps++;
+    }
+    EXPECT_EQ(health.state(1), SensorState::HEALTHY);
+    EXPECT_EQ(health.reinit_attempts(), 1u);
+}
+
+TEST_F(SensorHealthTest, RecoveryIsolatesAndRestoresCalibration) {
+    SensorHealthMonitor health(sensors);
+    std::vector<size_t> isolated, restored;
+    health.set_isolate([&](size_t i) { isolated.push_back(i); });
+    health.set_restore_calibration([&](size_t i) {
+        restored.push_back(i);
+        EXPECT_EQ(sensors[i].operation_mode(), BNO055_OPERATION_MODE_CONFIG);
+    });
+    health.mark_failed(1, bus.now_ns());
+
+    int sweeps = 0;
+    while (health.state(1) != SensorState::HEALTHY && sweeps < 200) {
+        sweep(health);
+        sweeps++;
+    }
+    ASSERT_EQ(health.state(1), SensorState::HEALTHY);
+
+    // init + CONFIG write, profile + fusion mode write, mode check
+    EXPECT_EQ(isolated, std::vector<size_t>({1, 1, 1}));
+    EXPECT_EQ(restored, std::vector<size_t>({1}));
+}
+
+TEST_F(SensorHealthTest, ExtrapolatesThenHolds) {
+    SensorHealthConfig config;
+    config.policy = SubstitutePolicy::EXTRAPOLATE;
+    config.max_extrapolation_ns = 2 * SWEEP_NS;
+    SensorHealthMonitor health(sensors, config);
+
+    ImuFrame prev = sweep(health);
+    ImuFrame last = sweep(health);
+    int slope = last.roll[1] - prev.roll[1];
+
+    bus.set_present(1, IMU_ADDR, false);
+    ImuFrame a = sweep(health);
+    ImuFrame b = sweep(health);
+    ImuFrame c = sweep(health);
+    EXPECT_NEAR(a.roll[1], last.roll[1] + slope, 1);
+    EXPECT_NEAR(b.roll[1], last.roll[1] + 2 * slope, 1);
+    EXPECT_EQ(c.roll[1], b.roll[1]);
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#ifdef EXO_HAVE_IMU_REPLAY_JSON
+
+#include "getSensorData.h"
+
+static const char* LOCATIONS[] = {"Left Hip", "Left Knee", "Left Ankle", "Right Ankle", "Right Knee", "Right Hip"};
+
+static float roll_at(int line, int sensor) {
+    return line * 0.5f - sensor * 1.25f;
+}
+
+static std::string log_line(int line, int sensors) {
+    std::ostringstream out;
+    out << "{\"sensors\": [";
+    for (int s = 0; s < sensors; s++) {
+        out << (s ? ", " : "") << "{\"euler\": {\"heading\": 1.0, \"pitch\": 2.0, \"roll\": " << roll_at(line, s)
+            << "}, \"location\": \"" << LOCATIONS[s] << "\"}";
+    }
+    out << "], \"timestamp\": \"2025-05-10 14:03:21.120\"}";
+    return out.str();
+}
+
+// Every line has six sensors except every 17th, which has five
+static std::string write_log(const std::string& name, int lines) {
+    std::string path = ::testing::TempDir() + name;
+    std::remove((path + ".idx").c_str());
+    std::ofstream out(path);
+    for (int i = 0; i < lines; i++) out << log_line(i, i % 17 == 16 ? 5 : 6) << "\n";
+    return path;
+}
+
+TEST(SensorLogReaderTest, WindowsMatchLineByLineParsing) {
+    std::string path = write_log("windows.json", 200);
+    SensorLogReader reader;
+    ASSERT_EQ(reader.open(path), 0);
+    EXPECT_EQ(reader.lines(), 200u);
+
+    auto window = reader.roll_window(10, 30);
+    ASSERT_EQ(window.size(), 28u);  // lines 16 and 33 have five sensors
+    EXPECT_EQ(window[0].size(), 6u);
+    EXPECT_FLOAT_EQ(window[0][3], roll_at(10, 3));
+    EXPECT_FLOAT_EQ(window[6][0], roll_at(17, 0));  // after a skipped line
+    EXPECT_FLOAT_EQ(window[27][5], roll_at(39, 5));
+
+    // Past the end: whatever is left
+    EXPECT_EQ(reader.roll_window(195, 30).size(), 5u);
+    EXPECT_TRUE(reader.roll_window(500, 30).empty());
+
+    size_t length = 0;
+    const char* text = reader.line(199, &length);
+    EXPECT_EQ(std::string(text, length), log_line(199, 6));
+    std::remove(path.c_str());
+    std::remove((path + ".idx").c_str());
+}
+
+TEST(SensorLogReaderTest, SidecarIndexIsReusedUntilTheLogChanges) {
+    std::string path = write_log("sidecar.json", 50);
+    {
+        SensorLogReader reader;
+        ASSERT_EQ(reader.open(path), 0);
+        EXPECT_FALSE(reader.index_loaded());
+    }
+    {
+        SensorLogReader reader;
+        ASSERT_EQ(reader.open(path), 0);
+        EXPECT_TRUE(reader.index_loaded());
+        EXPECT_EQ(reader.lines(), 50u);
+    }
+
+    std::ofstream(path, std::ios::app) << log_line(50, 6) << "\n";
+    {
+        SensorLogReader reader;
+        ASSERT_EQ(reader.open(path), 0);
+        EXPECT_FALSE(reader.index_loaded());  // stale, rebuilt
+        EXPECT_EQ(reader.lines(), 51u);
+        EXPECT_FLOAT_EQ(reader.roll_window(50, 1).at(0)[2], roll_at(50, 2));
+    }
+
+    // A garbled sidecar is ignored
+    std::ofstream(path + ".idx", std::ios::trunc) << "not an index";
+    SensorLogReader reader;
+    ASSERT_EQ(reader.open(path), 0);
+    EXPECT_FALSE(reader.index_loaded());
+    EXPECT_EQ(reader.lines(), 51u);
+    std::remove(path.c_str());
+    std::remove((path + ".idx").c_str());
+}
+
+TEST(SensorLogReaderTest, GetSensorDataKeepsItsOutput) {
+    std::string path = write_log("get_sensor_data.json", 100);
+    for (int start = 0; start < 70; start += 7) {
+        auto raw = get_sensor_data(path, start, 30);
+        size_t expected = 0;
+        for (int line = start; line < start + 30; line++) expected += line % 17 == 16 ? 0 : 1;
+        ASSERT_EQ(raw.size(), expected);
+        EXPECT_FLOAT_EQ(raw[0][1], roll_at(start, 1));
+    }
+
+    // A log that is still growing: windows past the old end see the new lines
+    EXPECT_EQ(get_sensor_data(path, 90, 30).size(), 10u);
+    {
+        std::ofstream out(path, std::ios::app);
+        for (int i = 100; i < 120; i++) out << log_line(i, 6) << "\n";
+    }
+    EXPECT_EQ(get_sensor_data(path, 90, 30).size(), 30u);
+    EXPECT_TRUE(get_sensor_data(::testing::TempDir() + "missing.json", 0, 30).empty());
+    std::remove(path.c_str());
+    std::remove((path + ".idx").c_str());
+}
+
+#endif  // EXO_HAVE_IMU_REPLAY_JSON
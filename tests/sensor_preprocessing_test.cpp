@@ -0,0 +1,199 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <numeric>
+#include <random>
+#include "sensor_dataset.h"
+#include "sensor_preprocessing.h"
+#include "simd_lanes.h"
+
+static const std::vector<std::string> LOCATIONS = {"Left Hip", "Left Knee", "Left Ankle",
+                                                   "Right Ankle", "Right Knee", "Right Hip"};
+
+// The per-channel scalar loops process_sensor_data() ran before the SIMD kernels
+static void reference_channel(std::vector<float>& signal, int section_size, float diff_max) {
+    std::vector<float> unwrapped{signal[0]};
+    float total = 0.0f;
+    total += signal[0];
+    for (size_t i = 1; i < signal.size(); ++i) {
+        int start = std::max(static_cast<int>(i) - section_size, 0);
+        float diff = signal[i] - total / (i - start);
+        unwrapped.push_back(diff > diff_max ? signal[i] - 360.0f : diff < -diff_max ? signal[i] + 360.0f : signal[i]);
+        if (static_cast<int>(i) >= section_size) total -= unwrapped[i - section_size];
+        total += unwrapped[i];
+    }
+    std::deque<float> window;
+    total = 0.0f;
+    for (size_t i = 0; i < signal.size(); ++i) {
+        if (window.size() >= static_cast<size_t>(section_size)) {
+            total -= window.front();
+            window.pop_front();
+        }
+        window.push_back(unwrapped[i]);
+        total += unwrapped[i];
+        signal[i] = unwrapped[i] - total / static_cast<float>(window.size());
+    }
+}
+
+static std::vector<std::vector<float>> reference(const std::vector<std::vector<float>>& frames, int section_size,
+                                                 float diff_max) {
+    std::vector<std::vector<float>> out = frames;
+    for (size_t c = 0; c < frames[0].size(); c++) {
+        std::vector<float> signal(frames.size());
+        for (size_t t = 0; t < frames.size(); t++) signal[t] = frames[t][c];
+        reference_channel(signal, section_size, diff_max);
+        for (size_t t = 0; t < frames.size(); t++) out[t][c] = signal[t];
+    }
+    return out;
+}
+
+// Frames [t][6] pushed one at a time
+static std::vector<std::vector<float>> stream(const std::vector<std::vector<float>>& frames, int section_size,
+                                              float diff_max) {
+    StreamingPreprocessor preprocessor(6, section_size, diff_max);
+    std::vector<std::vector<float>> out(frames.size(), std::vector<float>(6));
+    for (size_t t = 0; t < frames.size(); t++) preprocessor.push(frames[t].data(), out[t].data());
+    return out;
+}
+
+static void expect_identical(const std::vector<std::vector<float>>& frames, int section_size = 100,
+                             float diff_max = 200.0f) {
+    std::vector<std::vector<float>> batch = frames;
+    process_sensor_data(batch, section_size, diff_max);
+    std::vector<std::vector<float>> streamed = stream(frames, section_size, diff_max);
+    std::vector<std::vector<float>> scalar = reference(frames, section_size, diff_max);
+    ASSERT_EQ(streamed.size(), batch.size());
+    for (size_t t = 0; t < batch.size(); t++) {
+        ASSERT_EQ(std::memcmp(streamed[t].data(), batch[t].data(), 6 * sizeof(float)), 0)
+            << "frame " << t << " section " << section_size;
+        ASSERT_EQ(std::memcmp(scalar[t].data(), batch[t].data(), 6 * sizeof(float)), 0)
+            << "frame " << t << " section " << section_size << " (" << simd::ISA << ")";
+    }
+}
+
+static std::vector<std::vector<float>> load_roll(const std::string& path) {
+    SensorDataset dataset;
+    std::vector<std::vector<float>> frames;
+    if (dataset.load(path, LOCATIONS) != 0) return frames;
+    frames.assign(dataset.frames(), std::vector<float>(6));
+    for (size_t t = 0; t < dataset.frames(); t++) {
+        for (size_t c = 0; c < 6; c++) frames[t][c] = dataset.column(0, c)[t];
+    }
+    return frames;
+}
+
+// Rolls near +-180 degrees that wrap now and then
+static std::vector<std::vector<float>> wrapping_frames(size_t count) {
+    std::mt19937 rng(5);
+    std::normal_distribution<float> noise(0.0f, 0.7f);
+    std::vector<std::vector<float>> frames(count, std::vector<float>(6));
+    for (size_t t = 0; t < count; t++) {
+        for (size_t c = 0; c < 6; c++) {
+            float angle = 170.0f + 25.0f * std::sin(t * 0.07f + c) + noise(rng);
+            frames[t][c] = angle > 180.0f ? angle - 360.0f : angle;
+        }
+    }
+    return frames;
+}
+
+TEST(SensorPreprocessingTest, StreamingMatchesBatchOnRecordedLogs) {
+    for (const char* log : {"/MAY_10_FULL_SUIT_WORKING/control/joint_data.json",
+                            "/MAY_10_FULL_SUIT_WORKING/sensors/imu_data.json"}) {
+        std::vector<std::vector<float>> frames = load_roll(std::string(EXO_SOURCE_DIR) + log);
+        ASSERT_GT(frames.size(), 100u) << log;
+        expect_identical(frames);
+        expect_identical(frames, 30);
+    }
+}
+
+TEST(SensorPreprocessingTest, StreamingMatchesBatchAcrossWraps) {
+    std::vector<std::vector<float>> frames = wrapping_frames(2000);
+    for (int section_size : {1, 2, 7, 100, 5000}) expect_identical(frames, section_size);
+    expect_identical(frames, 100, 90.0f);
+
+    // The wraps really are undone: consecutive outputs never jump by a turn
+    std::vector<std::vector<float>> out = stream(frames, 100, 200.0f);
+    for (size_t t = 1; t < out.size(); t++) {
+        for (size_t c = 0; c < 6; c++) ASSERT_LT(std::fabs(out[t][c] - out[t - 1][c]), 30.0f) << t;
+    }
+
+    // Starting over is the same as a new preprocessor
+    StreamingPreprocessor preprocessor(6);
+    float row[6];
+    for (const auto& frame : frames) preprocessor.push(frame.data(), row);
+    preprocessor.reset();
+    EXPECT_EQ(preprocessor.frames(), 0u);
+    preprocessor.push(frames[0].data(), row);
+    EXPECT_EQ(std::memcmp(row, out[0].data(), sizeof(row)), 0);
+}
+
+// The running sums only reorder the additions of the re-accumulated mean
+TEST(SensorPreprocessingTest, CloseToTheReaccumulatedMean) {
+    std::vector<std::vector<float>> frames = wrapping_frames(600);
+    const int section_size = 100;
+    std::vector<std::vector<float>> out = stream(frames, section_size, 200.0f);
+
+    for (size_t c = 0; c < 6; c++) {
+        std::vector<float> unwrapped{frames[0][c]};
+        for (size_t i = 1; i < frames.size(); i++) {
+            size_t start = i > section_size ? i - section_size : 0;
+            float mean = std::accumulate(unwrapped.begin() + start, unwrapped.end(), 0.0f) / (i - start);
+            float diff = frames[i][c] - mean;
+            unwrapped.push_back(diff > 200.0f ? frames[i][c] - 360.0f
+                                : diff < -200.0f ? frames[i][c] + 360.0f : frames[i][c]);
+        }
+        for (size_t i = 0; i < frames.size(); i++) {
+            size_t start = i + 1 > section_size ? i + 1 - section_size : 0;
+            double mean = std::accumulate(unwrapped.begin() + start, unwrapped.begin() + i + 1, 0.0) / (i + 1 - start);
+            ASSERT_NEAR(out[i][c], unwrapped[i] - mean, 1e-3) << "frame " << i;
+        }
+    }
+}
+
+// Channel counts that leave padding lanes, or span several blocks of lanes
+TEST(SensorPreprocessingTest, AnyChannelCountMatchesTheScalarLoops) {
+    std::vector<std::vector<float>> wrapping = wrapping_frames(700);
+    for (size_t channels : {1, 3, 8, 11, 16}) {
+        std::vector<std::vector<float>> frames(wrapping.size(), std::vector<float>(channels));
+        std::vector<float> flat;
+        for (size_t t = 0; t < frames.size(); t++) {
+            for (size_t c = 0; c < channels; c++) frames[t][c] = wrapping[t][c % 6] + (c / 6) * 3.0f;
+            flat.insert(flat.end(), frames[t].begin(), frames[t].end());
+        }
+        std::vector<std::vector<float>> scalar = reference(frames, 50, 200.0f);
+
+        // A few frames at a time, as a control loop would
+        StreamingPreprocessor preprocessor(channels, 50);
+        for (size_t t = 0; t < frames.size(); t += 7) {
+            size_t n = std::min<size_t>(7, frames.size() - t);
+            preprocessor.push(&flat[t * channels], &flat[t * channels], n);
+        }
+        EXPECT_EQ(preprocessor.frames(), frames.size());
+        for (size_t t = 0; t < frames.size(); t++) {
+            ASSERT_EQ(std::memcmp(&flat[t * channels], scalar[t].data(), channels * sizeof(float)), 0)
+                << channels << " channels, frame " << t;
+        }
+    }
+}
+
+TEST(SensorPreprocessingTest, StandardizeMatchesTheScalarExpression) {
+    std::mt19937 rng(9);
+    std::uniform_real_distribution<float> angle(-180.0f, 180.0f);
+    for (size_t channels : {6, 8, 13}) {
+        std::vector<float> mean(channels), scale(channels), in(30 * channels), out(in.size());
+        for (size_t c = 0; c < channels; c++) {
+            mean[c] = angle(rng) / 50.0f;
+            scale[c] = 3.0f + std::fabs(angle(rng)) / 10.0f;
+        }
+        for (float& x : in) x = angle(rng);
+        standardize_frames(in.data(), out.data(), 30, channels, mean.data(), scale.data());
+        for (size_t i = 0; i < in.size(); i++) {
+            float expected = (in[i] - mean[i % channels]) / scale[i % channels];
+            ASSERT_EQ(std::memcmp(&out[i], &expected, sizeof(float)), 0) << channels << " channels, value " << i;
+        }
+        standardize_frames(in.data(), in.data(), 30, channels, mean.data(), scale.data());
+        EXPECT_EQ(in, out);
+    }
+}
@@ -0,0 +1,249 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <map>
+#include <thread>
+#include "sensor_rig.h"
+#include "sensor_topology.h"
+#include "sim_i2c_bus.h"
+
+static const u8 IMU_ADDR = BNO055_I2C_ADDR2;
+
+// One frame, sensor i holds roll (i + 1) * 5 degrees
+static ImuReplay constant_replay() {
+    ImuReplay replay;
+    replay.channels = IMU_CHANNELS;
+    replay.timestamp_ns.push_back(0);
+    for (size_t i = 0; i < IMU_CHANNELS; i++) {
+        bno055_euler_t e = {0, euler_deg_to_raw((i + 1) * 5.0), 0};
+        replay.euler.push_back(e);
+    }
+    return replay;
+}
+
+// Sensors wired into simulated buses as the topology says, replay channel = frame channel
+static void wire(const SensorTopology& topology, std::map<std::string, SimulatedI2CBus*>& buses) {
+    for (auto& b : buses) b.second->set_replay(constant_replay());
+    for (size_t ch = 0; ch < topology.size(); ch++) {
+        buses[topology[ch].bus]->add_bno055(topology[ch].channel, topology[ch].dev_addr, ch);
+    }
+}
+
+static SensorRig::BusFactory factory_for(std::map<std::string, SimulatedI2CBus*>& buses) {
+    return [&buses](const std::string& device) -> I2CBus* {
+        auto it = buses.find(device);
+        return it == buses.end() ? nullptr : it->second;
+    };
+}
+
+static SensorTopology split_topology() {
+    SensorTopology topology;
+    for (int i = 0; i < 6; i++) {
+        topology.push_back({i < 3 ? "simA" : "simB", 0x70, i % 3, IMU_ADDR});
+    }
+    return topology;
+}
+
+TEST(SensorTopologyTest, ParsesConfig) {
+    SensorTopology topology;
+    ASSERT_EQ(parse_topology("# bus mux channel address\n"
+                             "/dev/i2c-1 0x70 0 0x29\n"
+                             "\n"
+                             "/dev/i2c-3 - - 40   # straight on the bus\n"
+                             "/dev/i2c-1 0x70 2 0x29 3\n",
+                             topology),
+              0);
+    ASSERT_EQ(topology.size(), 3u);
+    EXPECT_EQ(topology[0].bus, "/dev/i2c-1");
+    EXPECT_EQ(topology[0].mux_addr, 0x70);
+    EXPECT_EQ(topology[0].channel, 0);
+    EXPECT_EQ(topology[0].dev_addr, 0x29);
+    EXPECT_EQ(topology[1].mux_addr, -1);
+    EXPECT_EQ(topology[1].dev_addr, 0x28);
+    EXPECT_EQ(topology[0].divisor, 1);
+    EXPECT_EQ(topology[2].divisor, 3);
+}
+
+TEST(SensorTopologyTest, RejectsMalformedLines) {
+    SensorTopology topology;
+    EXPECT_EQ(parse_topology("/dev/i2c-1 0x70 0\n", topology), -1);
+    EXPECT_EQ(parse_topology("/dev/i2c-1 0x70 8 0x29\n", topology), -1);
+    EXPECT_EQ(parse_topology("/dev/i2c-1 0x70 0 0x29 extra\n", topology), -1);
+    EXPECT_EQ(parse_topology("/dev/i2c-1 0x70 zero 0x29\n", topology), -1);
+    EXPECT_EQ(parse_topology("/dev/i2c-1 0x70 0 0x80\n", topology), -1);
+    EXPECT_EQ(parse_topology("/dev/i2c-1 0x70 0 0x29 0\n", topology), -1);
+}
+
+TEST(SensorTopologyTest, RejectsMoreSensorsThanFrameChannels) {
+    std::string text;
+    for (int i = 0; i < 7; i++) text += "/dev/i2c-1 0x70 " + std::to_string(i) + " 0x29\n";
+    SensorTopology topology;
+    EXPECT_EQ(parse_topology(text, topology), -1);
+}
+
+TEST(SensorTopologyTest, DefaultIsTheSuit) {
+    SensorTopology topology = default_topology();
+    ASSERT_EQ(topology.size(), IMU_CHANNELS);
+    for (size_t i = 0; i < topology.size(); i++) {
+        EXPECT_EQ(topology[i].bus, "/dev/i2c-1");
+        EXPECT_EQ(topology[i].channel, static_cast<int>(i));
+    }
+}
+
+TEST(SensorRigTest, MergesBusesIntoOneFrame) {
+    SimulatedI2CBus a, b;
+    std::map<std::string, SimulatedI2CBus*> buses = {{"simA", &a}, {"simB", &b}};
+    SensorTopology topology = split_topology();
+    wire(topology, buses);
+
+    SensorRig rig(topology, factory_for(buses));
+    EXPECT_EQ(rig.bus_count(), 2u);
+    ASSERT_EQ(rig.init(), 6);
+
+    for (int sweep = 0; sweep < 3; sweep++) {
+        ImuFrame frame{};
+        rig.sweep(frame);
+        EXPECT_EQ(frame.valid_mask, 0x3F);
+        for (size_t i = 0; i < IMU_CHANNELS; i++) {
+            EXPECT_EQ(frame.roll[i], euler_deg_to_raw((i + 1) * 5.0)) << "channel " << i;
+        }
+    }
+    EXPECT_GT(a.stats().transactions, 0u);
+    EXPECT_GT(b.stats().transactions, 0u);
+}
+
+TEST(SensorRigTest, MissingBusLeavesItsChannelsInvalid) {
+    SimulatedI2CBus a;
+    std::map<std::string, SimulatedI2CBus*> buses = {{"simA", &a}};
+    SensorTopology topology = split_topology();
+    a.set_replay(constant_replay());
+    for (size_t ch = 0; ch < 3; ch++) a.add_bno055(topology[ch].channel, IMU_ADDR, ch);
+
+    SensorRig rig(topology, factory_for(buses));
+    EXPECT_EQ(rig.init(), 3);
+
+    ImuFrame frame{};
+    rig.sweep(frame);
+    EXPECT_EQ(frame.valid_mask, 0x07);
+    EXPECT_EQ(frame.roll[2], euler_deg_to_raw(15.0));
+}
+
+TEST(SensorRigTest, RefusesMoreSensorsThanFrameChannels) {
+    SimulatedI2CBus a;
+    std::map<std::string, SimulatedI2CBus*> buses = {{"simA", &a}};
+    SensorTopology topology;
+    for (int i = 0; i < 7; i++) topology.push_back({"simA", 0x70, i, IMU_ADDR});
+    wire(topology, buses);
+
+    SensorRig rig(topology, factory_for(buses));
+    EXPECT_EQ(rig.init(), -1);
+    EXPECT_EQ(rig.sensor_count(), 0u);
+    EXPECT_EQ(a.stats().transactions, 0u);
+}
+
+TEST(SensorRigTest, StartupWaitsOutOneModeSwitchForAllSensors) {
+    SimulatedI2CBus bus;
+    std::map<std::string, SimulatedI2CBus*> buses = {{"sim", &bus}};
+    SensorTopology topology = default_topology();
+    for (auto& p : topology) p.bus = "sim";
+    wire(topology, buses);
+
+    // One sensor is still booting when the probes start
+    bus.set_present(4, IMU_ADDR, false);
+    std::thread boot([&bus] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        bus.set_present(4, IMU_ADDR, true);
+    });
+
+    SensorRig rig(topology, factory_for(buses));
+    auto start = std::chrono::steady_clock::now();
+    int ready = rig.init();
+    auto took = std::chrono::steady_clock::now() - start;
+    boot.join();
+
+    EXPECT_EQ(ready, 6);
+    EXPECT_GE(took, std::chrono::milliseconds(BNO055_MODE_SWITCHING_DELAY));
+    EXPECT_LT(took, std::chrono::milliseconds(2 * BNO055_MODE_SWITCHING_DELAY));
+
+    ImuFrame frame{};
+    rig.sweep(frame);
+    EXPECT_EQ(frame.valid_mask, 0x3F);
+}
+
+TEST(SensorRigTest, SlowSensorsCarryTheirLastSample) {
+    SimulatedI2CBus bus;
+    std::map<std::string, SimulatedI2CBus*> buses = {{"sim", &bus}};
+    SensorTopology topology = default_topology();
+    for (auto& p : topology) p.bus = "sim";
+    topology[2].divisor = 3;
+    topology[3].divisor = 3;
+    wire(topology, buses);
+
+    SensorRig rig(topology, factory_for(buses));
+    ASSERT_EQ(rig.init(), 6);
+
+    // The first sweep reads everything, after that ankles come every third sweep
+    ImuFrame frame{};
+    frame.timestamp_ns = monotonic_ns();
+    bus.reset_stats();
+    rig.sweep(frame);
+    EXPECT_EQ(frame.fresh_mask, 0x3F);
+    uint64_t all_due = bus.stats().transactions;
+
+    int fresh[IMU_CHANNELS] = {};
+    for (int sweep = 0; sweep < 9; sweep++) {
+        bus.reset_stats();
+        frame.timestamp_ns = monotonic_ns();
+        rig.sweep(frame);
+        EXPECT_EQ(frame.valid_mask, 0x3F);
+        EXPECT_NE(frame.fresh_mask & 0x0C, 0x0C) << "ankles are staggered, never both in one sweep";
+        EXPECT_LT(bus.stats().transactions, all_due);
+
+        for (size_t i = 0; i < IMU_CHANNELS; i++) {
+            EXPECT_EQ(frame.roll[i], euler_deg_to_raw((i + 1) * 5.0));
+            if (frame.fresh_mask & (1u << i)) {
+                fresh[i]++;
+                EXPECT_EQ(sample_age_ns(frame, i), 0);
+            } else {
+                EXPECT_GT(sample_age_ns(frame, i), 0);
+            }
+        }
+    }
+    EXPECT_EQ(fresh[0], 9);
+    EXPECT_EQ(fresh[1], 9);
+    EXPECT_EQ(fresh[2], 3);
+    EXPECT_EQ(fresh[3], 3);
+    EXPECT_EQ(fresh[4], 9);
+}
+
+TEST(SensorRigTest, TwoBusesSweepFasterThanOne) {
+    const SimBusTiming timing = SimBusTiming::at_clock(100000);
+    const int SWEEPS = 20;
+
+    auto time_sweeps = [&](SensorRig& rig) {
+        ImuFrame frame{};
+        auto start = std::chrono::steady_clock::now();
+        for (int k = 0; k < SWEEPS; k++) rig.sweep(frame);
+        EXPECT_EQ(frame.valid_mask, 0x3F);
+        return std::chrono::steady_clock::now() - start;
+    };
+
+    SimulatedI2CBus single(timing, true);
+    std::map<std::string, SimulatedI2CBus*> one = {{"sim", &single}};
+    SensorTopology serial = default_topology();
+    for (auto& p : serial) p.bus = "sim";
+    wire(serial, one);
+    SensorRig serial_rig(serial, factory_for(one));
+    ASSERT_EQ(serial_rig.init(), 6);
+
+    SimulatedI2CBus a(timing, true), b(timing, true);
+    std::map<std::string, SimulatedI2CBus*> two = {{"simA", &a}, {"simB", &b}};
+    SensorTopology split = split_topology();
+    wire(split, two);
+    SensorRig split_rig(split, factory_for(two));
+    ASSERT_EQ(split_rig.init(), 6);
+
+    auto serial_time = time_sweeps(serial_rig);
+    auto split_time = time_sweeps(split_rig);
+    EXPECT_LT(split_time.count(), serial_time.count() * 0.8)
+        << "serial " << serial_time.count() / 1e6 << " ms, split " << split_time.count() / 1e6 << " ms";
+}
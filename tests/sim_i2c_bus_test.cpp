@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+#include "bno055_device.h"
+#include "rpi_tca9548a.h"
+#include "sim_i2c_bus.h"
+
+static const u8 IMU_ADDR = BNO055_I2C_ADDR2;
+
+// Two frames 100 ms apart, roll = 10 * (channel + 1) * (frame + 1) degrees
+static ImuReplay two_frame_replay() {
+    ImuReplay replay;
+    replay.channels = 2;
+    replay.timestamp_ns = {0, 100000000};
+    for (int f = 0; f < 2; f++) {
+        for (int c = 0; c < 2; c++) {
+            bno055_euler_t e;
+            e.h = euler_deg_to_raw(90.0);
+            e.r = euler_deg_to_raw(10.0 * (c + 1) * (f + 1));
+            e.p = euler_deg_to_raw(-5.0);
+            replay.euler.push_back(e);
+        }
+    }
+    return replay;
+}
+
+static void enter_ndof(Bno055Device& imu) {
+    // Direct register write, set_operation_mode() would sleep for the real delays
+    u8 mode = BNO055_OPERATION_MODE_NDOF;
+    ASSERT_EQ(imu.write_register(BNO055_PAGE_ZERO, BNO055_OPR_MODE_ADDR, &mode, 1), BNO055_SUCCESS);
+}
+
+TEST(SimI2CBusTest, MuxControlRegisterReadsBack) {
+    SimulatedI2CBus bus;
+    rpi_tca9548a tca;
+    ASSERT_EQ(tca.init(0x70, bus), 0);
+    tca.set_settle_time_us(0);
+
+    EXPECT_EQ(tca.set_channel(3), 0);
+    EXPECT_EQ(bus.mux_mask(), 1 << 3);
+    EXPECT_EQ(tca.active_channel(), 3);
+
+    // Already selected, no second control register write
+    uint64_t writes = bus.stats().mux_writes;
+    EXPECT_EQ(tca.set_channel(3), 0);
+    EXPECT_EQ(bus.stats().mux_writes, writes);
+}
+
+TEST(SimI2CBusTest, SensorOnlyAnswersOnItsChannel) {
+    SimulatedI2CBus bus;
+    bus.add_bno055(2, IMU_ADDR, 0);
+
+    u8 id = 0;
+    EXPECT_EQ(bus.read(IMU_ADDR, BNO055_CHIP_ID_ADDR, &id, 1), BNO055_ERROR);
+    ASSERT_EQ(bus.send_byte(0x70, 1 << 2), BNO055_SUCCESS);
+    EXPECT_EQ(bus.read(IMU_ADDR, BNO055_CHIP_ID_ADDR, &id, 1), BNO055_SUCCESS);
+    EXPECT_EQ(id, 0xA0);
+    EXPECT_EQ(bus.stats().nacks, 1u);
+}
+
+TEST(SimI2CBusTest, SameAddressOnTwoOpenChannelsCollides) {
+    SimulatedI2CBus bus;
+    bus.add_bno055(0, IMU_ADDR, 0);
+    bus.add_bno055(1, IMU_ADDR, 1);
+    ASSERT_EQ(bus.send_byte(0x70, 0x03), BNO055_SUCCESS);
+
+    u8 id = 0;
+    EXPECT_EQ(bus.read(IMU_ADDR, BNO055_CHIP_ID_ADDR, &id, 1), BNO055_ERROR);
+}
+
+TEST(SimI2CBusTest, DeviceInitAndPageSwitching) {
+    SimulatedI2CBus bus;
+    bus.add_bno055(0, IMU_ADDR, 0);
+    rpi_tca9548a tca;
+    ASSERT_EQ(tca.init(0x70, bus), 0);
+    tca.set_settle_time_us(0);
+
+    Bno055Device imu(bus, IMU_ADDR, &tca, 0);
+    ASSERT_EQ(imu.init(), BNO055_SUCCESS);
+    EXPECT_EQ(imu.chip_id(), 0xA0);
+    EXPECT_EQ(imu.operation_mode(), BNO055_OPERATION_MODE_CONFIG);
+
+    u8 page = 0xFF;
+    ASSERT_EQ(imu.read_register(BNO055_PAGE_ONE, BNO055_PAGE_ID_ADDR, &page, 1), BNO055_SUCCESS);
+    EXPECT_EQ(page, BNO055_PAGE_ONE);
+    EXPECT_EQ(imu.page_id(), BNO055_PAGE_ONE);
+
+    u8 id = 0;
+    ASSERT_EQ(imu.read_register(BNO055_PAGE_ZERO, BNO055_CHIP_ID_ADDR, &id, 1), BNO055_SUCCESS);
+    EXPECT_EQ(id, 0xA0);
+}
+
+TEST(SimI2CBusTest, ConfigRegistersAreWriteProtectedOutsideConfigMode) {
+    SimulatedI2CBus bus;
+    bus.add_bno055(-1, IMU_ADDR, 0);
+    Bno055Device imu(bus, IMU_ADDR);
+    ASSERT_EQ(imu.init(), BNO055_SUCCESS);
+    enter_ndof(imu);
+
+    u8 unit = 0x84;
+    ASSERT_EQ(imu.write_register(BNO055_PAGE_ZERO, BNO055_UNIT_SEL_ADDR, &unit, 1), BNO055_SUCCESS);
+    ASSERT_EQ(imu.read_register(BNO055_PAGE_ZERO, BNO055_UNIT_SEL_ADDR, &unit, 1), BNO055_SUCCESS);
+    EXPECT_EQ(unit, 0x80);
+}
+
+TEST(SimI2CBusTest, EulerUnitIsSetThroughConfigMode) {
+    SimulatedI2CBus bus;
+    bus.add_bno055(-1, IMU_ADDR, 0);
+    Bno055Device imu(bus, IMU_ADDR);
+    ASSERT_EQ(imu.init(), BNO055_SUCCESS);
+    enter_ndof(imu);
+
+    ASSERT_EQ(imu.set_euler_unit(BNO055_EULER_UNIT_RAD), BNO055_SUCCESS);
+    EXPECT_EQ(imu.euler_unit(), BNO055_EULER_UNIT_RAD);
+    EXPECT_EQ(imu.operation_mode(), BNO055_OPERATION_MODE_NDOF);
+
+    u8 unit = 0;
+    ASSERT_EQ(imu.read_register(BNO055_PAGE_ZERO, BNO055_UNIT_SEL_ADDR, &unit, 1), BNO055_SUCCESS);
+    EXPECT_TRUE(unit & BNO055_EULER_UNIT_MSK);
+}
+
+TEST(SimI2CBusTest, ServesReplayFrameAtSimulatedTime) {
+    SimulatedI2CBus bus;
+    bus.set_replay(two_frame_replay());
+    bus.add_bno055(0, IMU_ADDR, 0);
+    bus.add_bno055(1, IMU_ADDR, 1);
+    rpi_tca9548a tca;
+    ASSERT_EQ(tca.init(0x70, bus), 0);
+    tca.set_settle_time_us(0);
+
+    Bno055Device left(bus, IMU_ADDR, &tca, 0);
+    Bno055Device right(bus, IMU_ADDR, &tca, 1);
+    ASSERT_EQ(left.init(), BNO055_SUCCESS);
+    ASSERT_EQ(right.init(), BNO055_SUCCESS);
+
+    // Fusion output stays zero until the sensor leaves CONFIG mode
+    bno055_euler_t e;
+    ASSERT_EQ(left.read_euler_raw(&e), BNO055_SUCCESS);
+    EXPECT_EQ(e.r, 0);
+
+    enter_ndof(left);
+    enter_ndof(right);
+    ASSERT_EQ(left.read_euler_raw(&e), BNO055_SUCCESS);
+    EXPECT_EQ(e.h, 90 * 16);
+    EXPECT_EQ(e.r, 10 * 16);
+    EXPECT_EQ(e.p, -5 * 16);
+    ASSERT_EQ(right.read_euler_raw(&e), BNO055_SUCCESS);
+    EXPECT_EQ(e.r, 20 * 16);
+
+    bus.advance_ns(100000000);
+    ASSERT_EQ(left.read_euler_raw(&e), BNO055_SUCCESS);
+    EXPECT_EQ(e.r, 20 * 16);
+
+    // Replay loops after its last frame
+    bus.advance_ns(100000000);
+    ASSERT_EQ(left.read_euler_raw(&e), BNO055_SUCCESS);
+    EXPECT_EQ(e.r, 10 * 16);
+}
+
+TEST(SimI2CBusTest, TransactionsCostModelledBusTime) {
+    SimBusTiming timing = SimBusTiming::at_clock(100000, 60000);
+    EXPECT_EQ(timing.byte_ns, 90000);
+
+    SimulatedI2CBus bus(timing);
+    bus.add_bno055(-1, IMU_ADDR, 0);
+
+    u8 data[BNO055_EULER_HRP_DATA_SIZE];
+    ASSERT_EQ(bus.read(IMU_ADDR, BNO055_EULER_H_LSB_ADDR, data, sizeof(data)), BNO055_SUCCESS);
+
+    // Address + register + address + 6 data bytes
+    SimulatedI2CBus::Stats stats = bus.stats();
+    EXPECT_EQ(stats.bytes, 9u);
+    EXPECT_EQ(stats.busy_ns, 60000 + 9 * 90000);
+    EXPECT_EQ(bus.now_ns(), stats.busy_ns);
+}
+
+TEST(SimI2CBusTest, ReconnectedSensorComesBackInConfigMode) {
+    SimulatedI2CBus bus;
+    bus.add_bno055(-1, IMU_ADDR, 0);
+    Bno055Device imu(bus, IMU_ADDR);
+    ASSERT_EQ(imu.init(), BNO055_SUCCESS);
+    enter_ndof(imu);
+
+    bus.set_present(-1, IMU_ADDR, false);
+    u8 mode = 0;
+    EXPECT_EQ(imu.get_operation_mode(&mode), BNO055_ERROR);
+
+    bus.set_present(-1, IMU_ADDR, true);
+    ASSERT_EQ(imu.get_operation_mode(&mode), BNO055_SUCCESS);
+    EXPECT_EQ(mode, BNO055_OPERATION_MODE_CONFIG);
+}
+
+TEST(SimI2CBusTest, SyntheticReplayLoopsAtItsPeriod) {
+    ImuReplay replay = make_synthetic_replay(6, 100, 10000000);
+    EXPECT_EQ(replay.frames(), 100u);
+    EXPECT_EQ(replay.duration_ns(), 1000000000);
+    EXPECT_EQ(replay.frame_at(25000000), 2u);
+    EXPECT_EQ(replay.frame_at(1025000000), 2u);
+}
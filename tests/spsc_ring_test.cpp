@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include "spsc_ring.h"
+
+TEST(SpscRingTest, PushPopInOrder) {
+    SpscRing<int, 4> ring;
+    int value = 0;
+
+    EXPECT_FALSE(ring.pop(value));
+    EXPECT_TRUE(ring.push(1));
+    EXPECT_TRUE(ring.push(2));
+    EXPECT_EQ(ring.size(), 2u);
+
+    ASSERT_TRUE(ring.pop(value));
+    EXPECT_EQ(value, 1);
+    ASSERT_TRUE(ring.pop(value));
+    EXPECT_EQ(value, 2);
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(SpscRingTest, RejectsPushWhenFull) {
+    SpscRing<int, 4> ring;
+    for (int i = 0; i < 4; ++i) EXPECT_TRUE(ring.push(i));
+    EXPECT_FALSE(ring.push(99));
+
+    int value = 0;
+    ASSERT_TRUE(ring.pop(value));
+    EXPECT_EQ(value, 0);
+    EXPECT_TRUE(ring.push(4));
+}
+
+TEST(SpscRingTest, WrapsAround) {
+    SpscRing<int, 4> ring;
+    int value = 0;
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_TRUE(ring.push(i));
+        ASSERT_TRUE(ring.pop(value));
+        EXPECT_EQ(value, i);
+    }
+}
+
+TEST(SpscRingTest, ProducerConsumerThreadsKeepOrder) {
+    SpscRing<uint64_t, 64> ring;
+    const uint64_t count = 100000;
+
+    std::thread producer([&]() {
+        for (uint64_t i = 0; i < count; ++i) {
+            while (!ring.push(i)) std::this_thread::yield();
+        }
+    });
+
+    uint64_t expected = 0;
+    uint64_t value = 0;
+    while (expected < count) {
+        if (ring.pop(value)) {
+            ASSERT_EQ(value, expected);
+            ++expected;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    EXPECT_TRUE(ring.empty());
+}
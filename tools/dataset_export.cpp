@@ -0,0 +1,87 @@
+// Exports a recording as training windows for the gait model, in NumPy's
+// .npy format:
+//   ./dataset_export MAY_10_FULL_SUIT_WORKING/control/joint_data.json /tmp/joint_data 30
+// writes /tmp/joint_data_inputs.npy, float32 [windows][30][6] roll in
+// degrees, and /tmp/joint_data_targets.npy, float32 [windows][6], the frame
+// after each window. Windows start every frame (optional fourth argument:
+// the step). The recording can be JSON lines or .exolog, channels in
+// IMU_LOCATIONS order; the model's normalization is left to training.
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "frame_types.h"
+#include "sensor_dataset.h"
+
+
+// .npy version 1.0 header for a C-order float32 array
+static std::string npy_header(const std::vector<size_t>& shape) {
+    std::string dims;
+    for (size_t d : shape) dims += std::to_string(d) + ", ";
+    if (shape.size() > 1) dims.resize(dims.size() - 1);
+    std::string dict = "{'descr': '<f4', 'fortran_order': False, 'shape': (" + dims + "), }";
+
+    size_t total = 10 + dict.size() + 1;
+    dict.append((64 - total % 64) % 64, ' ');
+    dict += '\n';
+    std::string header("\x93NUMPY\x01\x00", 8);
+    header += static_cast<char>(dict.size() & 0xff);
+    header += static_cast<char>(dict.size() >> 8);
+    return header + dict;
+}
+
+static std::FILE* open_npy(const std::string& path, const std::vector<size_t>& shape) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        std::perror(path.c_str());
+        return nullptr;
+    }
+    std::string header = npy_header(shape);
+    std::fwrite(header.data(), 1, header.size(), file);
+    return file;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "usage: " << argv[0] << " <recording.json|.exolog> <out prefix> [window] [step]" << std::endl;
+        return 1;
+    }
+    std::string prefix = argv[2];
+    size_t window = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 30;
+    size_t step   = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : 1;
+
+    SensorDataset dataset;
+    if (dataset.load(argv[1], IMU_LOCATIONS) != 0) {
+        std::cerr << "Cannot load " << argv[1] << std::endl;
+        return 1;
+    }
+    // Every window needs the frame after it as its target
+    size_t count = dataset.frames() > window ? dataset.windows(window + 1, step) : 0;
+    if (window == 0 || count == 0) {
+        std::cerr << argv[1] << ": " << dataset.frames() << " frames, too short for a window of " << window << std::endl;
+        return 1;
+    }
+    size_t channels = dataset.channels();
+
+    std::FILE* inputs = open_npy(prefix + "_inputs.npy", {count, window, channels});
+    std::FILE* targets = open_npy(prefix + "_targets.npy", {count, channels});
+    if (inputs == nullptr || targets == nullptr) return 1;
+
+    std::vector<float> buffer((window + 1) * channels);
+    for (size_t i = 0; i < count; i++) {
+        dataset.window(i * step, window + 1).copy_to(buffer.data());
+        std::fwrite(buffer.data(), sizeof(float), window * channels, inputs);
+        std::fwrite(buffer.data() + window * channels, sizeof(float), channels, targets);
+    }
+    bool ok = std::fclose(inputs) == 0;
+    ok = std::fclose(targets) == 0 && ok;
+    if (!ok) {
+        std::cerr << "Write to " << prefix << "_*.npy failed" << std::endl;
+        return 1;
+    }
+    std::cout << dataset.frames() << " frames -> " << count << " windows of " << window << " x " << channels
+              << std::endl;
+    return 0;
+}
@@ -0,0 +1,70 @@
+// Converts IMU recordings between JSON lines (imu_data.json, the treadmill
+// recordings) and .exolog, the direction picked by the extensions:
+//   ./exolog_convert MAY_10_FULL_SUIT_WORKING/control/joint_data.json /tmp/joint_data.exolog
+//   ./exolog_convert imu_data_20260101_120000.exolog /tmp/imu_data.json
+// From .exolog to .exolog compresses a plain file and decompresses a
+// compressed one (see exolog_codec.h):
+//   ./exolog_convert /tmp/joint_data.exolog /tmp/joint_data.z.exolog
+//
+// JSON recordings are mapped to channels in IMU_LOCATIONS order; the
+// optional third argument is the frame period in ms for lines without a
+// timestamp (default 100).
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include "exolog.h"
+#include "exolog_codec.h"
+#include "frame_types.h"
+
+using namespace std::chrono;
+
+
+static bool ends_with(const std::string& text, const std::string& suffix) {
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+static long file_size(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 ? static_cast<long>(st.st_size) : -1;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "usage: " << argv[0] << " <in.json|in.exolog> <out> [period ms]" << std::endl;
+        return 1;
+    }
+    std::string in = argv[1];
+    std::string out = argv[2];
+    int64_t period_ns = (argc > 3 ? std::atoll(argv[3]) : 100) * 1000000LL;
+
+    auto start = steady_clock::now();
+    long frames = -1;
+    ExologSchema schema;
+    size_t header_size = 0;
+    if (!ends_with(in, ".exolog")) {
+        frames = jsonl_to_exolog(in, out, IMU_LOCATIONS, period_ns);
+    } else if (read_exolog_header(in, schema, &header_size) != 0) {
+        std::cerr << in << " is not an .exolog file" << std::endl;
+    } else if (!schema.compression.empty()) {
+        // Compressed logs go through a plain one on their way to JSON
+        std::string plain = ends_with(out, ".exolog") ? out : out + ".plain.exolog";
+        frames = exolog_decompress(in, plain);
+        if (frames >= 0 && plain != out) {
+            frames = exolog_to_jsonl(plain, out);
+            std::remove(plain.c_str());
+        }
+    } else {
+        frames = ends_with(out, ".exolog") ? exolog_compress(in, out) : exolog_to_jsonl(in, out);
+    }
+    double ms = duration<double, std::milli>(steady_clock::now() - start).count();
+    if (frames < 0) return 1;
+
+    std::cout << frames << " frames, " << file_size(in) << " -> " << file_size(out) << " bytes in "
+              << ms << " ms" << std::endl;
+    return 0;
+}
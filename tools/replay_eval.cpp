@@ -0,0 +1,82 @@
+// Runs the gait model over a whole recording, the way the controller would
+// have seen it, and compares every prediction with the frame that followed:
+//   ./replay_eval model.pt filtered_imu_data_treadmill_5min_1.9mph.json data.txt
+//
+// The recording can be JSON lines or .exolog (channels in IMU_LOCATIONS
+// order). Its roll goes through the controller's StreamingPreprocessor
+// (unwrap, rolling-mean normalization) before windowing, so predictions and
+// the frames they are compared with are in the model's input space. The
+// output file gets one "actual predicted" line per joint and prediction, as
+// MAY_10's normalized.cpp wrote; the RMSE per joint and the mean inference
+// time are printed at the end.
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../models/model.h"
+#include "../sensors/frame_types.h"
+#include "../sensors/sensor_dataset.h"
+#include "../sensors/sensor_preprocessing.h"
+
+using namespace std::chrono;
+
+static constexpr size_t WINDOW = 30;
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "usage: " << argv[0] << " <model.pt> <recording.json|.exolog> [output]" << std::endl;
+        return 1;
+    }
+
+    torch::jit::script::Module model;
+    try {
+        model = torch::jit::load(argv[1]);
+        model.eval();
+    } catch (const c10::Error& e) {
+        std::cerr << "Error loading the model: " << e.what() << std::endl;
+        return 1;
+    }
+
+    SensorDataset dataset;
+    if (dataset.load(argv[2], IMU_LOCATIONS) != 0 || dataset.frames() <= WINDOW) {
+        std::cerr << "Cannot load a recording longer than " << WINDOW << " frames from " << argv[2] << std::endl;
+        return 1;
+    }
+    std::ofstream output;
+    if (argc > 3) output.open(argv[3]);
+
+    // Frame major, as the controller pushes it, processed in place
+    const size_t channels = dataset.channels();
+    std::vector<float> processed(dataset.frames() * channels);
+    dataset.window(0, dataset.frames()).copy_to(processed.data());
+    StreamingPreprocessor preprocessor(channels);
+    preprocessor.push(processed.data(), processed.data(), dataset.frames());
+
+    torch::NoGradGuard no_grad;
+    size_t predictions = dataset.windows(WINDOW + 1);
+    std::vector<double> squared_error(IMU_LOCATIONS.size(), 0.0);
+    double inference_ms = 0.0;
+
+    for (size_t start = 0; start < predictions; start++) {
+        auto begin = steady_clock::now();
+        JointAngles predicted = predict_joint_angles(model, &processed[start * channels]);
+        inference_ms += duration<double, std::milli>(steady_clock::now() - begin).count();
+
+        const float* next = &processed[(start + WINDOW) * channels];
+        for (size_t j = 0; j < predicted.size(); j++) {
+            double error = predicted.values[j] - next[j];
+            squared_error[j] += error * error;
+            if (output.is_open()) output << next[j] << " " << predicted.values[j] << "\n";
+        }
+    }
+
+    std::cout << predictions << " predictions, " << inference_ms / predictions << " ms mean inference" << std::endl;
+    for (size_t j = 0; j < IMU_LOCATIONS.size(); j++) {
+        std::cout << "  " << IMU_LOCATIONS[j] << ": RMSE " << std::sqrt(squared_error[j] / predictions) << " deg"
+                  << std::endl;
+    }
+    return 0;
+}